@@ -162,6 +162,7 @@ if ! $skip_gnulib; then
       localename
       lock
       memmove
+      memory-ostream
       memset
       minmax
       obstack
@@ -169,6 +170,7 @@ if ! $skip_gnulib; then
       opendir
       openmp
       ostream
+      pipe-filter-gi
       pipe-filter-ii
       progname
       propername
@@ -290,6 +292,7 @@ if ! $skip_gnulib; then
       hash
       iconv
       libunistring-optional
+      memory-ostream
       minmax
       open
       ostream
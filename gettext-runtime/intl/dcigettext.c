@@ -67,6 +67,17 @@ extern int errno;
 
 #include <locale.h>
 
+/* Whether to support the lookup profile, see below.  */
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+# define PROFILE_LOOKUPS 1
+# ifdef HAVE_CLOCK_GETTIME
+#  include <time.h>
+# endif
+# ifdef HAVE_GETTIMEOFDAY
+#  include <sys/time.h>
+# endif
+#endif
+
 #ifdef _LIBC
   /* Guess whether integer division by zero raises signal SIGFPE.
      Set to 1 only if you know for sure.  In case of doubt, set to 0.  */
@@ -455,18 +466,378 @@ gl_rwlock_define_initialized (, _nl_state_lock attribute_hidden)
 # ifndef HAVE_GETEGID
 #  define getegid() getgid()
 # endif
-static int enable_secure;
-# define ENABLE_SECURE (enable_secure == 1)
+int _nl_enable_secure;
+# define ENABLE_SECURE (_nl_enable_secure == 1)
 # define DETERMINE_SECURE \
-  if (enable_secure == 0)						      \
+  if (_nl_enable_secure == 0)						      \
     {									      \
       if (getuid () != geteuid () || getgid () != getegid ())		      \
-	enable_secure = 1;						      \
+	_nl_enable_secure = 1;						      \
       else								      \
-	enable_secure = -1;						      \
+	_nl_enable_secure = -1;						      \
     }
 #endif
 
+#ifdef PROFILE_LOOKUPS
+/* When the environment variable GETTEXT_PROFILE names a file, we count the
+   lookups of each msgid, the hits and misses in the table of known
+   translations and the time spent in _nl_find_msg and in charset
+   conversions, and append a summary to that file when the program exits.
+   The counts are kept in a table per thread, so that the threads don't
+   contend for a lock; only the final summary looks at all tables.  */
+
+struct profile_table
+{
+  /* Next table in the list of all tables.  */
+  struct profile_table *next;
+  /* Lock taken by the thread that owns this table while updating it, and
+     by the final summary.  */
+  gl_lock_define (, lock)
+  /* Open hash table of msgids, with a size that is a power of 2.  */
+  struct lookup_profile_entry *entries;
+  size_t size;
+  size_t filled;
+  /* The interned name of the last looked up domain.  */
+  const char *last_domainname;
+  /* Counters.  */
+  unsigned long int lookups;
+  unsigned long int cache_hits;
+  unsigned long int cache_misses;
+  unsigned long int find_calls;
+  double find_nsec;
+  unsigned long int conversions;
+  double conversion_nsec;
+};
+
+/* An interned domain name.  */
+struct profile_domain
+{
+  struct profile_domain *next;
+  char name[ZERO];
+};
+
+/* 1 if the lookup profile is enabled, -1 if not, 0 if not yet
+   determined.  */
+static int profile_state;
+static char *profile_filename;
+/* The list of all tables and the list of interned domain names.  */
+static struct profile_table *profile_tables;
+static struct profile_domain *profile_domains;
+gl_lock_define_initialized (static, profile_lock)
+
+/* The table of the current thread.  Without thread-local variables, all
+   threads share a single table.  */
+# ifdef HAVE_THREAD_LOCAL
+static __thread struct profile_table *profile_current;
+# else
+static struct profile_table *profile_current;
+# endif
+
+static void profile_dump (void);
+
+/* Return nonzero if the lookup profile is enabled.  */
+static int
+profile_enabled (void)
+{
+  if (profile_state == 0)
+    {
+      const char *filename;
+
+      DETERMINE_SECURE;
+      filename = (ENABLE_SECURE ? NULL : getenv ("GETTEXT_PROFILE"));
+
+      gl_lock_lock (profile_lock);
+      if (profile_state == 0)
+	{
+	  if (filename != NULL && filename[0] != '\0'
+	      && (profile_filename = strdup (filename)) != NULL
+	      && atexit (profile_dump) == 0)
+	    profile_state = 1;
+	  else
+	    profile_state = -1;
+	}
+      gl_lock_unlock (profile_lock);
+    }
+  return profile_state > 0;
+}
+
+/* Return the table of the current thread, or NULL if out of memory.  */
+static struct profile_table *
+profile_get_table (void)
+{
+  struct profile_table *table = profile_current;
+
+  if (__builtin_expect (table == NULL, 0))
+    {
+      gl_lock_lock (profile_lock);
+      table = profile_current;
+      if (table == NULL)
+	{
+	  table =
+	    (struct profile_table *) calloc (1, sizeof (struct profile_table));
+	  if (table != NULL)
+	    {
+	      gl_lock_init (table->lock);
+	      table->next = profile_tables;
+	      profile_tables = table;
+	      profile_current = table;
+	    }
+	}
+      gl_lock_unlock (profile_lock);
+    }
+  return table;
+}
+
+/* Return the current time in nanoseconds.  */
+static double
+profile_now (void)
+{
+# if defined HAVE_CLOCK_GETTIME && defined CLOCK_MONOTONIC
+  struct timespec ts;
+
+  if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+# endif
+# ifdef HAVE_GETTIMEOFDAY
+  {
+    struct timeval tv;
+
+    gettimeofday (&tv, NULL);
+    return tv.tv_sec * 1e9 + tv.tv_usec * 1e3;
+  }
+# else
+  return 0;
+# endif
+}
+
+/* Return the interned copy of DOMAINNAME, or NULL if out of memory.  */
+static const char *
+profile_intern_domain (struct profile_table *table, const char *domainname)
+{
+  struct profile_domain *dom;
+
+  if (table->last_domainname != NULL
+      && strcmp (table->last_domainname, domainname) == 0)
+    return table->last_domainname;
+
+  gl_lock_lock (profile_lock);
+  for (dom = profile_domains; dom != NULL; dom = dom->next)
+    if (strcmp (dom->name, domainname) == 0)
+      break;
+  if (dom == NULL)
+    {
+      size_t len = strlen (domainname) + 1;
+
+      dom = (struct profile_domain *)
+	    malloc (offsetof (struct profile_domain, name) + len);
+      if (dom != NULL)
+	{
+	  memcpy (dom->name, domainname, len);
+	  dom->next = profile_domains;
+	  profile_domains = dom;
+	}
+    }
+  gl_lock_unlock (profile_lock);
+
+  if (dom == NULL)
+    return NULL;
+  table->last_domainname = dom->name;
+  return dom->name;
+}
+
+/* Double the size of the hash table of TABLE.  Return 0 if out of
+   memory.  */
+static int
+profile_grow (struct profile_table *table)
+{
+  size_t new_size = (table->size > 0 ? 2 * table->size : 256);
+  struct lookup_profile_entry *new_entries =
+    (struct lookup_profile_entry *)
+    calloc (new_size, sizeof (struct lookup_profile_entry));
+  size_t i;
+
+  if (new_entries == NULL)
+    return 0;
+  for (i = 0; i < table->size; i++)
+    if (table->entries[i].msgid != NULL)
+      {
+	size_t idx = table->entries[i].hash & (new_size - 1);
+
+	while (new_entries[idx].msgid != NULL)
+	  idx = (idx + 1) & (new_size - 1);
+	new_entries[idx] = table->entries[i];
+      }
+  free (table->entries);
+  table->entries = new_entries;
+  table->size = new_size;
+  return 1;
+}
+
+/* Count a lookup of MSGID1, with plural MSGID2 or NULL, in DOMAINNAME.
+   CACHED tells whether it was found in the table of known translations.  */
+static void
+profile_count_lookup (struct profile_table *table, const char *domainname,
+		      const char *msgid1, const char *msgid2, int cached)
+{
+  unsigned long int hash = __hash_string (msgid1);
+  size_t idx;
+
+  domainname = profile_intern_domain (table, domainname);
+
+  gl_lock_lock (table->lock);
+  table->lookups++;
+  if (cached)
+    table->cache_hits++;
+  else
+    table->cache_misses++;
+  if (domainname == NULL
+      || (4 * (table->filled + 1) > 3 * table->size && !profile_grow (table)))
+    goto done;
+
+  idx = hash & (table->size - 1);
+  for (;;)
+    {
+      struct lookup_profile_entry *entry = &table->entries[idx];
+
+      if (entry->msgid == NULL)
+	{
+	  entry->msgid = strdup (msgid1);
+	  if (entry->msgid == NULL)
+	    goto done;
+	  entry->msgid_plural = (msgid2 != NULL ? strdup (msgid2) : NULL);
+	  entry->domainname = domainname;
+	  entry->hash = hash;
+	  entry->count = 1;
+	  table->filled++;
+	  break;
+	}
+      if (entry->hash == hash && entry->domainname == domainname
+	  && strcmp (entry->msgid, msgid1) == 0)
+	{
+	  entry->count++;
+	  break;
+	}
+      idx = (idx + 1) & (table->size - 1);
+    }
+ done:
+  gl_lock_unlock (table->lock);
+}
+
+/* Account for a call to _nl_find_msg (WHAT = 0) or a charset conversion
+   (WHAT = 1) that started at time START.  */
+static void
+profile_add_time (struct profile_table *table, int what, double start)
+{
+  double elapsed = profile_now () - start;
+
+  gl_lock_lock (table->lock);
+  if (what == 0)
+    {
+      table->find_calls++;
+      table->find_nsec += elapsed;
+    }
+  else
+    {
+      table->conversions++;
+      table->conversion_nsec += elapsed;
+    }
+  gl_lock_unlock (table->lock);
+}
+
+/* Order lookup profile entries by domain and msgid.  */
+static int
+profile_entry_cmp (const void *p1, const void *p2)
+{
+  const struct lookup_profile_entry *e1 =
+    *(const struct lookup_profile_entry * const *) p1;
+  const struct lookup_profile_entry *e2 =
+    *(const struct lookup_profile_entry * const *) p2;
+  int result = strcmp (e1->domainname, e2->domainname);
+
+  if (result == 0)
+    result = strcmp (e1->msgid, e2->msgid);
+  return result;
+}
+
+/* Order lookup profile entries by decreasing count.  */
+static int
+profile_count_cmp (const void *p1, const void *p2)
+{
+  const struct lookup_profile_entry *e1 =
+    *(const struct lookup_profile_entry * const *) p1;
+  const struct lookup_profile_entry *e2 =
+    *(const struct lookup_profile_entry * const *) p2;
+
+  if (e1->count != e2->count)
+    return (e1->count < e2->count ? 1 : -1);
+  return profile_entry_cmp (p1, p2);
+}
+
+/* Write the lookup profile.  Registered with atexit.  */
+static void
+profile_dump (void)
+{
+  struct lookup_profile_totals totals;
+  struct lookup_profile_entry **entries;
+  struct profile_table *table;
+  size_t nentries;
+  size_t i, j;
+
+  memset (&totals, 0, sizeof (totals));
+
+  /* Other threads may still be running.  Keep them from modifying their
+     tables until we are done.  */
+  gl_lock_lock (profile_lock);
+  nentries = 0;
+  for (table = profile_tables; table != NULL; table = table->next)
+    {
+      gl_lock_lock (table->lock);
+      totals.threads++;
+      totals.lookups += table->lookups;
+      totals.cache_hits += table->cache_hits;
+      totals.cache_misses += table->cache_misses;
+      totals.find_calls += table->find_calls;
+      totals.find_nsec += table->find_nsec;
+      totals.conversions += table->conversions;
+      totals.conversion_nsec += table->conversion_nsec;
+      nentries += table->filled;
+    }
+
+  /* Merge the counts of the same msgid in different threads, then sort
+     by decreasing count.  */
+  entries = (struct lookup_profile_entry **)
+	    malloc ((nentries > 0 ? nentries : 1)
+		    * sizeof (struct lookup_profile_entry *));
+  if (entries != NULL)
+    {
+      nentries = 0;
+      for (table = profile_tables; table != NULL; table = table->next)
+	for (i = 0; i < table->size; i++)
+	  if (table->entries[i].msgid != NULL)
+	    entries[nentries++] = &table->entries[i];
+      qsort (entries, nentries, sizeof (struct lookup_profile_entry *),
+	     profile_entry_cmp);
+      for (i = 0, j = 0; i < nentries; i++)
+	if (j > 0 && profile_entry_cmp (&entries[j - 1], &entries[i]) == 0)
+	  entries[j - 1]->count += entries[i]->count;
+	else
+	  entries[j++] = entries[i];
+      nentries = j;
+      qsort (entries, nentries, sizeof (struct lookup_profile_entry *),
+	     profile_count_cmp);
+    }
+  else
+    nentries = 0;
+
+  _nl_log_profile (profile_filename, &totals, entries, nentries);
+  free (entries);
+
+  for (table = profile_tables; table != NULL; table = table->next)
+    gl_lock_unlock (table->lock);
+  gl_lock_unlock (profile_lock);
+}
+#endif
+
 /* Get the function to evaluate the plural expression.  */
 #include "eval-plural.h"
 
@@ -505,6 +876,9 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
   const char *localename;
 #endif
   size_t domainname_len;
+#ifdef PROFILE_LOOKUPS
+  struct profile_table *profile = NULL;
+#endif
 
   /* If no real MSGID is given return NULL.  */
   if (msgid1 == NULL)
@@ -541,6 +915,11 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
     category = LC_MESSAGES;
 #endif
 
+#ifdef PROFILE_LOOKUPS
+  if (__builtin_expect (profile_state != -1, 0) && profile_enabled ())
+    profile = profile_get_table ();
+#endif
+
   /* Try to find the translation among those which we found at
      some time.  */
   search.domain = NULL;
@@ -572,6 +951,13 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 
   gl_rwlock_unlock (tree_lock);
 
+# ifdef PROFILE_LOOKUPS
+  if (profile != NULL)
+    profile_count_lookup (profile, domainname, msgid1, plural ? msgid2 : NULL,
+			  foundp != NULL
+			  && (*foundp)->counter == _nl_msg_cat_cntr);
+# endif
+
   if (foundp != NULL && (*foundp)->counter == _nl_msg_cat_cntr)
     {
       /* Now deal with plural.  */
@@ -588,6 +974,11 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
       __set_errno (saved_errno);
       return retval;
     }
+#elif defined PROFILE_LOOKUPS
+  /* Without the table of known translations, every lookup is a miss.  */
+  if (profile != NULL)
+    profile_count_lookup (profile, domainname, msgid1, plural ? msgid2 : NULL,
+			  0);
 #endif
 
   /* See whether this is a SUID binary or not.  */
@@ -723,6 +1114,10 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 
       if (domain != NULL)
 	{
+#ifdef PROFILE_LOOKUPS
+	  double start = (profile != NULL ? profile_now () : 0);
+#endif
+
 #if defined IN_LIBGLOCALE
 	  retval = _nl_find_msg (domain, binding, encoding, msgid1, &retlen);
 #else
@@ -751,6 +1146,11 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 		}
 	    }
 
+#ifdef PROFILE_LOOKUPS
+	  if (profile != NULL)
+	    profile_add_time (profile, 0, start);
+#endif
+
 	  /* Returning -1 means that some resource problem exists
 	     (likely memory) and that the strings could not be
 	     converted.  Return the original strings.  */
@@ -1252,10 +1652,19 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 # ifndef _LIBC
 	      transmem_block_t *transmem_list;
 # endif
+# ifdef PROFILE_LOOKUPS
+	      struct profile_table *profile;
+	      double start;
+# endif
 
 	      __libc_lock_lock (lock);
 	    not_translated_yet:
 
+# ifdef PROFILE_LOOKUPS
+	      profile = (profile_state > 0 ? profile_get_table () : NULL);
+	      start = (profile != NULL ? profile_now () : 0);
+# endif
+
 	      inbuf = (const unsigned char *) result;
 	      outbuf = freemem + sizeof (size_t);
 # ifndef _LIBC
@@ -1379,6 +1788,11 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 	      freemem_size = freemem_size & ~ (alignof (size_t) - 1);
 
 	      __libc_lock_unlock (lock);
+
+# ifdef PROFILE_LOOKUPS
+	      if (profile != NULL)
+		profile_add_time (profile, 1, start);
+# endif
 	    }
 
 	  /* Now convd->conv_tab[act] contains the translation of all
@@ -1407,7 +1821,7 @@ plural_lookup (struct loaded_l10nfile *domain, unsigned long int n,
   unsigned long int index;
   const char *p;
 
-  index = plural_eval (domaindata->plural, n);
+  index = plural_eval_program (&domaindata->plural_program, n);
   if (index >= domaindata->nplurals)
     /* This should never happen.  It means the plural expression and the
        given maximum value do not match.  */
@@ -14,6 +14,10 @@
    You should have received a copy of the GNU Lesser General Public License
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
+#if !INTDIV0_RAISES_SIGFPE
+# include <signal.h>
+#endif
+
 #ifndef STATIC
 #define STATIC static
 #endif
@@ -104,3 +108,117 @@ plural_eval (const struct expression *pexp, unsigned long int n)
   /* NOTREACHED */
   return 0;
 }
+
+#if !INTDIV0_RAISES_SIGFPE
+# define PLURAL_CHECK_DIVISOR(d) (void) ((d) == 0 ? raise (SIGFPE) : 0)
+#else
+# define PLURAL_CHECK_DIVISOR(d) (void) 0
+#endif
+
+/* A binary operator of a compiled plural expression.  The right operand
+   is either immediate or on the stack; the result replaces the left
+   operand.  */
+#define PLURAL_BINOP(opcode, expr) \
+	      case opcode:						\
+		{							\
+		  unsigned long int leftarg;				\
+		  unsigned long int rightarg;				\
+									\
+		  rightarg = (ip->immediate ? ip->val : *--sp);		\
+		  leftarg = sp[-1];					\
+		  sp[-1] = (expr);					\
+		}							\
+		break;
+
+/* Evaluate the compiled plural expression and return an index value.  */
+STATIC
+unsigned long int
+internal_function
+plural_eval_program (const struct plural_program *prog, unsigned long int n)
+{
+  switch (prog->kind)
+    {
+    case plural_prog_constant:
+      return prog->val;
+    case plural_prog_compare:
+      switch (prog->operation)
+	{
+	case less_than:
+	  return n < prog->val;
+	case greater_than:
+	  return n > prog->val;
+	case less_or_equal:
+	  return n <= prog->val;
+	case greater_or_equal:
+	  return n >= prog->val;
+	case equal:
+	  return n == prog->val;
+	case not_equal:
+	  return n != prog->val;
+	default:
+	  break;
+	}
+      break;
+    case plural_prog_code:
+      {
+	unsigned long int stack[PLURAL_STACK_MAX];
+	unsigned long int *sp = stack;
+	const struct plural_insn *code = prog->code;
+	const struct plural_insn *ip = code;
+
+	for (;;)
+	  {
+	    switch (ip->opcode)
+	      {
+	      case plop_var:
+		*sp++ = n;
+		break;
+	      case plop_num:
+		*sp++ = ip->val;
+		break;
+	      case plop_lnot:
+		sp[-1] = ! sp[-1];
+		break;
+	      case plop_bool:
+		sp[-1] = (sp[-1] != 0);
+		break;
+	      case plop_jz:
+		if (*--sp == 0)
+		  {
+		    ip = code + ip->val;
+		    continue;
+		  }
+		break;
+	      case plop_jmp:
+		ip = code + ip->val;
+		continue;
+	      case plop_ret:
+		return sp[-1];
+	      PLURAL_BINOP (plop_mult, leftarg * rightarg)
+	      PLURAL_BINOP (plop_divide, (PLURAL_CHECK_DIVISOR (rightarg),
+					  leftarg / rightarg))
+	      PLURAL_BINOP (plop_module, (PLURAL_CHECK_DIVISOR (rightarg),
+					  leftarg % rightarg))
+	      PLURAL_BINOP (plop_plus, leftarg + rightarg)
+	      PLURAL_BINOP (plop_minus, leftarg - rightarg)
+	      PLURAL_BINOP (plop_less_than, leftarg < rightarg)
+	      PLURAL_BINOP (plop_greater_than, leftarg > rightarg)
+	      PLURAL_BINOP (plop_less_or_equal, leftarg <= rightarg)
+	      PLURAL_BINOP (plop_greater_or_equal, leftarg >= rightarg)
+	      PLURAL_BINOP (plop_equal, leftarg == rightarg)
+	      PLURAL_BINOP (plop_not_equal, leftarg != rightarg)
+	      default:
+		/* NOTREACHED */
+		return 0;
+	      }
+	    ip++;
+	  }
+      }
+    default:
+      break;
+    }
+  return plural_eval (prog->tree, n);
+}
+
+#undef PLURAL_BINOP
+#undef PLURAL_CHECK_DIVISOR
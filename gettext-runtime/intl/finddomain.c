@@ -19,10 +19,15 @@
 # include <config.h>
 #endif
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #if defined HAVE_UNISTD_H || defined _LIBC
 # include <unistd.h>
@@ -46,10 +51,332 @@
 # include "lock.h"
 #endif
 
+/* Some compilers, like SunOS4 cc, don't have offsetof in <stddef.h>.  */
+#ifndef offsetof
+# define offsetof(type,ident) ((size_t)&(((type*)0)->ident))
+#endif
+
+#ifdef _LIBC
+# include <not-cancel.h>
+# define open(name, flags)	open_not_cancel_2 (name, flags)
+# define close(fd)		close_not_cancel_no_status (fd)
+# define read(fd, buf, n)	read_not_cancel (fd, buf, n)
+#endif
+
+/* Pathname support.
+   ISSLASH(C)           tests whether C is a directory separator character.
+   IS_ABSOLUTE_PATH(P)  tests whether P is an absolute path.  If it is not,
+                        it may be concatenated to a directory pathname.
+ */
+#if defined _WIN32 || defined __WIN32__ || defined __CYGWIN__ || defined __EMX__ || defined __DJGPP__
+  /* Win32, Cygwin, OS/2, DOS */
+# define ISSLASH(C) ((C) == '/' || (C) == '\\')
+# define HAS_DEVICE(P) \
+    ((((P)[0] >= 'A' && (P)[0] <= 'Z') || ((P)[0] >= 'a' && (P)[0] <= 'z')) \
+     && (P)[1] == ':')
+# define IS_ABSOLUTE_PATH(P) (ISSLASH ((P)[0]) || HAS_DEVICE (P))
+#else
+  /* Unix */
+# define ISSLASH(C) ((C) == '/')
+# define IS_ABSOLUTE_PATH(P) ISSLASH ((P)[0])
+#endif
+
 /* @@ end of prolog @@ */
 /* List of already loaded domains.  */
 static struct loaded_l10nfile *_nl_loaded_domains;
 
+/* Name of the optional index file in a directory passed to bindtextdomain.
+   It lists the message catalogs installed below that directory, one file
+   name per line, relative to the directory, for example
+   "de/LC_MESSAGES/hello.mo".  When it is present, catalogs that are not
+   listed are not looked up at all.  */
+#define CATALOG_INDEX_NAME "catalogs.list"
+
+/* What is known about a directory in which message catalogs are looked up.
+   This information is kept, so that when a program uses many text domains,
+   the catalogs for locale variants that are not installed (such as
+   "de_DE.UTF-8", "de_DE.utf8", "de_DE") are not probed again for each
+   domain.  The directories are identified by their absolute file name.
+   A directory that did not exist is looked up again when its parent
+   directory has been modified since, because the program may have created
+   it in the meantime.  */
+struct catalog_dir
+{
+  struct catalog_dir *next;
+  /* 1 if the directory exists, 0 if not.  */
+  int exists;
+  /* If the directory does not exist: the modification time of its parent
+     directory, or (time_t) -1 if the parent directory does not exist
+     either.  */
+  time_t parent_mtime;
+  /* The time at which the directory was looked up.  */
+  time_t checked;
+  /* The contents of the index file, with each line NUL terminated, or NULL
+     if there is no index file.  */
+  char *index;
+  size_t index_size;
+  char name[ZERO];
+};
+
+/* Directories passed to bindtextdomain, and their index files.  */
+static struct catalog_dir *catalog_base_dirs;
+/* Locale directories, such as "/usr/share/locale/de_DE".  */
+static struct catalog_dir *catalog_locale_dirs;
+
+gl_rwlock_define_initialized (static, catalog_dirs_lock)
+
+
+/* Read the index file of the directory DIR, if present.  */
+static void
+read_catalog_index (struct catalog_dir *dir)
+{
+  size_t dirlen = strlen (dir->name);
+  char *index_filename;
+  int fd;
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+  size_t size;
+  char *contents;
+  char *read_ptr;
+  size_t to_read;
+  size_t i;
+
+  index_filename =
+    (char *) malloc (dirlen + 1 + sizeof (CATALOG_INDEX_NAME));
+  if (index_filename == NULL)
+    return;
+  memcpy (index_filename, dir->name, dirlen);
+  index_filename[dirlen] = '/';
+  memcpy (index_filename + dirlen + 1, CATALOG_INDEX_NAME,
+	  sizeof (CATALOG_INDEX_NAME));
+  fd = open (index_filename, O_RDONLY);
+  free (index_filename);
+  if (fd == -1)
+    return;
+
+  if (
+#ifdef _LIBC
+      fstat64 (fd, &st) != 0
+#else
+      fstat (fd, &st) != 0
+#endif
+      || (size = (size_t) st.st_size) != st.st_size
+      || (contents = (char *) malloc (size + 1)) == NULL)
+    {
+      close (fd);
+      return;
+    }
+
+  to_read = size;
+  read_ptr = contents;
+  while (to_read > 0)
+    {
+      long int nb = (long int) read (fd, read_ptr, to_read);
+      if (nb <= 0)
+	{
+#ifdef EINTR
+	  if (nb == -1 && errno == EINTR)
+	    continue;
+#endif
+	  free (contents);
+	  close (fd);
+	  return;
+	}
+      read_ptr += nb;
+      to_read -= nb;
+    }
+  close (fd);
+
+  /* Turn the lines into NUL terminated strings.  */
+  for (i = 0; i < size; i++)
+    if (contents[i] == '\n' || contents[i] == '\r')
+      contents[i] = '\0';
+  contents[size] = '\0';
+
+  dir->index = contents;
+  dir->index_size = size + 1;
+}
+
+/* Return the modification time of the directory that contains the file
+   or directory NAME, or (time_t) -1 if it does not exist.  */
+static time_t
+get_parent_mtime (const char *name)
+{
+  const char *last_slash = strrchr (name, '/');
+  size_t parent_len;
+  char *parent;
+  time_t result;
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+
+  if (last_slash == NULL)
+    return (time_t) -1;
+  parent_len = (last_slash > name ? last_slash - name : 1);
+  parent = (char *) malloc (parent_len + 1);
+  if (parent == NULL)
+    return (time_t) -1;
+  memcpy (parent, name, parent_len);
+  parent[parent_len] = '\0';
+#ifdef _LIBC
+  result = (stat64 (parent, &st) == 0 ? st.st_mtime : (time_t) -1);
+#else
+  result = (stat (parent, &st) == 0 ? st.st_mtime : (time_t) -1);
+#endif
+  free (parent);
+  return result;
+}
+
+/* Determine whether the directory DIR exists.  If WITH_INDEX is nonzero,
+   look for an index file in it.  */
+static void
+check_catalog_dir (struct catalog_dir *dir, int with_index)
+{
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+
+  dir->checked = time (NULL);
+  if (with_index)
+    read_catalog_index (dir);
+  if (dir->index != NULL)
+    dir->exists = 1;
+  else
+#ifdef _LIBC
+    dir->exists = (stat64 (dir->name, &st) == 0);
+#else
+    dir->exists = (stat (dir->name, &st) == 0);
+#endif
+  if (!dir->exists)
+    dir->parent_mtime = get_parent_mtime (dir->name);
+}
+
+/* Return nonzero if the directory DIR, which did not exist, may have been
+   created since.  */
+static int
+catalog_dir_may_have_appeared (const struct catalog_dir *dir)
+{
+  /* Creating DIR modifies its parent directory.  If the parent directory
+     was modified in the same second in which DIR was looked up, its
+     modification time doesn't tell whether that happened before or after
+     the lookup.  */
+  return (get_parent_mtime (dir->name) != dir->parent_mtime
+	  || (dir->parent_mtime != (time_t) -1
+	      && dir->parent_mtime >= dir->checked));
+}
+
+/* Return the entry for the directory NAME of length NAMELEN in *LISTP,
+   creating it if necessary, and check again whether it exists if it did
+   not exist before.  If WITH_INDEX is nonzero, look for an index file in
+   the directory.  Return NULL if out of memory.
+   The caller must hold catalog_dirs_lock.  */
+static struct catalog_dir *
+get_catalog_dir (struct catalog_dir **listp, const char *name, size_t namelen,
+		 int with_index)
+{
+  struct catalog_dir *dir;
+
+  for (dir = *listp; dir != NULL; dir = dir->next)
+    if (strncmp (dir->name, name, namelen) == 0 && dir->name[namelen] == '\0')
+      {
+	if (!dir->exists && catalog_dir_may_have_appeared (dir))
+	  check_catalog_dir (dir, with_index);
+	return dir;
+      }
+
+  dir = (struct catalog_dir *)
+	malloc (offsetof (struct catalog_dir, name) + namelen + 1);
+  if (dir == NULL)
+    return NULL;
+  memcpy (dir->name, name, namelen);
+  dir->name[namelen] = '\0';
+  dir->index = NULL;
+  dir->index_size = 0;
+  check_catalog_dir (dir, with_index);
+
+  dir->next = *listp;
+  *listp = dir;
+  return dir;
+}
+
+/* Return 0 if the message catalog FILENAME, of the form
+   DIR/LOCALE/CATEGORY/DOMAIN.mo, is known not to exist, either because
+   the index file of DIR does not list it or because DIR or DIR/LOCALE does
+   not exist.  Return 1 if it may exist.  */
+int
+internal_function
+_nl_catalog_may_exist (const char *filename)
+{
+  const char *slashes[3];
+  const char *p;
+  struct catalog_dir *dir;
+  int result;
+
+  /* Find the last three slashes in FILENAME.  */
+  slashes[0] = slashes[1] = slashes[2] = NULL;
+  for (p = filename; *p != '\0'; p++)
+    if (*p == '/')
+      {
+	slashes[0] = slashes[1];
+	slashes[1] = slashes[2];
+	slashes[2] = p;
+      }
+  if (slashes[0] == NULL || slashes[0] == filename)
+    return 1;
+  /* The directories are remembered by name.  The name of a relative
+     directory would denote another directory after a chdir().  */
+  if (!IS_ABSOLUTE_PATH (filename))
+    return 1;
+
+  result = 1;
+
+  gl_rwlock_wrlock (catalog_dirs_lock);
+
+  dir = get_catalog_dir (&catalog_base_dirs, filename, slashes[0] - filename,
+			 1);
+  if (dir != NULL)
+    {
+      if (dir->index != NULL)
+	{
+	  const char *relname = slashes[0] + 1;
+	  const char *line;
+
+	  result = 0;
+	  for (line = dir->index;
+	       line < dir->index + dir->index_size;
+	       line += strlen (line) + 1)
+	    if (strcmp (line, relname) == 0)
+	      {
+		result = 1;
+		break;
+	      }
+	  goto done;
+	}
+      if (!dir->exists)
+	{
+	  result = 0;
+	  goto done;
+	}
+    }
+
+  dir = get_catalog_dir (&catalog_locale_dirs, filename,
+			 slashes[1] - filename, 0);
+  if (dir != NULL && !dir->exists)
+    result = 0;
+
+ done:
+  gl_rwlock_unlock (catalog_dirs_lock);
+
+  return result;
+}
+
 
 /* Return a data structure describing the message catalog described by
    the DOMAINNAME and CATEGORY parameters with respect to the currently
@@ -190,6 +517,19 @@ out:
 
 
 #ifdef _LIBC
+static void
+free_catalog_dirs (struct catalog_dir *dir)
+{
+  while (dir != NULL)
+    {
+      struct catalog_dir *here = dir;
+
+      dir = dir->next;
+      free (here->index);
+      free (here);
+    }
+}
+
 /* This is called from iconv/gconv_db.c's free_mem, as locales must
    be freed before freeing gconv steps arrays.  */
 void __libc_freeres_fn_section
@@ -206,5 +546,9 @@ _nl_finddomain_subfreeres ()
       free ((char *) here->filename);
       free (here);
     }
+  _nl_unload_bundles ();
+
+  free_catalog_dirs (catalog_base_dirs);
+  free_catalog_dirs (catalog_locale_dirs);
 }
 #endif
@@ -61,7 +61,39 @@ extern char *__bind_textdomain_codeset (const char *__domainname,
 extern void _nl_finddomain_subfreeres (void) attribute_hidden;
 extern void _nl_unload_domain (struct loaded_domain *__domain)
      internal_function attribute_hidden;
+extern void _nl_unload_bundles (void) internal_function attribute_hidden;
 #else
+/* 1 if the program runs setuid or setgid, -1 if not, 0 if not yet
+   determined.  */
+extern int _nl_enable_secure;
+extern void _nl_log_load (const char *logfilename, const char *filename,
+			  size_t size, const char *how,
+			  long int usec, long int minflt, long int majflt);
+/* The number of lookups of a msgid, for the lookup profile.  */
+struct lookup_profile_entry
+{
+  const char *domainname;
+  char *msgid;			/* including the msgctxt, if any */
+  char *msgid_plural;		/* or NULL */
+  unsigned long int hash;
+  unsigned long int count;
+};
+/* Totals of the lookup profile, over all threads.  */
+struct lookup_profile_totals
+{
+  unsigned long int threads;
+  unsigned long int lookups;
+  unsigned long int cache_hits;
+  unsigned long int cache_misses;
+  unsigned long int find_calls;
+  double find_nsec;
+  unsigned long int conversions;
+  double conversion_nsec;
+};
+extern void _nl_log_profile (const char *logfilename,
+			     const struct lookup_profile_totals *totals,
+			     struct lookup_profile_entry **entries,
+			     size_t nentries);
 /* Declare the exported libintl_* functions, in a way that allows us to
    call them under their real name.  */
 # undef _INTL_REDIRECT_INLINE
@@ -86,6 +118,8 @@ extern char *libintl_dcigettext (const char *__domainname,
 
 #include "gmo.h"		/* Get nls_uint32.  */
 
+#include "plural-exp.h"		/* Get struct plural_program.  */
+
 /* @@ end of prolog @@ */
 
 #ifndef internal_function
@@ -162,6 +196,8 @@ struct loaded_domain
   int use_mmap;
   /* Size of mmap()ed memory.  */
   size_t mmap_size;
+  /* 1 if the memory is part of a bundle and must not be freed.  */
+  int in_bundle;
   /* 1 if the .mo file uses a different endianness than this machine.  */
   int must_swap;
   /* Pointer to additional malloc()ed memory.  */
@@ -195,6 +231,8 @@ struct loaded_domain
 
   const struct expression *plural;
   unsigned long int nplurals;
+  /* PLURAL, compiled for fast evaluation.  */
+  struct plural_program plural_program;
 };
 
 /* We want to allocate a string at the end of the struct.  But ISO C
@@ -259,6 +297,8 @@ struct loaded_l10nfile *_nl_find_domain (const char *__dirname, char *__locale,
 void _nl_load_domain (struct loaded_l10nfile *__domain,
 		      struct binding *__domainbinding)
      internal_function;
+int _nl_catalog_may_exist (const char *__filename)
+     internal_function;
 
 #ifdef IN_LIBGLOCALE
 char *_nl_find_msg (struct loaded_l10nfile *domain_file,
@@ -100,6 +100,21 @@ struct mo_file_header
   nls_uint32 orig_sysdep_tab_offset;
   /* Offset of table with start offsets of translated sysdep strings.  */
   nls_uint32 trans_sysdep_tab_offset;
+
+  /* The following are only used in .mo files with minor revision >= 2.  */
+
+  /* The number of system dependent strings pairs that are also stored
+     expanded, for the segment values given below.  Their descriptors
+     follow the static strings' descriptors in the tables at orig_tab_offset
+     and trans_tab_offset.  */
+  nls_uint32 n_expanded_sysdep_strings;
+  /* Offset of table with the values of the system dependent segments for
+     which the expansion was made, as 'struct sysdep_segment'.  A length 0
+     denotes a segment without value.  */
+  nls_uint32 sysdep_values_offset;
+  /* Offset of hash table that includes the expanded system dependent
+     strings.  Its size is hash_tab_size.  */
+  nls_uint32 expanded_hash_tab_offset;
 };
 
 /* Descriptor for static string contained in the binary .mo file.  */
@@ -145,6 +160,43 @@ struct sysdep_string
    regardless whether 'int' is 16 bit, 32 bit, or 64 bit.  */
 #define SEGMENTS_END ((nls_uint32) ~0)
 
+
+/* The magic number of a bundle of GNU message catalogs, i.e. a file that
+   contains the .mo files of several text domains for the same locale.  */
+#define _MAGIC_BUNDLE 0x950412df
+#define _MAGIC_BUNDLE_SWAPPED 0xdf120495
+
+/* Revision number of the currently used bundle file format.  */
+#define MO_BUNDLE_REVISION_NUMBER 0
+
+/* Header for binary bundle file format.  */
+struct mo_bundle_header
+{
+  /* The magic number.  */
+  nls_uint32 magic;
+  /* The revision number of the file format.  */
+  nls_uint32 revision;
+  /* The number of message catalogs.  */
+  nls_uint32 nentries;
+  /* Offset of table of catalog descriptors, sorted by domain name.  */
+  nls_uint32 entries_offset;
+};
+
+/* Descriptor for a message catalog contained in a bundle.  The catalog
+   itself is a complete .mo file, whose offsets are relative to its own
+   start.  */
+struct mo_bundle_entry
+{
+  /* Length of the domain name, not including the trailing NUL.  */
+  nls_uint32 name_length;
+  /* Offset of the domain name in file.  */
+  nls_uint32 name_offset;
+  /* Size of the .mo file.  */
+  nls_uint32 length;
+  /* Offset of the .mo file in file.  A multiple of 8.  */
+  nls_uint32 offset;
+};
+
 /* @@ begin of epilog @@ */
 
 #endif	/* gettext.h  */
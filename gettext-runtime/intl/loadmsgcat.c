@@ -28,6 +28,7 @@
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stddef.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -75,6 +76,22 @@ char *alloca ();
 # undef HAVE_MMAP
 #endif
 
+#ifdef _LIBC
+# define madvise __madvise
+# define HAVE_MADVISE 1
+#endif
+#if !(defined HAVE_MMAP && defined HAVE_MADVISE && defined MADV_WILLNEED)
+# undef HAVE_MADVISE
+#endif
+
+#if !defined _LIBC && defined HAVE_GETTIMEOFDAY
+# include <sys/time.h>
+#endif
+#if !defined _LIBC && defined HAVE_GETRUSAGE
+# include <sys/time.h>
+# include <sys/resource.h>
+#endif
+
 #if defined HAVE_STDINT_H_WITH_UINTMAX || defined _LIBC
 # include <stdint.h>
 #endif
@@ -87,6 +104,15 @@ char *alloca ();
 #include "hash-string.h"
 #include "plural-exp.h"
 
+/* Some compilers, like SunOS4 cc, don't have offsetof in <stddef.h>.  */
+#ifndef offsetof
+# define offsetof(type,ident) ((size_t)&(((type*)0)->ident))
+#endif
+
+/* Minimum size of a .mo file: the size of the header up to minor
+   revision 1.  */
+#define MO_MIN_SIZE offsetof (struct mo_file_header, n_expanded_sysdep_strings)
+
 #ifdef _LIBC
 # include "../locale/localeinfo.h"
 # include <not-cancel.h>
@@ -773,6 +799,461 @@ get_sysdep_segment_value (const char *name)
   return NULL;
 }
 
+/* Return 1 if the system dependent strings of the catalog DATA of SIZE
+   bytes are also stored expanded for the segment values VALUES.  */
+static int
+expanded_sysdep_values_match (const struct mo_file_header *data, size_t size,
+			      int must_swap, nls_uint32 n_sysdep_segments,
+			      const char **values)
+{
+  nls_uint32 values_offset;
+  const struct sysdep_segment *assumed;
+  nls_uint32 i;
+
+  if (size < sizeof (struct mo_file_header)
+      || W (must_swap, data->n_expanded_sysdep_strings) == 0
+      || W (must_swap, data->expanded_hash_tab_offset) > size
+      || W (must_swap, data->hash_tab_size)
+	 > (size - W (must_swap, data->expanded_hash_tab_offset))
+	   / sizeof (nls_uint32))
+    return 0;
+  values_offset = W (must_swap, data->sysdep_values_offset);
+  if (values_offset > size
+      || n_sysdep_segments
+	 > (size - values_offset) / sizeof (struct sysdep_segment))
+    return 0;
+  assumed =
+    (const struct sysdep_segment *) ((const char *) data + values_offset);
+  for (i = 0; i < n_sysdep_segments; i++)
+    {
+      nls_uint32 length = W (must_swap, assumed[i].length);
+      nls_uint32 offset = W (must_swap, assumed[i].offset);
+
+      if (values[i] == NULL)
+	{
+	  if (length != 0)
+	    return 0;
+	}
+      else
+	{
+	  /* LENGTH includes the trailing NUL.  */
+	  if (length != strlen (values[i]) + 1
+	      || offset > size || length > size - offset
+	      || memcmp ((const char *) data + offset, values[i], length) != 0)
+	    return 0;
+	}
+    }
+  return 1;
+}
+
+/* Return 1 if the system dependent strings pairs that msgfmt has stored
+   expanded in the catalog DATA of SIZE bytes, after the static string pairs,
+   have their descriptors and their NUL terminated strings inside the file.  */
+static int
+expanded_sysdep_strings_valid (const struct mo_file_header *data, size_t size,
+			       int must_swap)
+{
+  nls_uint32 nstrings = W (must_swap, data->nstrings);
+  nls_uint32 total =
+    nstrings + W (must_swap, data->n_expanded_sysdep_strings);
+  int j;
+
+  if (total < nstrings)
+    return 0;
+  for (j = 0; j < 2; j++)
+    {
+      nls_uint32 tab_offset =
+	W (must_swap, j == 0 ? data->orig_tab_offset : data->trans_tab_offset);
+      const struct string_desc *tab;
+      nls_uint32 i;
+
+      if (tab_offset > size
+	  || total > (size - tab_offset) / sizeof (struct string_desc))
+	return 0;
+      tab = (const struct string_desc *) ((const char *) data + tab_offset);
+      for (i = nstrings; i < total; i++)
+	{
+	  nls_uint32 length = W (must_swap, tab[i].length);
+	  nls_uint32 offset = W (must_swap, tab[i].offset);
+
+	  if (offset >= size || length >= size - offset
+	      || ((const char *) data)[offset + length] != '\0')
+	    return 0;
+	}
+    }
+  return 1;
+}
+
+/* Name of a bundle of message catalogs, in the same directory as the
+   catalogs (e.g. "/usr/share/locale/de/LC_MESSAGES/catalogs.mob").
+   Such a bundle, produced by "msgfmt --bundle", holds the .mo files of many
+   text domains in a single file, so that they can be loaded with a single
+   open() and mmap().  */
+#define BUNDLE_NAME "catalogs.mob"
+
+/* A bundle of message catalogs.  */
+struct loaded_bundle
+{
+  struct loaded_bundle *next;
+  /* Pointer to memory containing the bundle, or NULL if there is no valid
+     bundle in this directory.  */
+  const char *data;
+  /* 1 if the memory is mmap()ed, 0 if the memory is malloc()ed.  */
+  int use_mmap;
+  /* Size of the bundle.  */
+  size_t size;
+  /* 1 if the bundle uses a different endianness than this machine.  */
+  int must_swap;
+  /* Number of catalogs.  */
+  nls_uint32 nentries;
+  /* Pointer to the table of catalogs, sorted by domain name.  */
+  const struct mo_bundle_entry *entries;
+  /* Directory name, including the trailing slash.  */
+  char dirname[ZERO];
+};
+
+/* List of the bundles looked up so far.  Protected by the lock in
+   _nl_load_domain.  */
+static struct loaded_bundle *loaded_bundles;
+
+/* Read the bundle in the directory DIRNAME of length DIRNAME_LEN, including
+   the trailing slash.  Return NULL if out of memory.  */
+static struct loaded_bundle *
+load_bundle (const char *dirname, size_t dirname_len)
+{
+  struct loaded_bundle *bundle;
+  char *filename;
+  int fd;
+  size_t size;
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+  const struct mo_bundle_header *data;
+  int use_mmap = 0;
+  int must_swap;
+  nls_uint32 nentries;
+  nls_uint32 entries_offset;
+  nls_uint32 i;
+
+  bundle =
+    (struct loaded_bundle *)
+    malloc (sizeof (struct loaded_bundle) + dirname_len + 1);
+  if (bundle == NULL)
+    return NULL;
+  memcpy (bundle->dirname, dirname, dirname_len);
+  bundle->dirname[dirname_len] = '\0';
+  bundle->data = NULL;
+  bundle->next = loaded_bundles;
+  loaded_bundles = bundle;
+
+  filename = (char *) malloc (dirname_len + sizeof (BUNDLE_NAME));
+  if (filename == NULL)
+    return bundle;
+  memcpy (filename, dirname, dirname_len);
+  memcpy (filename + dirname_len, BUNDLE_NAME, sizeof (BUNDLE_NAME));
+
+  fd = -1;
+  if (_nl_catalog_may_exist (filename))
+    fd = open (filename, O_RDONLY | O_BINARY);
+  free (filename);
+  if (fd == -1)
+    return bundle;
+
+  if (
+#ifdef _LIBC
+      __builtin_expect (fstat64 (fd, &st) != 0, 0)
+#else
+      __builtin_expect (fstat (fd, &st) != 0, 0)
+#endif
+      || __builtin_expect ((size = (size_t) st.st_size) != st.st_size, 0)
+      || __builtin_expect (size < sizeof (struct mo_bundle_header), 0))
+    {
+      close (fd);
+      return bundle;
+    }
+
+  data = (const struct mo_bundle_header *) -1;
+#ifdef HAVE_MMAP
+  data = (const struct mo_bundle_header *) mmap (NULL, size, PROT_READ,
+						 MAP_PRIVATE, fd, 0);
+  if (__builtin_expect (data != (const struct mo_bundle_header *) -1, 1))
+    use_mmap = 1;
+#endif
+
+  if (data == (const struct mo_bundle_header *) -1)
+    {
+      size_t to_read;
+      char *read_ptr;
+
+      read_ptr = (char *) malloc (size);
+      if (read_ptr == NULL)
+	{
+	  close (fd);
+	  return bundle;
+	}
+      data = (const struct mo_bundle_header *) read_ptr;
+
+      to_read = size;
+      do
+	{
+	  long int nb = (long int) read (fd, read_ptr, to_read);
+	  if (nb <= 0)
+	    {
+#ifdef EINTR
+	      if (nb == -1 && errno == EINTR)
+		continue;
+#endif
+	      free ((void *) data);
+	      close (fd);
+	      return bundle;
+	    }
+	  read_ptr += nb;
+	  to_read -= nb;
+	}
+      while (to_read > 0);
+    }
+  close (fd);
+
+  /* Validate the bundle, so that find_in_bundle() can trust it.  */
+  if (data->magic != _MAGIC_BUNDLE && data->magic != _MAGIC_BUNDLE_SWAPPED)
+    goto invalid;
+  must_swap = data->magic != _MAGIC_BUNDLE;
+  if ((W (must_swap, data->revision) >> 16) != 0)
+    goto invalid;
+  nentries = W (must_swap, data->nentries);
+  entries_offset = W (must_swap, data->entries_offset);
+  if (entries_offset % 4 != 0
+      || entries_offset > size
+      || nentries > (size - entries_offset) / sizeof (struct mo_bundle_entry))
+    goto invalid;
+  bundle->entries =
+    (const struct mo_bundle_entry *) ((const char *) data + entries_offset);
+  for (i = 0; i < nentries; i++)
+    {
+      const struct mo_bundle_entry *entry = &bundle->entries[i];
+      nls_uint32 name_length = W (must_swap, entry->name_length);
+      nls_uint32 name_offset = W (must_swap, entry->name_offset);
+      nls_uint32 length = W (must_swap, entry->length);
+      nls_uint32 offset = W (must_swap, entry->offset);
+
+      if (name_offset > size || name_length >= size - name_offset
+	  || ((const char *) data)[name_offset + name_length] != '\0'
+	  || offset % 8 != 0 || offset > size || length > size - offset
+	  || length < MO_MIN_SIZE)
+	goto invalid;
+    }
+
+  bundle->data = (const char *) data;
+  bundle->use_mmap = use_mmap;
+  bundle->size = size;
+  bundle->must_swap = must_swap;
+  bundle->nentries = nentries;
+  return bundle;
+
+ invalid:
+#ifdef HAVE_MMAP
+  if (use_mmap)
+    munmap ((caddr_t) data, size);
+  else
+#endif
+    free ((void *) data);
+  return bundle;
+}
+
+/* Look up the message catalog FILENAME, of the form DIRNAME/DOMAIN.mo, in
+   the bundle of DIRNAME.  Return a pointer to the contents of the catalog
+   and store its size in *SIZEP, or return NULL if there is no such bundle
+   or the bundle doesn't contain DOMAIN.  */
+static const char *
+find_in_bundle (const char *filename, size_t *sizep)
+{
+  const char *domain;
+  size_t dirname_len;
+  size_t domain_len;
+  struct loaded_bundle *bundle;
+  nls_uint32 bottom;
+  nls_uint32 top;
+
+  domain = strrchr (filename, '/');
+  if (domain == NULL)
+    return NULL;
+  domain++;
+  dirname_len = domain - filename;
+  domain_len = strlen (domain);
+  if (domain_len > 3 && memcmp (domain + domain_len - 3, ".mo", 3) == 0)
+    domain_len -= 3;
+
+  for (bundle = loaded_bundles; bundle != NULL; bundle = bundle->next)
+    if (strncmp (bundle->dirname, filename, dirname_len) == 0
+	&& bundle->dirname[dirname_len] == '\0')
+      break;
+  if (bundle == NULL)
+    {
+      bundle = load_bundle (filename, dirname_len);
+      if (bundle == NULL)
+	return NULL;
+    }
+  if (bundle->data == NULL)
+    return NULL;
+
+  /* Binary search in the sorted table of catalogs.  */
+  bottom = 0;
+  top = bundle->nentries;
+  while (bottom < top)
+    {
+      nls_uint32 act = (bottom + top) / 2;
+      const struct mo_bundle_entry *entry = &bundle->entries[act];
+      size_t name_length = W (bundle->must_swap, entry->name_length);
+      const char *name =
+	bundle->data + W (bundle->must_swap, entry->name_offset);
+      int cmp;
+
+      cmp = memcmp (domain, name,
+		    domain_len < name_length ? domain_len : name_length);
+      if (cmp == 0)
+	cmp = (domain_len < name_length ? -1 : domain_len > name_length);
+      if (cmp < 0)
+	top = act;
+      else if (cmp > 0)
+	bottom = act + 1;
+      else
+	{
+	  *sizep = W (bundle->must_swap, entry->length);
+	  return bundle->data + W (bundle->must_swap, entry->offset);
+	}
+    }
+  return NULL;
+}
+
+/* How much of a mapped message catalog to read ahead when it is loaded.
+   By default nothing; the environment variable GETTEXT_PREFAULT selects
+   more.  */
+enum prefault_mode
+{
+  prefault_none,	/* Nothing; take a page fault on each first access.  */
+  prefault_tables,	/* The string descriptor tables and the hash table.  */
+  prefault_all		/* The entire catalog.  */
+};
+
+static enum prefault_mode
+get_prefault_mode (void)
+{
+#ifndef _LIBC
+  const char *value = getenv ("GETTEXT_PREFAULT");
+
+  if (value != NULL)
+    {
+      if (strcmp (value, "tables") == 0)
+	return prefault_tables;
+      if (strcmp (value, "all") == 0)
+	return prefault_all;
+    }
+#endif
+  return prefault_none;
+}
+
+/* Tell the kernel that the bytes [START, END) of a mapped message catalog
+   will be accessed soon, so that it reads them in a few large requests
+   instead of one page fault at a time.  */
+static void
+advise_willneed (const char *start, const char *end)
+{
+#ifdef HAVE_MADVISE
+# ifdef _LIBC
+  size_t pagesize = __getpagesize ();
+# elif defined _SC_PAGESIZE
+  size_t pagesize = sysconf (_SC_PAGESIZE);
+# else
+  size_t pagesize = 4096;
+# endif
+  const char *page = start - (size_t) start % pagesize;
+
+  if (end > page)
+    madvise ((caddr_t) page, end - page, MADV_WILLNEED);
+#endif
+}
+
+#ifndef _LIBC
+/* Measurements taken while loading a message catalog, for the log file
+   designated by the environment variable GETTEXT_LOG_LOAD.  */
+struct load_stats
+{
+  const char *logfilename;
+# ifdef HAVE_GETTIMEOFDAY
+  struct timeval time;
+# endif
+# ifdef HAVE_GETRUSAGE
+  struct rusage usage;
+# endif
+};
+
+static void
+load_stats_start (struct load_stats *stats)
+{
+  stats->logfilename =
+    (_nl_enable_secure == 1 ? NULL : getenv ("GETTEXT_LOG_LOAD"));
+  if (stats->logfilename != NULL && stats->logfilename[0] == '\0')
+    stats->logfilename = NULL;
+  if (stats->logfilename != NULL)
+    {
+# ifdef HAVE_GETTIMEOFDAY
+      gettimeofday (&stats->time, NULL);
+# endif
+# ifdef HAVE_GETRUSAGE
+      getrusage (RUSAGE_SELF, &stats->usage);
+# endif
+    }
+}
+
+static void
+load_stats_end (const struct load_stats *stats, const char *filename,
+		size_t size, const char *how)
+{
+  long int usec = -1;
+  long int minflt = -1;
+  long int majflt = -1;
+
+  if (stats->logfilename == NULL)
+    return;
+# ifdef HAVE_GETTIMEOFDAY
+  {
+    struct timeval now;
+
+    gettimeofday (&now, NULL);
+    usec = (now.tv_sec - stats->time.tv_sec) * 1000000L
+	   + (now.tv_usec - stats->time.tv_usec);
+  }
+# endif
+# ifdef HAVE_GETRUSAGE
+  {
+    struct rusage now;
+
+    getrusage (RUSAGE_SELF, &now);
+    minflt = now.ru_minflt - stats->usage.ru_minflt;
+    majflt = now.ru_majflt - stats->usage.ru_majflt;
+  }
+# endif
+  _nl_log_load (stats->logfilename, filename, size, how, usec, minflt, majflt);
+}
+
+/* Describe how a message catalog was brought into memory, for the log.  */
+static const char *
+load_method (int in_bundle, int use_mmap, enum prefault_mode prefault)
+{
+  if (in_bundle)
+    return (prefault == prefault_all ? "bundle, read ahead all"
+	    : prefault == prefault_tables ? "bundle, read ahead tables"
+	    : "bundle");
+  if (use_mmap)
+    return (prefault == prefault_all ? "mmap, read ahead all"
+	    : prefault == prefault_tables ? "mmap, read ahead tables"
+	    : "mmap");
+  return "read";
+}
+#endif
+
 /* Load the message catalogs specified by FILENAME.  If it is no valid
    message catalog do nothing.  */
 void
@@ -790,6 +1271,11 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 #endif
   struct mo_file_header *data = (struct mo_file_header *) -1;
   int use_mmap = 0;
+  int in_bundle = 0;
+  enum prefault_mode prefault;
+#ifndef _LIBC
+  struct load_stats stats;
+#endif
   struct loaded_domain *domain;
   int revision;
   const char *nullentry;
@@ -824,6 +1310,27 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   if (domain_file->filename == NULL)
     goto out;
 
+#ifndef _LIBC
+  load_stats_start (&stats);
+#endif
+  prefault = get_prefault_mode ();
+
+  /* If the catalog is part of a bundle, use the bundle's memory.  */
+  {
+    const char *bundle_data = find_in_bundle (domain_file->filename, &size);
+
+    if (bundle_data != NULL)
+      {
+	data = (struct mo_file_header *) bundle_data;
+	in_bundle = 1;
+	goto have_data;
+      }
+  }
+
+  /* Don't probe for catalogs in directories that are known to be absent.  */
+  if (!_nl_catalog_may_exist (domain_file->filename))
+    goto out;
+
   /* Try to open the addressed file.  */
   fd = open (domain_file->filename, O_RDONLY | O_BINARY);
   if (fd == -1)
@@ -837,7 +1344,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       __builtin_expect (fstat (fd, &st) != 0, 0)
 #endif
       || __builtin_expect ((size = (size_t) st.st_size) != st.st_size, 0)
-      || __builtin_expect (size < sizeof (struct mo_file_header), 0))
+      || __builtin_expect (size < MO_MIN_SIZE, 0))
     /* Something went wrong.  */
     goto out;
 
@@ -845,7 +1352,12 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   /* Now we are ready to load the file.  If mmap() is available we try
      this first.  If not available or it failed we try to load it.  */
   data = (struct mo_file_header *) mmap (NULL, size, PROT_READ,
-					 MAP_PRIVATE, fd, 0);
+					 MAP_PRIVATE
+#ifdef MAP_POPULATE
+					 | (prefault == prefault_all
+					    ? MAP_POPULATE : 0)
+#endif
+					 , fd, 0);
 
   if (__builtin_expect (data != (struct mo_file_header *) -1, 1))
     {
@@ -889,18 +1401,22 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       fd = -1;
     }
 
+ have_data:
   /* Using the magic number we can test whether it really is a message
      catalog file.  */
   if (__builtin_expect (data->magic != _MAGIC && data->magic != _MAGIC_SWAPPED,
 			0))
     {
       /* The magic number is wrong: not a message catalog file.  */
+      if (!in_bundle)
+	{
 #ifdef HAVE_MMAP
-      if (use_mmap)
-	munmap ((caddr_t) data, size);
-      else
+	  if (use_mmap)
+	    munmap ((caddr_t) data, size);
+	  else
 #endif
-	free (data);
+	    free (data);
+	}
       goto out;
     }
 
@@ -912,6 +1428,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   domain->data = (char *) data;
   domain->use_mmap = use_mmap;
   domain->mmap_size = size;
+  domain->in_bundle = in_bundle;
   domain->must_swap = data->magic != _MAGIC;
   domain->malloced = NULL;
 
@@ -995,6 +1512,28 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		    sysdep_segment_values[i] = get_sysdep_segment_value (name);
 		  }
 
+		/* If msgfmt has stored the system dependent strings expanded
+		   for the same segment values, use these expansions in place:
+		   they follow the static strings in the string tables, and
+		   the hash table that covers them needs no augmenting.
+		   Otherwise, or if they are not entirely inside the file,
+		   expand the strings here.  */
+		if ((revision & 0xffff) >= 2
+		    && expanded_sysdep_values_match (data, size,
+						     domain->must_swap,
+						     n_sysdep_segments,
+						     sysdep_segment_values)
+		    && expanded_sysdep_strings_valid (data, size,
+						      domain->must_swap))
+		  {
+		    domain->nstrings +=
+		      W (domain->must_swap, data->n_expanded_sysdep_strings);
+		    domain->hash_tab = (const nls_uint32 *)
+		      ((char *) data
+		       + W (domain->must_swap, data->expanded_hash_tab_offset));
+		    n_sysdep_strings = 0;
+		  }
+
 		orig_sysdep_tab = (const nls_uint32 *)
 		  ((char *) data
 		   + W (domain->must_swap, data->orig_sysdep_tab_offset));
@@ -1260,17 +1799,59 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
     invalid:
       /* This is an invalid .mo file.  */
       free (domain->malloced);
+      if (!in_bundle)
+	{
 #ifdef HAVE_MMAP
-      if (use_mmap)
-	munmap ((caddr_t) data, size);
-      else
+	  if (use_mmap)
+	    munmap ((caddr_t) data, size);
+	  else
 #endif
-	free (data);
+	    free (data);
+	}
       free (domain);
       domain_file->data = NULL;
       goto out;
     }
 
+  /* Read ahead the parts of a mapped catalog that every lookup touches.
+     msgfmt writes the string descriptor tables and the hash table next to
+     each other, right after the header.  */
+  if (use_mmap || in_bundle)
+    {
+      if (prefault == prefault_all)
+	{
+#ifdef MAP_POPULATE
+	  if (in_bundle)
+#endif
+	    advise_willneed ((const char *) data, (const char *) data + size);
+	}
+      else if (prefault == prefault_tables)
+	{
+	  const char *start = (const char *) domain->orig_tab;
+	  const char *end =
+	    (const char *) (domain->orig_tab + domain->nstrings);
+
+	  if ((const char *) domain->trans_tab < start)
+	    start = (const char *) domain->trans_tab;
+	  if ((const char *) (domain->trans_tab + domain->nstrings) > end)
+	    end = (const char *) (domain->trans_tab + domain->nstrings);
+	  if (domain->hash_tab != NULL
+	      && (const char *) data <= (const char *) domain->hash_tab
+	      && (const char *) domain->hash_tab < (const char *) data + size)
+	    {
+	      if ((const char *) domain->hash_tab < start)
+		start = (const char *) domain->hash_tab;
+	      if ((const char *) (domain->hash_tab + domain->hash_size) > end)
+		end = (const char *) (domain->hash_tab + domain->hash_size);
+	    }
+	  if (start < (const char *) data)
+	    start = (const char *) data;
+	  if (end > (const char *) data + size)
+	    end = (const char *) data + size;
+	  advise_willneed (start, end);
+	}
+    }
+
   /* No caches of converted translations so far.  */
   domain->conversions = NULL;
   domain->nconversions = 0;
@@ -1284,6 +1865,12 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   nullentry = _nl_find_msg (domain_file, domainbinding, "", 0, &nullentrylen);
 #endif
   EXTRACT_PLURAL_EXPRESSION (nullentry, &domain->plural, &domain->nplurals);
+  COMPILE_PLURAL (domain->plural, &domain->plural_program);
+
+#ifndef _LIBC
+  load_stats_end (&stats, domain_file->filename, size,
+		  load_method (in_bundle, use_mmap, prefault));
+#endif
 
  out:
   if (fd != -1)
@@ -1305,6 +1892,7 @@ _nl_unload_domain (struct loaded_domain *domain)
 
   if (domain->plural != &__gettext_germanic_plural)
     __gettext_free_exp ((struct expression *) domain->plural);
+  free (domain->plural_program.code);
 
   for (i = 0; i < domain->nconversions; i++)
     {
@@ -1321,13 +1909,38 @@ _nl_unload_domain (struct loaded_domain *domain)
 
   free (domain->malloced);
 
+  if (!domain->in_bundle)
+    {
 # ifdef _POSIX_MAPPED_FILES
-  if (domain->use_mmap)
-    munmap ((caddr_t) domain->data, domain->mmap_size);
-  else
+      if (domain->use_mmap)
+	munmap ((caddr_t) domain->data, domain->mmap_size);
+      else
 # endif	/* _POSIX_MAPPED_FILES */
-    free ((void *) domain->data);
+	free ((void *) domain->data);
+    }
 
   free (domain);
 }
+
+void
+internal_function __libc_freeres_fn_section
+_nl_unload_bundles (void)
+{
+  while (loaded_bundles != NULL)
+    {
+      struct loaded_bundle *here = loaded_bundles;
+
+      loaded_bundles = here->next;
+      if (here->data != NULL)
+	{
+# ifdef _POSIX_MAPPED_FILES
+	  if (here->use_mmap)
+	    munmap ((caddr_t) here->data, here->size);
+	  else
+# endif	/* _POSIX_MAPPED_FILES */
+	    free ((void *) here->data);
+	}
+      free (here);
+    }
+}
 #endif
@@ -24,6 +24,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "gettextP.h"
+
 /* Handle multi-threaded applications.  */
 #ifdef _LIBC
 # include <bits/libc-lock.h>
@@ -56,17 +58,46 @@ print_escaped (FILE *stream, const char *str, const char *str_end)
   putc ('"', stream);
 }
 
+/* Print a string with quotes and escape sequences, on a single line.  */
+static void
+print_escaped_line (FILE *stream, const char *str)
+{
+  putc ('"', stream);
+  for (; *str != '\0'; str++)
+    {
+      unsigned char c = (unsigned char) *str;
+
+      switch (c)
+        {
+        case '"': case '\\':
+          putc ('\\', stream);
+          putc (c, stream);
+          break;
+        case '\n':
+          fputs ("\\n", stream);
+          break;
+        case '\t':
+          fputs ("\\t", stream);
+          break;
+        default:
+          if (c < 0x20 || c == 0x7f)
+            fprintf (stream, "\\%03o", c);
+          else
+            putc (c, stream);
+          break;
+        }
+    }
+  putc ('"', stream);
+}
+
 static char *last_logfilename = NULL;
 static FILE *last_logfile = NULL;
 __libc_lock_define_initialized (static, lock)
 
-static inline void
-_nl_log_untranslated_locked (const char *logfilename, const char *domainname,
-                             const char *msgid1, const char *msgid2, int plural)
+/* Return the stream for LOGFILENAME, or NULL if it cannot be opened.  */
+static FILE *
+open_logfile_locked (const char *logfilename)
 {
-  FILE *logfile;
-  const char *separator;
-
   /* Can we reuse the last opened logfile?  */
   if (last_logfilename == NULL || strcmp (logfilename, last_logfilename) != 0)
     {
@@ -84,13 +115,23 @@ _nl_log_untranslated_locked (const char *logfilename, const char *domainname,
       /* Open the logfile.  */
       last_logfilename = (char *) malloc (strlen (logfilename) + 1);
       if (last_logfilename == NULL)
-        return;
+        return NULL;
       strcpy (last_logfilename, logfilename);
       last_logfile = fopen (logfilename, "a");
-      if (last_logfile == NULL)
-        return;
     }
-  logfile = last_logfile;
+  return last_logfile;
+}
+
+static inline void
+_nl_log_untranslated_locked (const char *logfilename, const char *domainname,
+                             const char *msgid1, const char *msgid2, int plural)
+{
+  FILE *logfile;
+  const char *separator;
+
+  logfile = open_logfile_locked (logfilename);
+  if (logfile == NULL)
+    return;
 
   fprintf (logfile, "domain ");
   print_escaped (logfile, domainname, domainname + strlen (domainname));
@@ -124,3 +165,73 @@ _nl_log_untranslated (const char *logfilename, const char *domainname,
   _nl_log_untranslated_locked (logfilename, domainname, msgid1, msgid2, plural);
   __libc_lock_unlock (lock);
 }
+
+/* Add to the log file an entry describing the loading of the message
+   catalog FILENAME of SIZE bytes.  HOW tells how it was brought into memory.
+   USEC is the time it took, in microseconds, MINFLT and MAJFLT the number
+   of minor and major page faults incurred meanwhile; each is -1 if
+   unknown.  */
+void
+_nl_log_load (const char *logfilename, const char *filename, size_t size,
+              const char *how, long int usec, long int minflt, long int majflt)
+{
+  FILE *logfile;
+
+  __libc_lock_lock (lock);
+  logfile = open_logfile_locked (logfilename);
+  if (logfile != NULL)
+    {
+      fprintf (logfile, "# loaded %s: %lu bytes, %s", filename,
+               (unsigned long int) size, how);
+      if (usec >= 0)
+        fprintf (logfile, ", %ld us", usec);
+      if (minflt >= 0 && majflt >= 0)
+        fprintf (logfile, ", %ld minor + %ld major page faults",
+                 minflt, majflt);
+      putc ('\n', logfile);
+      fflush (logfile);
+    }
+  __libc_lock_unlock (lock);
+}
+
+/* Append to the log file the lookup profile of the program: the TOTALS and
+   the NENTRIES ENTRIES, one line per msgid.  */
+void
+_nl_log_profile (const char *logfilename,
+                 const struct lookup_profile_totals *totals,
+                 struct lookup_profile_entry **entries, size_t nentries)
+{
+  FILE *logfile;
+
+  __libc_lock_lock (lock);
+  logfile = open_logfile_locked (logfilename);
+  if (logfile != NULL)
+    {
+      size_t i;
+
+      fprintf (logfile, "# GNU gettext lookup profile\n");
+      fprintf (logfile, "# threads: %lu\n", totals->threads);
+      fprintf (logfile, "# lookups: %lu\n", totals->lookups);
+      fprintf (logfile, "# cache: %lu hits, %lu misses\n",
+               totals->cache_hits, totals->cache_misses);
+      fprintf (logfile, "# _nl_find_msg: %lu calls, %.0f ns\n",
+               totals->find_calls, totals->find_nsec);
+      fprintf (logfile, "# charset conversion: %lu calls, %.0f ns\n",
+               totals->conversions, totals->conversion_nsec);
+      for (i = 0; i < nentries; i++)
+        {
+          fprintf (logfile, "%lu\t", entries[i]->count);
+          print_escaped_line (logfile, entries[i]->domainname);
+          putc ('\t', logfile);
+          print_escaped_line (logfile, entries[i]->msgid);
+          if (entries[i]->msgid_plural != NULL)
+            {
+              putc ('\t', logfile);
+              print_escaped_line (logfile, entries[i]->msgid_plural);
+            }
+          putc ('\n', logfile);
+        }
+      fflush (logfile);
+    }
+  __libc_lock_unlock (lock);
+}
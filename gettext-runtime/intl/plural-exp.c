@@ -151,3 +151,195 @@ EXTRACT_PLURAL_EXPRESSION (const char *nullentry,
       *npluralsp = 2;
     }
 }
+
+
+/* Return the opcode corresponding to the binary operator OP.  */
+static enum plural_opcode
+binary_opcode (enum expression_operator op)
+{
+  switch (op)
+    {
+    case mult:
+      return plop_mult;
+    case divide:
+      return plop_divide;
+    case module:
+      return plop_module;
+    case plus:
+      return plop_plus;
+    case minus:
+      return plop_minus;
+    case less_than:
+      return plop_less_than;
+    case greater_than:
+      return plop_greater_than;
+    case less_or_equal:
+      return plop_less_or_equal;
+    case greater_or_equal:
+      return plop_greater_or_equal;
+    case equal:
+      return plop_equal;
+    case not_equal:
+    default:
+      return plop_not_equal;
+    }
+}
+
+/* Emit the instructions for EXP into CODE, starting at *POSP, for a stack
+   that holds DEPTH values before EXP is evaluated.  When CODE is NULL,
+   only count the instructions.  Update *MAXDEPTHP to the maximum stack
+   depth reached.  */
+static void
+compile_exp (const struct expression *exp, struct plural_insn *code,
+	     size_t *posp, unsigned int depth, unsigned int *maxdepthp)
+{
+#define EMIT(op, imm, value) \
+  do								\
+    {								\
+      if (code != NULL)						\
+	{							\
+	  code[*posp].opcode = (op);				\
+	  code[*posp].immediate = (imm);			\
+	  code[*posp].val = (value);				\
+	}							\
+      (*posp)++;						\
+    }								\
+  while (0)
+
+  size_t jz_pos;
+  size_t jmp_pos;
+
+  switch (exp->nargs)
+    {
+    case 0:
+      if (depth + 1 > *maxdepthp)
+	*maxdepthp = depth + 1;
+      if (exp->operation == var)
+	EMIT (plop_var, 0, 0);
+      else
+	EMIT (plop_num, 0, exp->val.num);
+      return;
+
+    case 1:
+      /* exp->operation must be lnot.  */
+      compile_exp (exp->val.args[0], code, posp, depth, maxdepthp);
+      EMIT (plop_lnot, 0, 0);
+      return;
+
+    case 2:
+      if (exp->operation == land || exp->operation == lor)
+	{
+	  /* Compile "a && b" as "a ? !!b : 0", and "a || b" as
+	     "a ? 1 : !!b".  */
+	  compile_exp (exp->val.args[0], code, posp, depth, maxdepthp);
+	  jz_pos = *posp;
+	  EMIT (plop_jz, 0, 0);
+	  if (exp->operation == land)
+	    {
+	      compile_exp (exp->val.args[1], code, posp, depth, maxdepthp);
+	      EMIT (plop_bool, 0, 0);
+	    }
+	  else
+	    EMIT (plop_num, 0, 1);
+	  jmp_pos = *posp;
+	  EMIT (plop_jmp, 0, 0);
+	  if (code != NULL)
+	    code[jz_pos].val = *posp;
+	  if (exp->operation == land)
+	    EMIT (plop_num, 0, 0);
+	  else
+	    {
+	      compile_exp (exp->val.args[1], code, posp, depth, maxdepthp);
+	      EMIT (plop_bool, 0, 0);
+	    }
+	  if (code != NULL)
+	    code[jmp_pos].val = *posp;
+	}
+      else if (exp->val.args[1]->nargs == 0
+	       && exp->val.args[1]->operation == num)
+	{
+	  /* The right operand is a constant, as in "n%10" or "n==1".  */
+	  compile_exp (exp->val.args[0], code, posp, depth, maxdepthp);
+	  EMIT (binary_opcode (exp->operation), 1, exp->val.args[1]->val.num);
+	}
+      else
+	{
+	  compile_exp (exp->val.args[0], code, posp, depth, maxdepthp);
+	  compile_exp (exp->val.args[1], code, posp, depth + 1, maxdepthp);
+	  EMIT (binary_opcode (exp->operation), 0, 0);
+	}
+      return;
+
+    case 3:
+      /* exp->operation must be qmop.  */
+      compile_exp (exp->val.args[0], code, posp, depth, maxdepthp);
+      jz_pos = *posp;
+      EMIT (plop_jz, 0, 0);
+      compile_exp (exp->val.args[1], code, posp, depth, maxdepthp);
+      jmp_pos = *posp;
+      EMIT (plop_jmp, 0, 0);
+      if (code != NULL)
+	code[jz_pos].val = *posp;
+      compile_exp (exp->val.args[2], code, posp, depth, maxdepthp);
+      if (code != NULL)
+	code[jmp_pos].val = *posp;
+      return;
+    }
+
+#undef EMIT
+}
+
+/* Compile the plural expression EXP into *PROGP.  If the expression is too
+   deep, or memory is exhausted, *PROGP refers back to EXP, so that the
+   result can always be passed to plural_eval_program().  */
+void
+internal_function
+COMPILE_PLURAL (const struct expression *exp, struct plural_program *progp)
+{
+  size_t ninsns;
+  unsigned int maxdepth;
+
+  progp->kind = plural_prog_tree;
+  progp->operation = exp->operation;
+  progp->val = 0;
+  progp->code = NULL;
+  progp->tree = exp;
+
+  /* Recognize the closed forms used by most languages: a constant, as in
+     "plural=0;", and a single comparison of n against a constant, as in
+     "plural=(n != 1);" or "plural=(n > 1);".  */
+  if (exp->nargs == 0 && exp->operation == num)
+    {
+      progp->kind = plural_prog_constant;
+      progp->val = exp->val.num;
+      return;
+    }
+  if (exp->nargs == 2
+      && exp->operation >= less_than && exp->operation <= not_equal
+      && exp->val.args[0]->nargs == 0 && exp->val.args[0]->operation == var
+      && exp->val.args[1]->nargs == 0 && exp->val.args[1]->operation == num)
+    {
+      progp->kind = plural_prog_compare;
+      progp->val = exp->val.args[1]->val.num;
+      return;
+    }
+
+  /* First pass: determine the size of the program.  */
+  ninsns = 0;
+  maxdepth = 0;
+  compile_exp (exp, NULL, &ninsns, 0, &maxdepth);
+  if (maxdepth > PLURAL_STACK_MAX)
+    return;
+
+  /* Second pass: emit the instructions.  */
+  progp->code =
+    (struct plural_insn *) malloc ((ninsns + 1) * sizeof (struct plural_insn));
+  if (progp->code == NULL)
+    return;
+  ninsns = 0;
+  compile_exp (exp, progp->code, &ninsns, 0, &maxdepth);
+  progp->code[ninsns].opcode = plop_ret;
+  progp->code[ninsns].immediate = 0;
+  progp->code[ninsns].val = 0;
+  progp->kind = plural_prog_code;
+}
@@ -69,6 +69,65 @@ struct expression
   } val;
 };
 
+/* The instruction set of a compiled plural expression.  The program runs
+   on a small value stack; the arithmetic and comparison opcodes correspond
+   to the binary operators of 'struct expression'.  */
+enum plural_opcode
+{
+  plop_var,			/* Push the variable "n".  */
+  plop_num,			/* Push the constant 'val'.  */
+  plop_lnot,			/* Logical NOT of the top of stack.  */
+  plop_bool,			/* Normalize the top of stack to 0 or 1.  */
+  plop_mult,
+  plop_divide,
+  plop_module,
+  plop_plus,
+  plop_minus,
+  plop_less_than,
+  plop_greater_than,
+  plop_less_or_equal,
+  plop_greater_or_equal,
+  plop_equal,
+  plop_not_equal,
+  plop_jz,			/* Pop; jump to 'val' if the value was 0.  */
+  plop_jmp,			/* Jump to 'val'.  */
+  plop_ret			/* Return the top of stack.  */
+};
+
+struct plural_insn
+{
+  unsigned char opcode;		/* enum plural_opcode */
+  /* For binary operators: 1 if the right operand is 'val' rather than
+     the top of stack.  */
+  unsigned char immediate;
+  unsigned long int val;	/* Constant, immediate operand or jump target.  */
+};
+
+/* Maximum stack depth of a compiled plural expression.  Deeper expressions
+   are evaluated through the expression tree.  */
+#define PLURAL_STACK_MAX 16
+
+enum plural_program_kind
+{
+  plural_prog_tree,		/* Not compiled; walk 'tree'.  */
+  plural_prog_constant,		/* Always 'val', e.g. "0".  */
+  plural_prog_compare,		/* "n OP val", e.g. "n != 1" or "n > 1".  */
+  plural_prog_code		/* Run 'code'.  */
+};
+
+/* A plural expression compiled once per catalog, so that evaluating it
+   for each ngettext() call needs neither recursion nor pointer chasing.
+   The most common formulas are recognized as closed forms; all others
+   are turned into a flat instruction sequence.  */
+struct plural_program
+{
+  enum plural_program_kind kind;
+  enum expression_operator operation;	/* For plural_prog_compare.  */
+  unsigned long int val;	/* For plural_prog_constant/compare.  */
+  struct plural_insn *code;	/* For plural_prog_code, malloc()ed.  */
+  const struct expression *tree; /* The source expression.  */
+};
+
 /* This is the data structure to pass information to the parser and get
    the result in a thread-safe way.  */
 struct parse_args
@@ -93,16 +152,19 @@ struct parse_args
 # define PLURAL_PARSE __gettextparse
 # define GERMANIC_PLURAL __gettext_germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION __gettext_extract_plural
+# define COMPILE_PLURAL __gettext_compile_plural
 #elif defined (IN_LIBINTL)
 # define FREE_EXPRESSION libintl_gettext_free_exp
 # define PLURAL_PARSE libintl_gettextparse
 # define GERMANIC_PLURAL libintl_gettext_germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION libintl_gettext_extract_plural
+# define COMPILE_PLURAL libintl_gettext_compile_plural
 #else
 # define FREE_EXPRESSION free_plural_expression
 # define PLURAL_PARSE parse_plural_expression
 # define GERMANIC_PLURAL germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION extract_plural_expression
+# define COMPILE_PLURAL compile_plural_expression
 #endif
 
 extern void FREE_EXPRESSION (struct expression *exp)
@@ -113,10 +175,15 @@ extern void EXTRACT_PLURAL_EXPRESSION (const char *nullentry,
 				       const struct expression **pluralp,
 				       unsigned long int *npluralsp)
      internal_function;
+extern void COMPILE_PLURAL (const struct expression *exp,
+			    struct plural_program *progp)
+     internal_function;
 
 #if !defined (_LIBC) && !defined (IN_LIBINTL) && !defined (IN_LIBGLOCALE)
 extern unsigned long int plural_eval (const struct expression *pexp,
 				      unsigned long int n);
+extern unsigned long int plural_eval_program (const struct plural_program *prog,
+					      unsigned long int n);
 #endif
 
 
@@ -1,4 +1,4 @@
-# intl.m4 serial 22 (gettext-0.18.2)
+# intl.m4 serial 24 (gettext-0.18.3)
 dnl Copyright (C) 1995-2013 Free Software Foundation, Inc.
 dnl This file is free software; the Free Software Foundation
 dnl gives unlimited permission to copy and/or distribute it,
@@ -227,8 +227,16 @@ AC_DEFUN([gt_INTL_SUBDIR_CORE],
     [AC_DEFINE([HAVE_BUILTIN_EXPECT], [1],
        [Define to 1 if the compiler understands __builtin_expect.])])
 
+  AC_LINK_IFELSE(
+    [AC_LANG_PROGRAM(
+       [[static __thread int foo;]],
+       [[foo = 1; return foo - 1;]])],
+    [AC_DEFINE([HAVE_THREAD_LOCAL], [1],
+       [Define to 1 if the compiler supports __thread variables.])])
+
   AC_CHECK_HEADERS([argz.h inttypes.h limits.h unistd.h sys/param.h])
   AC_CHECK_FUNCS([getcwd getegid geteuid getgid getuid mempcpy munmap \
+    madvise getrusage gettimeofday clock_gettime \
     stpcpy strcasecmp strdup strtoul tsearch uselocale argz_count \
     argz_stringify argz_next __fsetlocking])
 
@@ -0,0 +1,70 @@
+/* Description of the binary intermediate catalog format.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _BINARY_CATALOG_H
+#define _BINARY_CATALOG_H
+
+/* The binary catalog format is a compact serialization of a
+   msgdomain_list_ty, meant for passing catalogs between the msg* programs
+   without printing and parsing PO syntax at every step.  It is not a
+   replacement for PO files: it is neither editable nor guaranteed to be
+   readable by other versions of these programs.
+
+   All numbers are unsigned and stored as a sequence of bytes, 7 bits per
+   byte, least significant group first; the most significant bit of a byte
+   is set when more bytes follow.  A string is stored as its length plus 1,
+   followed by its bytes; a NULL string is stored as the number 0.  A line
+   number is stored plus 1, so that (size_t)(-1) is stored as 0.
+
+   The file consists of
+     - the magic bytes BINARY_CATALOG_MAGIC,
+     - the format version number BINARY_CATALOG_VERSION,
+     - the number of file names, followed by the file names (a string
+       table that the file positions below refer to by index),
+     - the number of domains, followed by, for each domain,
+         - the domain name,
+         - the number of messages, followed by the messages.
+
+   A message consists of
+     - the msgctxt, msgid, msgid_plural strings,
+     - the msgstr, stored as its length followed by its bytes (the
+       plural forms are separated by NUL bytes),
+     - the index of the source file name plus 1 (0 denotes NULL) and the
+       line number of the message,
+     - the number of translator comments, followed by the comments,
+     - the number of extracted comments, followed by the comments,
+     - the number of file positions, followed by, for each file position,
+       the index of the file name and the line number,
+     - the flags other than the format flags, as a string in the syntax
+       of a '#,' comment line,
+     - the number of format flags, followed by, for each format flag, the
+       format language name (as in format_language) and the value of
+       enum is_format,
+     - the prev_msgctxt, prev_msgid, prev_msgid_plural strings,
+     - the number 1 for an obsolete message, 0 otherwise.
+
+   Readers ignore what follows the last domain.  Catalog index files (see
+   catalog-index.c) store their tables there.  */
+
+/* The magic bytes at the beginning of a binary catalog.  */
+#define BINARY_CATALOG_MAGIC "\223GNUcat\n"
+#define BINARY_CATALOG_MAGIC_LENGTH 8
+
+/* The version of the binary catalog format.  Incremented whenever the
+   layout changes in an incompatible way.  */
+#define BINARY_CATALOG_VERSION 2
+
+#endif /* _BINARY_CATALOG_H */
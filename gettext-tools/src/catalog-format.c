@@ -0,0 +1,77 @@
+/* Lookup of catalog file formats by name.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "catalog-format.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "read-po.h"
+#include "read-properties.h"
+#include "read-stringtable.h"
+#include "read-binary.h"
+#include "read-profile.h"
+#include "write-po.h"
+#include "write-properties.h"
+#include "write-stringtable.h"
+#include "write-binary.h"
+#include "gettext.h"
+
+#define _(str) gettext (str)
+
+
+catalog_input_format_ty
+catalog_input_format_by_name (const char *name)
+{
+  if (strcmp (name, "po") == 0)
+    return &input_format_po;
+  if (strcmp (name, "properties") == 0)
+    return &input_format_properties;
+  if (strcmp (name, "stringtable") == 0)
+    return &input_format_stringtable;
+  if (strcmp (name, "binary") == 0)
+    return &input_format_binary;
+  if (strcmp (name, "profile") == 0)
+    return &input_format_profile;
+
+  error (EXIT_FAILURE, 0, _("input format '%s' unknown"), name);
+  /* NOTREACHED */
+  return NULL;
+}
+
+
+catalog_output_format_ty
+catalog_output_format_by_name (const char *name)
+{
+  if (strcmp (name, "po") == 0)
+    return &output_format_po;
+  if (strcmp (name, "properties") == 0)
+    return &output_format_properties;
+  if (strcmp (name, "stringtable") == 0)
+    return &output_format_stringtable;
+  if (strcmp (name, "binary") == 0)
+    return &output_format_binary;
+
+  error (EXIT_FAILURE, 0, _("output format '%s' unknown"), name);
+  /* NOTREACHED */
+  return NULL;
+}
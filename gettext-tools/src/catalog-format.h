@@ -0,0 +1,47 @@
+/* Lookup of catalog file formats by name.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _CATALOG_FORMAT_H
+#define _CATALOG_FORMAT_H
+
+#include "read-catalog-abstract.h"
+#include "write-catalog.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Return the input format with the given NAME, as given in an
+   --input-format option: "po", "properties", "stringtable", "binary" or
+   "profile".  Signal a fatal error if NAME is unknown.  */
+extern catalog_input_format_ty
+       catalog_input_format_by_name (const char *name);
+
+/* Return the output format with the given NAME, as given in an
+   --output-format option: "po", "properties", "stringtable" or "binary".
+   Signal a fatal error if NAME is unknown.  */
+extern catalog_output_format_ty
+       catalog_output_format_by_name (const char *name);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* _CATALOG_FORMAT_H */
@@ -0,0 +1,940 @@
+/* Search index of a translation catalog.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "catalog-index.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
+/* This include file describes the binary catalog format.  */
+#include "binary-catalog.h"
+
+#include "error.h"
+#include "fwriteerror.h"
+#include "hash.h"
+#include "read-binary.h"
+#include "read-catalog.h"
+#include "write-binary.h"
+#include "xalloc.h"
+#include "xvasprintf.h"
+#include "gettext.h"
+
+#define _(str) gettext (str)
+
+
+/* An index file consists of
+     - a complete catalog in binary intermediate format, see
+       binary-catalog.h, whose messages are numbered from 0 across all
+       domains,
+     - the tables described below,
+     - a trailer of TRAILER_WORDS 32-bit words, followed by the magic bytes
+       INDEX_MAGIC.
+   Since the binary catalog reader ignores what follows the domains, the
+   index file can also be read as a binary catalog.
+
+   All words are unsigned 32-bit numbers in little-endian byte order.
+   Offsets are counted from the beginning of the file.  Names are stored as
+   NUL terminated strings.
+
+   The tables are
+     - the domain table: for each domain, the offset of its name, the number
+       of its first message and the number of its messages,
+     - the header table: the numbers of the header entries,
+     - the file table: for each file name that occurs in a file position,
+       the offset of the name, the index of its postings and the number of
+       postings,
+     - the key table, sorted by key: for each key, the index of its
+       postings and the number of postings,
+     - the postings: sorted lists of message numbers.
+
+   A key describes a trigram, that is, a sequence of 3 bytes in a field of
+   a message, in the form (field << 24) | (byte0 << 16) | (byte1 << 8) |
+   byte2, with ASCII letters converted to lowercase.  A string of 3 or more
+   bytes can only occur in the messages that contain all of its
+   trigrams.  Since patterns never contain newlines, trigrams with a newline
+   or a NUL byte are not indexed.  */
+
+#define INDEX_MAGIC "\223GNUidx\n"
+#define INDEX_MAGIC_LENGTH 8
+#define INDEX_VERSION 1
+
+/* The words of the trailer.  */
+enum
+{
+  TRAILER_CATALOG_LENGTH,
+  TRAILER_MESSAGE_COUNT,
+  TRAILER_SOURCE_SIZE_LOW,
+  TRAILER_SOURCE_SIZE_HIGH,
+  TRAILER_SOURCE_MTIME_LOW,
+  TRAILER_SOURCE_MTIME_HIGH,
+  TRAILER_DOMAIN_COUNT,
+  TRAILER_DOMAIN_OFFSET,
+  TRAILER_HEADER_COUNT,
+  TRAILER_HEADER_OFFSET,
+  TRAILER_FILE_COUNT,
+  TRAILER_FILE_OFFSET,
+  TRAILER_KEY_COUNT,
+  TRAILER_KEY_OFFSET,
+  TRAILER_POSTINGS_OFFSET,
+  TRAILER_VERSION,
+  TRAILER_WORDS
+};
+
+#define TRAILER_SIZE (TRAILER_WORDS * 4 + INDEX_MAGIC_LENGTH)
+
+
+static inline unsigned char
+to_lower (unsigned char c)
+{
+  return (c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+}
+
+static inline uint32_t
+trigram_key (enum catalog_index_field field, const char *p)
+{
+  return ((uint32_t) field << 24)
+         | ((uint32_t) to_lower (p[0]) << 16)
+         | ((uint32_t) to_lower (p[1]) << 8)
+         | (uint32_t) to_lower (p[2]);
+}
+
+static inline uint32_t
+get_word (const char *p)
+{
+  const unsigned char *q = (const unsigned char *) p;
+
+  return (uint32_t) q[0] | ((uint32_t) q[1] << 8) | ((uint32_t) q[2] << 16)
+         | ((uint32_t) q[3] << 24);
+}
+
+
+/* ========================= Writing an index file ========================= */
+
+/* A growing sequence of bytes.  */
+struct byte_buffer
+{
+  char *data;
+  size_t length;
+  size_t allocated;
+};
+
+static void
+put_bytes (struct byte_buffer *bp, const char *s, size_t n)
+{
+  if (bp->length + n > bp->allocated)
+    {
+      bp->allocated = 2 * bp->allocated + n + 4096;
+      bp->data = (char *) xrealloc (bp->data, bp->allocated);
+    }
+  memcpy (bp->data + bp->length, s, n);
+  bp->length += n;
+}
+
+static void
+put_word (struct byte_buffer *bp, size_t value)
+{
+  char buf[4];
+
+  buf[0] = value & 0xff;
+  buf[1] = (value >> 8) & 0xff;
+  buf[2] = (value >> 16) & 0xff;
+  buf[3] = (value >> 24) & 0xff;
+  put_bytes (bp, buf, 4);
+}
+
+/* Store the string S and return its offset in the file, given that the
+   buffer starts at BASE.  */
+static size_t
+put_name (struct byte_buffer *bp, size_t base, const char *s)
+{
+  size_t offset = base + bp->length;
+
+  put_bytes (bp, s, strlen (s) + 1);
+  return offset;
+}
+
+/* A growing sequence of 32-bit numbers.  */
+struct word_list
+{
+  uint32_t *item;
+  size_t nitems;
+  size_t nitems_max;
+};
+
+static inline void
+word_list_append (struct word_list *wlp, uint32_t value)
+{
+  if (wlp->nitems == wlp->nitems_max)
+    {
+      wlp->nitems_max = 2 * wlp->nitems_max + 16;
+      wlp->item =
+        (uint32_t *) xrealloc (wlp->item, wlp->nitems_max * sizeof (uint32_t));
+    }
+  wlp->item[wlp->nitems++] = value;
+}
+
+/* The occurrence of a key in a message.  */
+struct occurrence
+{
+  uint32_t key;
+  uint32_t message;
+};
+
+static int
+compare_words (const void *p1, const void *p2)
+{
+  uint32_t w1 = *(const uint32_t *) p1;
+  uint32_t w2 = *(const uint32_t *) p2;
+
+  return (w1 > w2) - (w1 < w2);
+}
+
+static int
+compare_occurrences (const void *p1, const void *p2)
+{
+  const struct occurrence *o1 = (const struct occurrence *) p1;
+  const struct occurrence *o2 = (const struct occurrence *) p2;
+
+  if (o1->key != o2->key)
+    return (o1->key > o2->key) - (o1->key < o2->key);
+  return (o1->message > o2->message) - (o1->message < o2->message);
+}
+
+/* Add the keys of the string S of length N in FIELD to KEYS.  */
+static void
+add_keys (struct word_list *keys, enum catalog_index_field field,
+          const char *s, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i + 3 <= n; i++)
+    {
+      const char *p = s + i;
+
+      if (p[0] == '\n' || p[1] == '\n' || p[2] == '\n')
+        continue;
+      if (p[0] == '\0' || p[1] == '\0' || p[2] == '\0')
+        continue;
+      word_list_append (keys, trigram_key (field, p));
+    }
+}
+
+static void
+add_string_list_keys (struct word_list *keys, enum catalog_index_field field,
+                      const string_list_ty *slp)
+{
+  size_t j;
+
+  if (slp != NULL)
+    for (j = 0; j < slp->nitems; j++)
+      add_keys (keys, field, slp->item[j], strlen (slp->item[j]));
+}
+
+void
+catalog_index_write (msgdomain_list_ty *mdlp,
+                     const struct stat *source_status,
+                     const char *filename)
+{
+  char *catalog;
+  size_t catalog_length;
+  struct byte_buffer tables;
+  struct word_list headers;
+  struct word_list keys;
+  struct occurrence *occurrences;
+  size_t noccurrences;
+  size_t noccurrences_max;
+  hash_table file_map;
+  const char **file_names;
+  struct word_list *file_messages;
+  size_t nfiles;
+  size_t nfiles_max;
+  struct word_list postings;
+  size_t message_count;
+  size_t domain_offset, header_offset, file_offset, key_offset;
+  size_t postings_offset;
+  size_t nkeys;
+  size_t k, j, i;
+  char *temp_filename;
+  FILE *fp;
+
+  catalog = msgdomain_list_to_binary (mdlp, &catalog_length);
+
+  /* Collect the keys and file names of all messages.  */
+  headers.item = NULL;
+  headers.nitems = headers.nitems_max = 0;
+  keys.item = NULL;
+  keys.nitems = keys.nitems_max = 0;
+  occurrences = NULL;
+  noccurrences = noccurrences_max = 0;
+  hash_init (&file_map, 100);
+  file_names = NULL;
+  file_messages = NULL;
+  nfiles = nfiles_max = 0;
+
+  message_count = 0;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      message_list_ty *mlp = mdlp->item[k]->messages;
+
+      for (j = 0; j < mlp->nitems; j++, message_count++)
+        {
+          const message_ty *mp = mlp->item[j];
+
+          if (is_header (mp))
+            word_list_append (&headers, message_count);
+
+          keys.nitems = 0;
+          if (mp->msgctxt != NULL)
+            add_keys (&keys, catalog_index_msgctxt,
+                      mp->msgctxt, strlen (mp->msgctxt));
+          add_keys (&keys, catalog_index_msgid, mp->msgid, strlen (mp->msgid));
+          if (mp->msgid_plural != NULL)
+            add_keys (&keys, catalog_index_msgid,
+                      mp->msgid_plural, strlen (mp->msgid_plural));
+          add_keys (&keys, catalog_index_msgstr, mp->msgstr, mp->msgstr_len);
+          add_string_list_keys (&keys, catalog_index_comment, mp->comment);
+          add_string_list_keys (&keys, catalog_index_comment_dot,
+                                mp->comment_dot);
+
+          /* Record each key once per message.  */
+          qsort (keys.item, keys.nitems, sizeof (uint32_t), compare_words);
+          for (i = 0; i < keys.nitems; i++)
+            if (i == 0 || keys.item[i] != keys.item[i - 1])
+              {
+                if (noccurrences == noccurrences_max)
+                  {
+                    noccurrences_max = 2 * noccurrences_max + 1024;
+                    occurrences =
+                      (struct occurrence *)
+                      xrealloc (occurrences,
+                                noccurrences_max * sizeof (struct occurrence));
+                  }
+                occurrences[noccurrences].key = keys.item[i];
+                occurrences[noccurrences].message = message_count;
+                noccurrences++;
+              }
+
+          for (i = 0; i < mp->filepos_count; i++)
+            {
+              const char *name = mp->filepos[i].file_name;
+              void *value;
+              size_t n;
+
+              if (hash_find_entry (&file_map, name, strlen (name), &value)
+                  == 0)
+                n = (uintptr_t) value;
+              else
+                {
+                  n = nfiles;
+                  hash_insert_entry (&file_map, name, strlen (name),
+                                     (void *) (uintptr_t) n);
+                  if (nfiles == nfiles_max)
+                    {
+                      nfiles_max = 2 * nfiles_max + 16;
+                      file_names =
+                        (const char **)
+                        xrealloc (file_names,
+                                  nfiles_max * sizeof (const char *));
+                      file_messages =
+                        (struct word_list *)
+                        xrealloc (file_messages,
+                                  nfiles_max * sizeof (struct word_list));
+                    }
+                  file_names[n] = name;
+                  file_messages[n].item = NULL;
+                  file_messages[n].nitems = file_messages[n].nitems_max = 0;
+                  nfiles++;
+                }
+              /* A message can refer to the same file several times.  */
+              if (file_messages[n].nitems == 0
+                  || file_messages[n].item[file_messages[n].nitems - 1]
+                     != message_count)
+                word_list_append (&file_messages[n], message_count);
+            }
+        }
+    }
+
+  qsort (occurrences, noccurrences, sizeof (struct occurrence),
+         compare_occurrences);
+
+  /* The postings of the keys come first, then those of the files.  */
+  postings.item = NULL;
+  postings.nitems = postings.nitems_max = 0;
+  for (i = 0; i < noccurrences; i++)
+    word_list_append (&postings, occurrences[i].message);
+
+  /* Lay out the tables.  */
+  tables.data = NULL;
+  tables.length = 0;
+  tables.allocated = 0;
+
+  {
+    size_t *domain_name_offsets = XNMALLOC (mdlp->nitems + 1, size_t);
+    size_t *file_name_offsets = XNMALLOC (nfiles + 1, size_t);
+    size_t first;
+
+    for (k = 0; k < mdlp->nitems; k++)
+      domain_name_offsets[k] =
+        put_name (&tables, catalog_length, mdlp->item[k]->domain);
+    for (i = 0; i < nfiles; i++)
+      file_name_offsets[i] = put_name (&tables, catalog_length, file_names[i]);
+    /* Align the words, for the convenience of readers that map the file.  */
+    while ((catalog_length + tables.length) % 4 != 0)
+      put_bytes (&tables, "", 1);
+
+    domain_offset = catalog_length + tables.length;
+    first = 0;
+    for (k = 0; k < mdlp->nitems; k++)
+      {
+        size_t count = mdlp->item[k]->messages->nitems;
+
+        put_word (&tables, domain_name_offsets[k]);
+        put_word (&tables, first);
+        put_word (&tables, count);
+        first += count;
+      }
+
+    header_offset = catalog_length + tables.length;
+    for (i = 0; i < headers.nitems; i++)
+      put_word (&tables, headers.item[i]);
+
+    file_offset = catalog_length + tables.length;
+    for (i = 0; i < nfiles; i++)
+      {
+        put_word (&tables, file_name_offsets[i]);
+        put_word (&tables, postings.nitems);
+        put_word (&tables, file_messages[i].nitems);
+        for (j = 0; j < file_messages[i].nitems; j++)
+          word_list_append (&postings, file_messages[i].item[j]);
+      }
+
+    free (file_name_offsets);
+    free (domain_name_offsets);
+  }
+
+  key_offset = catalog_length + tables.length;
+  nkeys = 0;
+  for (i = 0; i < noccurrences; )
+    {
+      size_t end;
+
+      for (end = i + 1;
+           end < noccurrences && occurrences[end].key == occurrences[i].key;
+           end++)
+        ;
+      put_word (&tables, occurrences[i].key);
+      put_word (&tables, i);
+      put_word (&tables, end - i);
+      nkeys++;
+      i = end;
+    }
+
+  postings_offset = catalog_length + tables.length;
+  for (i = 0; i < postings.nitems; i++)
+    put_word (&tables, postings.item[i]);
+
+  /* The trailer.  */
+  if (catalog_length + tables.length + TRAILER_SIZE > 0xffffffffUL)
+    error (EXIT_FAILURE, 0, _("catalog is too large for an index"));
+  put_word (&tables, catalog_length);
+  put_word (&tables, message_count);
+  put_word (&tables, (uint64_t) source_status->st_size & 0xffffffffU);
+  put_word (&tables, (uint64_t) source_status->st_size >> 32);
+  put_word (&tables, (uint64_t) source_status->st_mtime & 0xffffffffU);
+  put_word (&tables, (uint64_t) source_status->st_mtime >> 32);
+  put_word (&tables, mdlp->nitems);
+  put_word (&tables, domain_offset);
+  put_word (&tables, headers.nitems);
+  put_word (&tables, header_offset);
+  put_word (&tables, nfiles);
+  put_word (&tables, file_offset);
+  put_word (&tables, nkeys);
+  put_word (&tables, key_offset);
+  put_word (&tables, postings_offset);
+  put_word (&tables, INDEX_VERSION);
+  put_bytes (&tables, INDEX_MAGIC, INDEX_MAGIC_LENGTH);
+
+  /* Write a temporary file and rename it, so that other processes that
+     read the index at the same time never see a partial file.  */
+  temp_filename = xasprintf ("%s.%lu", filename, (unsigned long) getpid ());
+  fp = fopen (temp_filename, "wb");
+  if (fp == NULL)
+    error (EXIT_FAILURE, errno, _("error while opening \"%s\" for writing"),
+           temp_filename);
+  fwrite (catalog, 1, catalog_length, fp);
+  fwrite (tables.data, 1, tables.length, fp);
+  if (fwriteerror (fp))
+    error (EXIT_FAILURE, errno, _("error while writing \"%s\" file"),
+           temp_filename);
+  if (rename (temp_filename, filename) < 0)
+    {
+      int saved_errno = errno;
+
+      unlink (temp_filename);
+      error (EXIT_FAILURE, saved_errno,
+             _("cannot rename \"%s\" to \"%s\""), temp_filename, filename);
+    }
+  free (temp_filename);
+
+  free (postings.item);
+  for (i = 0; i < nfiles; i++)
+    free (file_messages[i].item);
+  free (file_messages);
+  free (file_names);
+  hash_destroy (&file_map);
+  free (occurrences);
+  free (keys.item);
+  free (headers.item);
+  free (tables.data);
+  free (catalog);
+}
+
+
+/* ========================= Querying an index file ========================= */
+
+struct catalog_index
+{
+  const char *filename;
+  /* The open index file.  It stays open, so that a query sees the same
+     file even if the index is rewritten in the meantime.  */
+  FILE *fp;
+  /* The contents of the file.  */
+  char *data;
+  size_t size;
+  bool mapped;
+  /* Copied from the trailer.  */
+  size_t message_count;
+  size_t domain_count;
+  const char *domains;
+  size_t header_count;
+  const char *headers;
+  size_t file_count;
+  const char *files;
+  size_t key_count;
+  const char *keys;
+  const char *postings;
+  size_t postings_count;
+};
+
+
+/* Return true if the table of COUNT entries of SIZE bytes at OFFSET lies
+   within the tables part of the index file.  */
+static bool
+table_fits (size_t catalog_length, size_t tables_end,
+            size_t offset, size_t count, size_t size)
+{
+  return (offset >= catalog_length && offset <= tables_end
+          && count <= (tables_end - offset) / size);
+}
+
+catalog_index_ty *
+catalog_index_open (const char *filename, const struct stat *source_status)
+{
+  FILE *fp;
+  struct stat statbuf;
+  char *data;
+  size_t size;
+  bool mapped;
+  const char *trailer;
+  size_t catalog_length;
+  size_t tables_end;
+  catalog_index_ty *idx;
+
+  fp = fopen (filename, "rb");
+  if (fp == NULL)
+    return NULL;
+  if (fstat (fileno (fp), &statbuf) < 0 || !S_ISREG (statbuf.st_mode)
+      || statbuf.st_size < TRAILER_SIZE
+      || statbuf.st_size > 0xffffffffUL)
+    {
+      fclose (fp);
+      return NULL;
+    }
+  size = statbuf.st_size;
+
+  mapped = false;
+  data = NULL;
+#if HAVE_MMAP
+  {
+    void *addr = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fileno (fp), 0);
+
+    if (addr != MAP_FAILED)
+      {
+        data = (char *) addr;
+        mapped = true;
+      }
+  }
+#endif
+  if (!mapped)
+    {
+      data = XNMALLOC (size, char);
+      if (fread (data, 1, size, fp) != size)
+        {
+          free (data);
+          fclose (fp);
+          return NULL;
+        }
+    }
+
+  idx = XMALLOC (catalog_index_ty);
+  idx->filename = filename;
+  idx->fp = fp;
+  idx->data = data;
+  idx->size = size;
+  idx->mapped = mapped;
+
+  /* Validate the trailer.  */
+  trailer = data + size - TRAILER_SIZE;
+  if (memcmp (trailer + TRAILER_WORDS * 4, INDEX_MAGIC, INDEX_MAGIC_LENGTH)
+      != 0
+      || get_word (trailer + 4 * TRAILER_VERSION) != INDEX_VERSION)
+    goto invalid;
+  catalog_length = get_word (trailer + 4 * TRAILER_CATALOG_LENGTH);
+  tables_end = size - TRAILER_SIZE;
+  if (catalog_length > tables_end
+      || catalog_length < BINARY_CATALOG_MAGIC_LENGTH
+      || memcmp (data, BINARY_CATALOG_MAGIC, BINARY_CATALOG_MAGIC_LENGTH) != 0)
+    goto invalid;
+
+  /* Check that the index is up to date.  */
+  if (get_word (trailer + 4 * TRAILER_SOURCE_SIZE_LOW)
+      != ((uint64_t) source_status->st_size & 0xffffffffU)
+      || get_word (trailer + 4 * TRAILER_SOURCE_SIZE_HIGH)
+         != ((uint64_t) source_status->st_size >> 32)
+      || get_word (trailer + 4 * TRAILER_SOURCE_MTIME_LOW)
+         != ((uint64_t) source_status->st_mtime & 0xffffffffU)
+      || get_word (trailer + 4 * TRAILER_SOURCE_MTIME_HIGH)
+         != ((uint64_t) source_status->st_mtime >> 32))
+    goto invalid;
+
+  idx->message_count = get_word (trailer + 4 * TRAILER_MESSAGE_COUNT);
+  idx->domain_count = get_word (trailer + 4 * TRAILER_DOMAIN_COUNT);
+  idx->header_count = get_word (trailer + 4 * TRAILER_HEADER_COUNT);
+  idx->file_count = get_word (trailer + 4 * TRAILER_FILE_COUNT);
+  idx->key_count = get_word (trailer + 4 * TRAILER_KEY_COUNT);
+  {
+    size_t domain_offset = get_word (trailer + 4 * TRAILER_DOMAIN_OFFSET);
+    size_t header_offset = get_word (trailer + 4 * TRAILER_HEADER_OFFSET);
+    size_t file_offset = get_word (trailer + 4 * TRAILER_FILE_OFFSET);
+    size_t key_offset = get_word (trailer + 4 * TRAILER_KEY_OFFSET);
+    size_t postings_offset = get_word (trailer + 4 * TRAILER_POSTINGS_OFFSET);
+
+    if (!(table_fits (catalog_length, tables_end,
+                      domain_offset, idx->domain_count, 12)
+          && table_fits (catalog_length, tables_end,
+                         header_offset, idx->header_count, 4)
+          && table_fits (catalog_length, tables_end,
+                         file_offset, idx->file_count, 12)
+          && table_fits (catalog_length, tables_end,
+                         key_offset, idx->key_count, 12)
+          && table_fits (catalog_length, tables_end,
+                         postings_offset, 0, 4)))
+      goto invalid;
+    idx->domains = data + domain_offset;
+    idx->headers = data + header_offset;
+    idx->files = data + file_offset;
+    idx->keys = data + key_offset;
+    idx->postings = data + postings_offset;
+    idx->postings_count = (tables_end - postings_offset) / 4;
+  }
+
+  return idx;
+
+ invalid:
+  catalog_index_close (idx);
+  return NULL;
+}
+
+
+size_t
+catalog_index_message_count (const catalog_index_ty *idx)
+{
+  return idx->message_count;
+}
+
+
+/* Return the postings list that starts at index START and has COUNT
+   entries, or NULL if it lies outside the postings table.  */
+static const char *
+get_postings (const catalog_index_ty *idx, size_t start, size_t count)
+{
+  if (start > idx->postings_count || count > idx->postings_count - start)
+    return NULL;
+  return idx->postings + 4 * start;
+}
+
+/* Mark the COUNT messages listed at POSTINGS in SELECTION.  */
+static void
+mark_postings (const catalog_index_ty *idx, const char *postings,
+               size_t count, bool *selection)
+{
+  size_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      size_t message = get_word (postings + 4 * i);
+
+      if (message < idx->message_count)
+        selection[message] = true;
+    }
+}
+
+/* Return true if the sorted postings list at POSTINGS, with COUNT entries,
+   contains MESSAGE.  */
+static bool
+postings_contain (const char *postings, size_t count, uint32_t message)
+{
+  size_t lo = 0;
+  size_t hi = count;
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      uint32_t w = get_word (postings + 4 * mid);
+
+      if (w == message)
+        return true;
+      if (w < message)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return false;
+}
+
+/* Look up KEY.  Return the number of messages that contain it, and their
+   postings list in *POSTINGSP.  */
+static size_t
+lookup_key (const catalog_index_ty *idx, uint32_t key, const char **postingsp)
+{
+  size_t lo = 0;
+  size_t hi = idx->key_count;
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      const char *entry = idx->keys + 12 * mid;
+      uint32_t w = get_word (entry);
+
+      if (w == key)
+        {
+          size_t count = get_word (entry + 8);
+
+          *postingsp = get_postings (idx, get_word (entry + 4), count);
+          return (*postingsp != NULL ? count : 0);
+        }
+      if (w < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return 0;
+}
+
+bool
+catalog_index_mark_substring (const catalog_index_ty *idx,
+                              enum catalog_index_field field,
+                              const char *s, size_t n,
+                              bool case_insensitive, bool *selection)
+{
+  size_t ntrigrams;
+  const char **lists;
+  size_t *counts;
+  size_t shortest;
+  size_t i, j;
+
+  if (n < 3)
+    return false;
+  for (i = 0; i < n; i++)
+    {
+      /* Keys exist only for trigrams without newlines and NUL bytes.  */
+      if (s[i] == '\n' || s[i] == '\0')
+        return false;
+      /* The matchers may ignore the case of non-ASCII characters, which the
+         keys don't.  */
+      if (case_insensitive && (unsigned char) s[i] >= 0x80)
+        return false;
+    }
+
+  ntrigrams = n - 2;
+  lists = XNMALLOC (ntrigrams, const char *);
+  counts = XNMALLOC (ntrigrams, size_t);
+  shortest = 0;
+  for (i = 0; i < ntrigrams; i++)
+    {
+      counts[i] = lookup_key (idx, trigram_key (field, s + i), &lists[i]);
+      if (counts[i] == 0)
+        {
+          /* No message contains this trigram.  */
+          free (counts);
+          free (lists);
+          return true;
+        }
+      if (counts[i] < counts[shortest])
+        shortest = i;
+    }
+
+  /* Intersect the postings lists, starting from the shortest one.  */
+  for (j = 0; j < counts[shortest]; j++)
+    {
+      uint32_t message = get_word (lists[shortest] + 4 * j);
+
+      for (i = 0; i < ntrigrams; i++)
+        if (i != shortest && !postings_contain (lists[i], counts[i], message))
+          break;
+      if (i == ntrigrams && message < idx->message_count)
+        selection[message] = true;
+    }
+
+  free (counts);
+  free (lists);
+  return true;
+}
+
+
+/* Return the NUL terminated string at OFFSET, or NULL if it is invalid.  */
+static const char *
+get_name (const catalog_index_ty *idx, size_t offset)
+{
+  if (offset >= idx->size
+      || memchr (idx->data + offset, '\0', idx->size - offset) == NULL)
+    return NULL;
+  return idx->data + offset;
+}
+
+void
+catalog_index_mark_location (const catalog_index_ty *idx,
+                             bool (*predicate) (const char *file_name),
+                             bool *selection)
+{
+  size_t i;
+
+  for (i = 0; i < idx->file_count; i++)
+    {
+      const char *entry = idx->files + 12 * i;
+      const char *name = get_name (idx, get_word (entry));
+
+      if (name != NULL && predicate (name))
+        {
+          size_t count = get_word (entry + 8);
+          const char *postings =
+            get_postings (idx, get_word (entry + 4), count);
+
+          if (postings != NULL)
+            mark_postings (idx, postings, count, selection);
+        }
+    }
+}
+
+
+void
+catalog_index_mark_domain (const catalog_index_ty *idx,
+                           const char *domain, bool *selection)
+{
+  size_t k;
+
+  for (k = 0; k < idx->domain_count; k++)
+    {
+      const char *entry = idx->domains + 12 * k;
+      const char *name = get_name (idx, get_word (entry));
+
+      if (name != NULL && strcmp (name, domain) == 0)
+        {
+          size_t first = get_word (entry + 4);
+          size_t count = get_word (entry + 8);
+          size_t j;
+
+          for (j = first; j < first + count && j < idx->message_count; j++)
+            selection[j] = true;
+        }
+    }
+}
+
+
+void
+catalog_index_mark_headers (const catalog_index_ty *idx, bool *selection)
+{
+  mark_postings (idx, idx->headers, idx->header_count, selection);
+}
+
+
+msgdomain_list_ty *
+catalog_index_read (catalog_index_ty *idx, const bool *selection)
+{
+  msgdomain_list_ty *mdlp;
+
+  rewind (idx->fp);
+  binary_catalog_selection = selection;
+  mdlp = read_catalog_stream (idx->fp, idx->filename, idx->filename,
+                              &input_format_binary);
+  binary_catalog_selection = NULL;
+
+  /* The reader creates a domain only when it passes on a message of it.
+     Add the domains without selected messages, and restore the order of
+     the domains.  */
+  {
+    size_t n = 0;
+    size_t k, j;
+
+    for (k = 0; k < idx->domain_count; k++)
+      {
+        const char *name = get_name (idx, get_word (idx->domains + 12 * k));
+
+        if (name == NULL)
+          continue;
+        if (msgdomain_list_sublist (mdlp, name, false) == NULL)
+          msgdomain_list_sublist (mdlp, xstrdup (name), true);
+        for (j = n; j < mdlp->nitems; j++)
+          if (strcmp (mdlp->item[j]->domain, name) == 0)
+            {
+              msgdomain_ty *mdp = mdlp->item[j];
+
+              memmove (&mdlp->item[n + 1], &mdlp->item[n],
+                       (j - n) * sizeof (msgdomain_ty *));
+              mdlp->item[n++] = mdp;
+              break;
+            }
+      }
+  }
+
+  return mdlp;
+}
+
+
+void
+catalog_index_close (catalog_index_ty *idx)
+{
+#if HAVE_MMAP
+  if (idx->mapped)
+    munmap (idx->data, idx->size);
+  else
+#endif
+    free (idx->data);
+  fclose (idx->fp);
+  free (idx);
+}
@@ -0,0 +1,112 @@
+/* Search index of a translation catalog.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _CATALOG_INDEX_H
+#define _CATALOG_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "message.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* A catalog index is a file that contains a catalog in binary intermediate
+   format, followed by tables that tell which messages may contain a given
+   string or come from a given source file.  A query marks the candidate
+   messages and then decodes only these; the caller still has to test the
+   decoded messages, since the tables yield a superset of the matches.  */
+
+/* The fields of a message that are indexed.  The values are the same as
+   msggrep's grep pass numbers.  */
+enum catalog_index_field
+{
+  catalog_index_msgctxt = 0,
+  catalog_index_msgid = 1,      /* msgid and msgid_plural */
+  catalog_index_msgstr = 2,     /* all plural forms */
+  catalog_index_comment = 3,
+  catalog_index_comment_dot = 4
+};
+
+typedef struct catalog_index catalog_index_ty;
+
+/* Write an index of MDLP, which was read from a file with status
+   *SOURCE_STATUS, to the file FILENAME.  */
+extern void
+       catalog_index_write (msgdomain_list_ty *mdlp,
+                            const struct stat *source_status,
+                            const char *filename);
+
+/* Open the index file FILENAME.  Return NULL if it does not exist, is not
+   a valid index, or was made from a file that differs in size or
+   modification time from *SOURCE_STATUS.  */
+extern catalog_index_ty *
+       catalog_index_open (const char *filename,
+                           const struct stat *source_status);
+
+/* Return the number of messages in the index, i.e. the size of the
+   selection arrays passed to the functions below.  */
+extern size_t
+       catalog_index_message_count (const catalog_index_ty *idx);
+
+/* Mark in SELECTION the messages whose FIELD may contain the string S of
+   length N.  Return false if the index cannot narrow down the search for
+   this string; then the caller has to consider all messages.  */
+extern bool
+       catalog_index_mark_substring (const catalog_index_ty *idx,
+                                     enum catalog_index_field field,
+                                     const char *s, size_t n,
+                                     bool case_insensitive, bool *selection);
+
+/* Mark in SELECTION the messages that have a file position in a file
+   whose name satisfies PREDICATE.  */
+extern void
+       catalog_index_mark_location (const catalog_index_ty *idx,
+                                    bool (*predicate) (const char *file_name),
+                                    bool *selection);
+
+/* Mark in SELECTION the messages of the domain DOMAIN.  */
+extern void
+       catalog_index_mark_domain (const catalog_index_ty *idx,
+                                  const char *domain, bool *selection);
+
+/* Mark in SELECTION the header entries.  */
+extern void
+       catalog_index_mark_headers (const catalog_index_ty *idx,
+                                   bool *selection);
+
+/* Read the messages marked in SELECTION from the index.  All domains are
+   returned, even if none of their messages is selected.  */
+extern msgdomain_list_ty *
+       catalog_index_read (catalog_index_ty *idx, const bool *selection);
+
+/* Close the index.  */
+extern void
+       catalog_index_close (catalog_index_ty *idx);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* _CATALOG_INDEX_H */
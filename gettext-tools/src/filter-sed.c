@@ -0,0 +1,592 @@
+/* In-process execution of simple sed scripts.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "filters.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <regex.h>
+#include <wchar.h>
+
+#include "error.h"
+#include "xalloc.h"
+#include "gettext.h"
+
+#define _(str) gettext (str)
+
+
+/* The built-in filter understands sed scripts that consist only of the
+   commands
+     s/REGEXP/REPLACEMENT/FLAGS     where FLAGS is empty, 'g', a number,
+                                    or a number and 'g',
+     y/SOURCE-CHARS/DEST-CHARS/     where the characters are ASCII,
+   without addresses, separated by ';' or newlines.  It applies them to each
+   line of the input, like sed does.  For everything else, the real 'sed'
+   program is used.  */
+
+/* A piece of the replacement of an 's' command.  */
+struct replacement_piece
+{
+  /* -1 for literal text, otherwise the number of the subexpression whose
+     match is inserted (0 for the entire match).  */
+  int group;
+  const char *text;
+  size_t text_len;
+};
+
+struct sed_command
+{
+  char cmd;
+
+  /* For the 's' command.  */
+  struct re_pattern_buffer pattern;
+  struct re_registers regs;
+  struct replacement_piece *pieces;
+  size_t npieces;
+  bool global;
+  size_t occurrence;
+
+  /* For the 'y' command.  */
+  unsigned char map[256];
+};
+
+static struct sed_command *commands;
+static size_t ncommands;
+static size_t ncommands_allocated;
+
+
+/* Return the length of the character at P, which is before END.  */
+static size_t
+char_length (const char *p, const char *end)
+{
+  if (MB_CUR_MAX > 1)
+    {
+      mbstate_t state;
+      size_t n;
+
+      memset (&state, '\0', sizeof (mbstate_t));
+      n = mbrlen (p, end - p, &state);
+      if (n != (size_t)(-1) && n != (size_t)(-2) && n != 0)
+        return n;
+    }
+  return 1;
+}
+
+/* Parse the part of an 's' or 'y' command that starts at *SP and ends with
+   the unescaped delimiter DELIM.  Return it, freshly allocated, with its
+   length in *LENGTHP, and advance *SP past the delimiter.  In KEEP_ESCAPES
+   mode, backslash sequences other than \DELIM and \n are retained.
+   Return NULL if the delimiter is missing or a backslash sequence is not
+   supported.  */
+static char *
+parse_part (const char **sp, char delim, bool keep_escapes, size_t *lengthp)
+{
+  const char *s = *sp;
+  char *result = XNMALLOC (strlen (s) + 1, char);
+  char *q = result;
+
+  for (;;)
+    {
+      if (*s == '\0')
+        {
+          free (result);
+          return NULL;
+        }
+      if (*s == delim)
+        break;
+      if (*s == '\\')
+        {
+          s++;
+          if (*s == '\0')
+            {
+              free (result);
+              return NULL;
+            }
+          if (*s == delim)
+            *q++ = delim;
+          else if (*s == 'n')
+            *q++ = '\n';
+          else if (*s == '\n')
+            *q++ = '\n';
+          else if (keep_escapes)
+            {
+              *q++ = '\\';
+              *q++ = *s;
+            }
+          else if (*s == '\\')
+            *q++ = '\\';
+          else
+            {
+              free (result);
+              return NULL;
+            }
+          s++;
+        }
+      else
+        *q++ = *s++;
+    }
+
+  *sp = s + 1;
+  *lengthp = q - result;
+  return result;
+}
+
+/* Parse the replacement of an 's' command, given with backslash sequences
+   intact, into CMD.  Return false if it is not supported.  */
+static bool
+parse_replacement (struct sed_command *cmd, const char *repl, size_t repl_len)
+{
+  /* The literal pieces point into TEXT, which is never freed.  */
+  char *text = XNMALLOC (repl_len + 1, char);
+  char *q = text;
+  const char *p = repl;
+  const char *pend = repl + repl_len;
+  const char *literal_start = q;
+
+  cmd->pieces = XNMALLOC (repl_len + 1, struct replacement_piece);
+  cmd->npieces = 0;
+
+  while (p < pend)
+    {
+      int group = -1;
+
+      if (*p == '&')
+        {
+          group = 0;
+          p++;
+        }
+      else if (*p == '\\' && p + 1 < pend)
+        {
+          char c = p[1];
+
+          p += 2;
+          if (c >= '0' && c <= '9'
+              && (size_t) (c - '0') <= cmd->pattern.re_nsub)
+            group = c - '0';
+          else if (c == '&' || c == '\\')
+            *q++ = c;
+          else
+            {
+              /* Invalid references, and other escapes, such as GNU sed's
+                 \L or \U, are not supported.  */
+              free (cmd->pieces);
+              free (text);
+              return false;
+            }
+        }
+      else
+        *q++ = *p++;
+
+      if (group >= 0)
+        {
+          if (q > literal_start)
+            {
+              cmd->pieces[cmd->npieces].group = -1;
+              cmd->pieces[cmd->npieces].text = literal_start;
+              cmd->pieces[cmd->npieces].text_len = q - literal_start;
+              cmd->npieces++;
+            }
+          cmd->pieces[cmd->npieces].group = group;
+          cmd->npieces++;
+          literal_start = q;
+        }
+    }
+  if (q > literal_start)
+    {
+      cmd->pieces[cmd->npieces].group = -1;
+      cmd->pieces[cmd->npieces].text = literal_start;
+      cmd->pieces[cmd->npieces].text_len = q - literal_start;
+      cmd->npieces++;
+    }
+  return true;
+}
+
+/* Parse a sed script SCRIPT and append its commands to the list.
+   Return false if it contains something that is not supported.  */
+static bool
+parse_script (const char *script, bool extended)
+{
+  const char *s = script;
+
+  for (;;)
+    {
+      struct sed_command *cmd;
+      char delim;
+
+      while (*s == ' ' || *s == '\t' || *s == '\n' || *s == ';')
+        s++;
+      if (*s == '\0')
+        return true;
+
+      if (!(*s == 's' || *s == 'y'))
+        return false;
+      delim = s[1];
+      if (delim == '\0' || delim == '\\' || delim == '\n' || delim == '&')
+        return false;
+
+      if (ncommands == ncommands_allocated)
+        {
+          ncommands_allocated = 2 * ncommands_allocated + 1;
+          commands = (struct sed_command *)
+            xrealloc (commands,
+                      ncommands_allocated * sizeof (struct sed_command));
+        }
+      cmd = &commands[ncommands];
+      memset (cmd, '\0', sizeof (struct sed_command));
+      cmd->cmd = *s;
+      s += 2;
+
+      if (cmd->cmd == 's')
+        {
+          char *regexp;
+          size_t regexp_len;
+          char *repl;
+          size_t repl_len;
+          const char *err;
+
+          regexp = parse_part (&s, delim, true, &regexp_len);
+          if (regexp == NULL)
+            return false;
+          /* An empty regular expression stands for the last one used.  */
+          if (regexp_len == 0)
+            {
+              free (regexp);
+              return false;
+            }
+          repl = parse_part (&s, delim, true, &repl_len);
+          if (repl == NULL)
+            {
+              free (regexp);
+              return false;
+            }
+
+          re_set_syntax (extended
+                         ? RE_SYNTAX_POSIX_EXTENDED
+                         : RE_SYNTAX_POSIX_BASIC
+                           & ~RE_UNMATCHED_RIGHT_PAREN_ORD);
+          cmd->pattern.fastmap = XNMALLOC (256, char);
+          err = re_compile_pattern (regexp, regexp_len, &cmd->pattern);
+          free (regexp);
+          if (err != NULL)
+            {
+              /* Let sed report the error.  */
+              free (repl);
+              return false;
+            }
+
+          if (!parse_replacement (cmd, repl, repl_len))
+            {
+              free (repl);
+              return false;
+            }
+          free (repl);
+
+          /* Parse the flags.  */
+          cmd->occurrence = 1;
+          if (*s >= '1' && *s <= '9')
+            {
+              cmd->occurrence = 0;
+              while (*s >= '0' && *s <= '9')
+                cmd->occurrence = 10 * cmd->occurrence + (*s++ - '0');
+            }
+          if (*s == 'g')
+            {
+              cmd->global = true;
+              s++;
+            }
+        }
+      else
+        {
+          char *source;
+          size_t source_len;
+          char *dest;
+          size_t dest_len;
+          bool seen[256];
+          size_t i;
+
+          source = parse_part (&s, delim, false, &source_len);
+          if (source == NULL)
+            return false;
+          dest = parse_part (&s, delim, false, &dest_len);
+          if (dest == NULL)
+            {
+              free (source);
+              return false;
+            }
+          if (source_len != dest_len)
+            {
+              free (source);
+              free (dest);
+              return false;
+            }
+
+          for (i = 0; i < 256; i++)
+            {
+              cmd->map[i] = i;
+              seen[i] = false;
+            }
+          for (i = 0; i < source_len; i++)
+            {
+              unsigned char c = source[i];
+              unsigned char d = dest[i];
+
+              /* Non-ASCII characters may be multibyte characters.  */
+              if (c >= 0x80 || d >= 0x80 || seen[c])
+                {
+                  free (source);
+                  free (dest);
+                  return false;
+                }
+              seen[c] = true;
+              cmd->map[c] = d;
+            }
+          free (source);
+          free (dest);
+        }
+
+      ncommands++;
+
+      while (*s == ' ' || *s == '\t')
+        s++;
+      if (!(*s == '\0' || *s == ';' || *s == '\n'))
+        return false;
+    }
+}
+
+
+bool
+sed_filter_compile (int argc, const char **argv)
+{
+  const char *scripts_given = NULL;
+  const char *plain_script = NULL;
+  bool extended = false;
+  int i;
+
+  /* Parse the options.  Accept only -e SCRIPT, -E and -r.  */
+  for (i = 1; i < argc; i++)
+    {
+      const char *arg = argv[i];
+
+      if (strcmp (arg, "-e") == 0 && i + 1 < argc)
+        {
+          scripts_given = arg;
+          i++;
+        }
+      else if (strcmp (arg, "-E") == 0 || strcmp (arg, "-r") == 0
+               || strcmp (arg, "--regexp-extended") == 0)
+        extended = true;
+      else if (arg[0] == '-')
+        return false;
+      else if (plain_script == NULL)
+        plain_script = arg;
+      else
+        /* Input files.  */
+        return false;
+    }
+  if (scripts_given != NULL ? plain_script != NULL : plain_script == NULL)
+    return false;
+
+  /* Parse the scripts.  */
+  ncommands = 0;
+  if (plain_script != NULL)
+    return parse_script (plain_script, extended);
+  for (i = 1; i < argc; i++)
+    if (strcmp (argv[i], "-e") == 0)
+      {
+        /* Each -e option is a separate line of the script.  */
+        if (!parse_script (argv[++i], extended))
+          return false;
+      }
+  return true;
+}
+
+
+/* Buffers for a line and its modified copy.  */
+static char *line;
+static size_t line_len;
+static size_t line_allocated;
+static char *buffer;
+static size_t buffer_len;
+static size_t buffer_allocated;
+
+static inline void
+buffer_append (const char *s, size_t n)
+{
+  if (buffer_len + n > buffer_allocated)
+    {
+      buffer_allocated = 2 * buffer_allocated + n;
+      buffer = (char *) xrealloc (buffer, buffer_allocated);
+    }
+  memcpy (buffer + buffer_len, s, n);
+  buffer_len += n;
+}
+
+/* Execute the 's' command CMD on the line.  */
+static void
+substitute (struct sed_command *cmd)
+{
+  regoff_t start = 0;
+  regoff_t copied = 0;
+  regoff_t prev_end = -1;
+  size_t count = 0;
+  bool replaced = false;
+
+  buffer_len = 0;
+  while (start <= (regoff_t) line_len)
+    {
+      regoff_t pos = re_search (&cmd->pattern, line, line_len,
+                                start, line_len - start, &cmd->regs);
+      regoff_t end;
+
+      if (pos < 0)
+        {
+          if (pos == -2)
+            error (EXIT_FAILURE, 0, _("regular expression matching failed"));
+          break;
+        }
+      end = cmd->regs.end[0];
+
+      /* An empty match right after the previous match does not count.  */
+      if (!(end == pos && pos == prev_end))
+        {
+          count++;
+          if (count >= cmd->occurrence)
+            {
+              size_t k;
+
+              buffer_append (line + copied, pos - copied);
+              for (k = 0; k < cmd->npieces; k++)
+                {
+                  const struct replacement_piece *piece = &cmd->pieces[k];
+
+                  if (piece->group < 0)
+                    buffer_append (piece->text, piece->text_len);
+                  else if (cmd->regs.start[piece->group] >= 0)
+                    buffer_append (line + cmd->regs.start[piece->group],
+                                   cmd->regs.end[piece->group]
+                                   - cmd->regs.start[piece->group]);
+                }
+              copied = end;
+              replaced = true;
+              if (!cmd->global)
+                break;
+            }
+        }
+      prev_end = end;
+
+      if (end > pos)
+        start = end;
+      else if (pos < (regoff_t) line_len)
+        start = pos + char_length (line + pos, line + line_len);
+      else
+        break;
+    }
+
+  if (replaced)
+    {
+      char *tmp;
+      size_t tmp_allocated;
+
+      buffer_append (line + copied, line_len - copied);
+
+      /* Swap the buffers.  */
+      tmp = line;
+      line = buffer;
+      buffer = tmp;
+      tmp_allocated = line_allocated;
+      line_allocated = buffer_allocated;
+      buffer_allocated = tmp_allocated;
+      line_len = buffer_len;
+    }
+}
+
+void
+sed_filter (const char *input, size_t input_len,
+            char **output_p, size_t *output_len_p)
+{
+  const char *input_end = input + input_len;
+  const char *p;
+  size_t allocated = input_len + 1;
+  char *output = XNMALLOC (allocated, char);
+  size_t output_len = 0;
+
+  /* Process each line separately, like sed does.  */
+  for (p = input; p < input_end; )
+    {
+      const char *nl = (const char *) memchr (p, '\n', input_end - p);
+      const char *eol = (nl != NULL ? nl : input_end);
+      size_t k;
+
+      line_len = eol - p;
+      if (line_len > line_allocated)
+        {
+          line_allocated = 2 * line_allocated + line_len;
+          line = (char *) xrealloc (line, line_allocated);
+        }
+      memcpy (line, p, line_len);
+
+      for (k = 0; k < ncommands; k++)
+        {
+          struct sed_command *cmd = &commands[k];
+
+          if (cmd->cmd == 's')
+            substitute (cmd);
+          else if (MB_CUR_MAX == 1)
+            {
+              size_t i;
+
+              for (i = 0; i < line_len; i++)
+                line[i] = cmd->map[(unsigned char) line[i]];
+            }
+          else
+            {
+              /* Map only the single-byte characters.  */
+              char *lp = line;
+              char *lend = line + line_len;
+
+              while (lp < lend)
+                {
+                  size_t n = char_length (lp, lend);
+
+                  if (n == 1)
+                    *lp = cmd->map[(unsigned char) *lp];
+                  lp += n;
+                }
+            }
+        }
+
+      if (output_len + line_len + 1 > allocated)
+        {
+          allocated = 2 * allocated + line_len + 1;
+          output = (char *) xrealloc (output, allocated);
+        }
+      memcpy (output + output_len, line, line_len);
+      output_len += line_len;
+      if (nl != NULL)
+        output[output_len++] = '\n';
+
+      p = (nl != NULL ? nl + 1 : input_end);
+    }
+
+  *output_p = output;
+  *output_len_p = output_len;
+}
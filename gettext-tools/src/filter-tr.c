@@ -0,0 +1,161 @@
+/* In-process execution of simple tr invocations.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "filters.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xalloc.h"
+
+
+/* The built-in filter understands 'tr SET1 SET2', where the sets consist of
+   ASCII characters, ranges 'a-z' and the backslash escapes of POSIX tr.
+   Character classes, equivalence classes, repetitions and options are left
+   to the real 'tr' program.  */
+
+/* The transliteration table.  */
+static unsigned char map[256];
+
+
+/* Expand the set S into the characters of BUF, of size 256.  Return the
+   number of characters, or -1 if S is not supported.  */
+static int
+expand_set (const char *s, unsigned char *buf)
+{
+  int n = 0;
+
+  while (*s != '\0')
+    {
+      unsigned int c;
+
+      if (*s == '[')
+        return -1;
+      if (*s == '\\' && s[1] != '\0')
+        {
+          s++;
+          switch (*s)
+            {
+            case 'a': c = '\a'; s++; break;
+            case 'b': c = '\b'; s++; break;
+            case 'f': c = '\f'; s++; break;
+            case 'n': c = '\n'; s++; break;
+            case 'r': c = '\r'; s++; break;
+            case 't': c = '\t'; s++; break;
+            case 'v': c = '\v'; s++; break;
+            case '0': case '1': case '2': case '3':
+            case '4': case '5': case '6': case '7':
+              {
+                int i;
+
+                c = 0;
+                for (i = 0; i < 3 && *s >= '0' && *s <= '7'; i++)
+                  c = 8 * c + (*s++ - '0');
+              }
+              break;
+            default:
+              c = (unsigned char) *s++;
+              break;
+            }
+        }
+      else
+        c = (unsigned char) *s++;
+
+      /* Non-ASCII characters may be multibyte characters.  */
+      if (c >= 0x80)
+        return -1;
+
+      if (*s == '-' && s[1] != '\0')
+        {
+          /* A range.  */
+          unsigned int last = (unsigned char) s[1];
+
+          if (last == '\\' || last == '[' || last >= 0x80 || last < c)
+            return -1;
+          s += 2;
+          for (; c <= last; c++)
+            {
+              if (n == 256)
+                return -1;
+              buf[n++] = c;
+            }
+        }
+      else
+        {
+          if (n == 256)
+            return -1;
+          buf[n++] = c;
+        }
+    }
+  return n;
+}
+
+
+bool
+tr_filter_compile (int argc, const char **argv)
+{
+  unsigned char set1[256];
+  unsigned char set2[256];
+  bool seen[256];
+  int n1;
+  int n2;
+  int i;
+
+  if (argc != 3 || argv[1][0] == '-' || argv[2][0] == '-')
+    return false;
+  n1 = expand_set (argv[1], set1);
+  n2 = expand_set (argv[2], set2);
+  if (n1 < 0 || n2 <= 0)
+    return false;
+
+  for (i = 0; i < 256; i++)
+    {
+      map[i] = i;
+      seen[i] = false;
+    }
+  for (i = 0; i < n1; i++)
+    {
+      unsigned char c = set1[i];
+
+      /* Implementations differ in which mapping wins.  */
+      if (seen[c])
+        return false;
+      seen[c] = true;
+      /* SET2 is extended by repeating its last character.  */
+      map[c] = set2[i < n2 ? i : n2 - 1];
+    }
+  return true;
+}
+
+
+void
+tr_filter (const char *input, size_t input_len,
+           char **output_p, size_t *output_len_p)
+{
+  char *output = XNMALLOC (input_len + 1, char);
+  size_t i;
+
+  for (i = 0; i < input_len; i++)
+    output[i] = map[(unsigned char) input[i]];
+
+  *output_p = output;
+  *output_len_p = input_len;
+}
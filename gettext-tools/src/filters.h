@@ -14,6 +14,7 @@
    You should have received a copy of the GNU General Public License
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
+#include <stdbool.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -29,6 +30,31 @@ extern "C" {
 extern void serbian_to_latin (const char *input, size_t input_len,
                               char **output_p, size_t *output_len_p);
 
+/* Prepare the in-process execution of 'sed' with the arguments
+   ARGV[1..ARGC-1].  Return true if the script consists only of commands
+   that sed_filter supports, false if the 'sed' program must be run.  */
+extern bool sed_filter_compile (int argc, const char **argv);
+
+/* Apply the sed script prepared by sed_filter_compile to each line of a
+   string INPUT of INPUT_LEN bytes.
+   Store the freshly allocated result in *OUTPUT_P and its length (in bytes)
+   in *OUTPUT_LEN_P.
+   Input and output are in the locale encoding.  */
+extern void sed_filter (const char *input, size_t input_len,
+                        char **output_p, size_t *output_len_p);
+
+/* Prepare the in-process execution of 'tr' with the arguments
+   ARGV[1..ARGC-1].  Return true if the arguments are supported by
+   tr_filter, false if the 'tr' program must be run.  */
+extern bool tr_filter_compile (int argc, const char **argv);
+
+/* Transliterate a string INPUT of INPUT_LEN bytes according to the
+   character sets given to tr_filter_compile.
+   Store the freshly allocated result in *OUTPUT_P and its length (in bytes)
+   in *OUTPUT_LEN_P.  */
+extern void tr_filter (const char *input, size_t input_len,
+                       char **output_p, size_t *output_len_p);
+
 #ifdef __cplusplus
 }
 #endif
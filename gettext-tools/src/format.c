@@ -25,8 +25,11 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "message.h"
+#include "hash.h"
+#include "xalloc.h"
 #include "gettext.h"
 
 #define _(str) gettext (str)
@@ -63,6 +66,136 @@ struct formatstring_parser *formatstring_parsers[NFORMATS] =
   /* format_javascript */       &formatstring_javascript
 };
 
+/* Cache of parsed format strings.  Some msgids, such as "%s: %s", occur
+   in many messages, and most msgstrs have the same format directives as
+   their msgid; each of these strings is parsed only once.  Every thread
+   has its own cache, so that no locking is needed.  */
+struct formatstring_cache_entry
+{
+  size_t format_index;
+  void *descr;
+  char *invalid_reason;
+};
+
+struct formatstring_cache
+{
+  /* One table per format type and per value of 'translated', mapping a
+     string to a struct formatstring_cache_entry.  */
+  hash_table tables[NFORMATS][2];
+  /* The last results that did not fit in the tables.  */
+  struct formatstring_cache_entry uncached[2];
+  size_t nentries;
+  unsigned long int hits;
+  unsigned long int misses;
+  struct formatstring_cache *next;
+};
+
+/* Limit the size of the cache of a thread.  */
+#define FORMATSTRING_CACHE_MAX 100000
+
+/* The caches of all threads.  */
+static struct formatstring_cache *all_formatstring_caches;
+
+/* The cache of the current thread.  */
+static struct formatstring_cache *formatstring_cache;
+#ifdef _OPENMP
+# pragma omp threadprivate (formatstring_cache)
+#endif
+
+void *
+formatstring_parse_cached (size_t i, const char *string, bool translated,
+                           const char **invalid_reason)
+{
+  struct formatstring_cache *cache = formatstring_cache;
+  hash_table *table;
+  size_t length;
+  void *found;
+  struct formatstring_cache_entry *entry;
+
+  if (cache == NULL)
+    {
+      cache = XCALLOC (1, struct formatstring_cache);
+      #ifdef _OPENMP
+       #pragma omp critical (formatstring_cache)
+      #endif
+      {
+        cache->next = all_formatstring_caches;
+        all_formatstring_caches = cache;
+      }
+      formatstring_cache = cache;
+    }
+
+  table = &cache->tables[i][translated];
+  if (table->size == 0)
+    hash_init (table, 100);
+
+  length = strlen (string) + 1;
+  if (hash_find_entry (table, string, length, &found) == 0)
+    {
+      cache->hits++;
+      entry = (struct formatstring_cache_entry *) found;
+    }
+  else
+    {
+      char *reason = NULL;
+      void *descr =
+        formatstring_parsers[i]->parse (string, translated, NULL, &reason);
+
+      cache->misses++;
+      if (cache->nentries < FORMATSTRING_CACHE_MAX)
+        {
+          entry = XMALLOC (struct formatstring_cache_entry);
+          hash_insert_entry (table, string, length, entry);
+          cache->nentries++;
+        }
+      else
+        {
+          /* The cache is full.  Replace the previous uncached result.  */
+          entry = &cache->uncached[translated];
+          if (entry->descr != NULL)
+            formatstring_parsers[entry->format_index]->free (entry->descr);
+          free (entry->invalid_reason);
+        }
+      entry->format_index = i;
+      entry->descr = descr;
+      entry->invalid_reason = reason;
+    }
+
+  *invalid_reason = entry->invalid_reason;
+  return entry->descr;
+}
+
+void
+formatstring_cache_statistics (unsigned long int *hitsp,
+                               unsigned long int *missesp)
+{
+  unsigned long int hits = 0;
+  unsigned long int misses = 0;
+  struct formatstring_cache *cache;
+
+  for (cache = all_formatstring_caches; cache != NULL; cache = cache->next)
+    {
+      hits += cache->hits;
+      misses += cache->misses;
+    }
+  *hitsp = hits;
+  *missesp = misses;
+}
+
+void
+print_formatstring_cache_statistics (void)
+{
+  unsigned long int hits;
+  unsigned long int misses;
+
+  formatstring_cache_statistics (&hits, &misses);
+  if (hits + misses > 0)
+    fprintf (stderr,
+             _("Format string cache: %lu hits, %lu misses, hit rate %.1f%%.\n"),
+             hits, misses, 100.0 * hits / (hits + misses));
+}
+
+
 /* Check whether both formats strings contain compatible format
    specifications for format type i (0 <= i < NFORMATS).  */
 int
@@ -87,10 +220,10 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
         are used by other translations.  */
 
   struct formatstring_parser *parser = formatstring_parsers[i];
-  char *invalid_reason = NULL;
+  const char *invalid_reason = NULL;
   void *msgid_descr =
-    parser->parse (msgid_plural != NULL ? msgid_plural : msgid, false, NULL,
-                   &invalid_reason);
+    formatstring_parse_cached (i, msgid_plural != NULL ? msgid_plural : msgid,
+                               false, &invalid_reason);
 
   if (msgid_descr != NULL)
     {
@@ -113,7 +246,8 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
               pretty_msgstr = buf;
             }
 
-          msgstr_descr = parser->parse (p, true, NULL, &invalid_reason);
+          msgstr_descr = formatstring_parse_cached (i, p, true,
+                                                    &invalid_reason);
 
           if (msgstr_descr != NULL)
             {
@@ -143,8 +277,6 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
                                  strict_checking,
                                  error_logger, pretty_msgid, pretty_msgstr))
                 seen_errors++;
-
-              parser->free (msgstr_descr);
             }
           else
             {
@@ -153,14 +285,9 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
                             pretty_msgstr, format_language_pretty[i],
                             pretty_msgid, invalid_reason);
               seen_errors++;
-              free (invalid_reason);
             }
         }
-
-      parser->free (msgid_descr);
     }
-  else
-    free (invalid_reason);
 
   return seen_errors;
 }
@@ -144,6 +144,27 @@ extern void
    string.  */
 extern unsigned int get_python_format_unnamed_arg_count (const char *string);
 
+/* Parse STRING as a format string of type I (0 <= i < NFORMATS), like
+   formatstring_parsers[i]->parse with fdi = NULL, reusing the result of an
+   earlier call with the same arguments in the same thread.
+   The returned descriptor and *INVALID_REASON belong to the cache and must
+   not be freed nor modified.  They remain valid at least until the next
+   call with the same TRANSLATED argument in the same thread.  */
+extern void *
+       formatstring_parse_cached (size_t i, const char *string,
+                                  bool translated,
+                                  const char **invalid_reason);
+
+/* Return the number of lookups in the caches of formatstring_parse_cached
+   that found, resp. did not find, the string.  */
+extern void
+       formatstring_cache_statistics (unsigned long int *hitsp,
+                                      unsigned long int *missesp);
+
+/* Print the statistics of the caches of formatstring_parse_cached to
+   stderr, if they have been used.  */
+extern void print_formatstring_cache_statistics (void);
+
 /* Check whether both formats strings contain compatible format
    specifications for format type i (0 <= i < NFORMATS).
    Return the number of errors that were seen.  */
@@ -186,7 +186,8 @@ struct message_ty
   bool obsolete;
 
   /* Used for checking that messages have been used, in the msgcmp,
-     msgmerge, msgcomm and msgcat programs.  */
+     msgmerge, msgcomm and msgcat programs, and for marking the selected
+     messages in the msggrep program.  */
   int used;
 
   /* Used for looking up the target message, in the msgcat program.  */
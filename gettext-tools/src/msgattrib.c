@@ -42,6 +42,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "propername.h"
 #include "gettext.h"
@@ -90,6 +91,7 @@ static const struct option long_options[] =
   { "help", no_argument, NULL, 'h' },
   { "ignore-file", required_argument, NULL, CHAR_MAX + 15 },
   { "indent", no_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 21 },
   { "no-escape", no_argument, NULL, 'e' },
   { "no-fuzzy", no_argument, NULL, CHAR_MAX + 3 },
   { "no-location", no_argument, &line_comment, 0 },
@@ -100,6 +102,7 @@ static const struct option long_options[] =
   { "only-fuzzy", no_argument, NULL, CHAR_MAX + 4 },
   { "only-obsolete", no_argument, NULL, CHAR_MAX + 6 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 22 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "set-fuzzy", no_argument, NULL, CHAR_MAX + 7 },
@@ -324,6 +327,14 @@ main (int argc, char **argv)
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 21: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 22: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         /* NOTREACHED */
@@ -475,6 +486,9 @@ Input file syntax:\n"));
   -P, --properties-input      input file is in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input file is in NeXTstep/GNUstep .strings syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input file is in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -503,6 +517,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -44,6 +44,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "msgl-cat.h"
 #include "msgl-header.h"
@@ -70,11 +71,13 @@ static const struct option long_options[] =
   { "force-po", no_argument, &force_po, 1 },
   { "help", no_argument, NULL, 'h' },
   { "indent", no_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 8 },
   { "lang", required_argument, NULL, CHAR_MAX + 7 },
   { "no-escape", no_argument, NULL, 'e' },
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 2 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 9 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "sort-by-file", no_argument, NULL, 'F' },
@@ -276,6 +279,14 @@ main (int argc, char **argv)
         catalogname = optarg;
         break;
 
+      case CHAR_MAX + 8: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 9: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         /* NOTREACHED */
@@ -421,6 +432,10 @@ Input file syntax:\n"));
       printf (_("\
       --stringtable-input     input files are in NeXTstep/GNUstep .strings\n\
                               syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input files are in the given syntax: 'po',\n\
+                              'properties', 'stringtable', 'binary' or\n\
+                              'profile'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -456,6 +471,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -38,6 +38,7 @@
 #include "read-po.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
+#include "catalog-format.h"
 #include "xmalloca.h"
 #include "po-charset.h"
 #include "msgl-iconv.h"
@@ -67,6 +68,7 @@ static const struct option long_options[] =
 {
   { "directory", required_argument, NULL, 'D' },
   { "help", no_argument, NULL, 'h' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 4 },
   { "multi-domain", no_argument, NULL, 'm' },
   { "no-fuzzy-matching", no_argument, NULL, 'N' },
   { "properties-input", no_argument, NULL, 'P' },
@@ -159,6 +161,10 @@ main (int argc, char *argv[])
         include_untranslated = true;
         break;
 
+      case CHAR_MAX + 4:        /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -254,6 +260,9 @@ Input file syntax:\n"));
       printf (_("\
       --stringtable-input     input files are in NeXTstep/GNUstep .strings\n\
                               syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input files are in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Informative output:\n"));
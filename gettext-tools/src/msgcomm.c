@@ -44,6 +44,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "msgl-cat.h"
 #include "propername.h"
@@ -71,12 +72,14 @@ static const struct option long_options[] =
   { "force-po", no_argument, &force_po, 1 },
   { "help", no_argument, NULL, 'h' },
   { "indent", no_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 7 },
   { "no-escape", no_argument, NULL, 'e' },
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 2 },
   { "omit-header", no_argument, NULL, CHAR_MAX + 1 },
   { "output", required_argument, NULL, 'o' }, /* for backward compatibility */
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 8 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "sort-by-file", no_argument, NULL, 'F' },
@@ -267,6 +270,14 @@ main (int argc, char *argv[])
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 7: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 8: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         /* NOTREACHED */
@@ -412,6 +423,9 @@ Input file syntax:\n"));
       printf (_("\
       --stringtable-input     input files are in NeXTstep/GNUstep .strings\n\
                               syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input files are in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -440,6 +454,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
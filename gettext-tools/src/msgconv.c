@@ -42,6 +42,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "msgl-iconv.h"
 #include "localcharset.h"
@@ -67,10 +68,12 @@ static const struct option long_options[] =
   { "force-po", no_argument, &force_po, 1 },
   { "help", no_argument, NULL, 'h' },
   { "indent", no_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 6 },
   { "no-escape", no_argument, NULL, 'e' },
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 1 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 7 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "sort-by-file", no_argument, NULL, 'F' },
@@ -222,6 +225,14 @@ main (int argc, char **argv)
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 6: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 7: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -340,6 +351,9 @@ Input file syntax:\n"));
   -P, --properties-input      input file is in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input file is in NeXTstep/GNUstep .strings syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input file is in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -368,6 +382,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
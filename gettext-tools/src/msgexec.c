@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/select.h>
 #include <unistd.h>
 
 #include "closeout.h"
@@ -44,6 +45,7 @@
 #include "read-po.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
+#include "catalog-format.h"
 #include "msgl-charset.h"
 #include "xalloc.h"
 #include "full-write.h"
@@ -60,6 +62,10 @@
 # define STDOUT_FILENO 1
 #endif
 
+#ifndef PIPE_BUF
+# define PIPE_BUF 512
+#endif
+
 
 /* Name of the subprogram.  */
 static const char *sub_name;
@@ -71,6 +77,9 @@ static const char *sub_path;
 static char **sub_argv;
 static int sub_argc;
 
+/* Number of subprocesses that may run at the same time.  */
+static int jobs;
+
 /* Maximum exit code encountered.  */
 static int exitcode;
 
@@ -80,6 +89,8 @@ static const struct option long_options[] =
   { "directory", required_argument, NULL, 'D' },
   { "help", no_argument, NULL, 'h' },
   { "input", required_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 2 },
+  { "jobs", required_argument, NULL, 'j' },
   { "properties-input", no_argument, NULL, 'P' },
   { "stringtable-input", no_argument, NULL, CHAR_MAX + 1 },
   { "version", no_argument, NULL, 'V' },
@@ -128,10 +139,11 @@ main (int argc, char **argv)
   do_help = false;
   do_version = false;
   input_file = NULL;
+  jobs = 1;
 
   /* The '+' in the options string causes option parsing to terminate when
      the first non-option, i.e. the subprogram name, is encountered.  */
-  while ((opt = getopt_long (argc, argv, "+D:hi:PV", long_options, NULL))
+  while ((opt = getopt_long (argc, argv, "+D:hi:j:PV", long_options, NULL))
          != EOF)
     switch (opt)
       {
@@ -155,6 +167,20 @@ main (int argc, char **argv)
         input_file = optarg;
         break;
 
+      case 'j':
+        {
+          char *endp;
+          long int value = strtol (optarg, &endp, 10);
+
+          /* Each job needs two pipe file descriptors that must fit into
+             an fd_set, besides stdin, stdout and stderr.  */
+          if (endp == optarg || *endp != '\0' || value < 1
+              || value > (FD_SETSIZE - 3) / 2)
+            error (EXIT_FAILURE, 0, _("invalid number of jobs: %s"), optarg);
+          jobs = value;
+        }
+        break;
+
       case 'P':
         input_syntax = &input_format_properties;
         break;
@@ -167,6 +193,10 @@ main (int argc, char **argv)
         input_syntax = &input_format_stringtable;
         break;
 
+      case CHAR_MAX + 2: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -286,11 +316,21 @@ Input file location:\n"));
 If no input file is given or if it is -, standard input is read.\n"));
       printf ("\n");
       printf (_("\
+Command invocation:\n"));
+      printf (_("\
+  -j, --jobs=NUMBER           run up to NUMBER commands at the same time;\n\
+                              their outputs are written in the order of the\n\
+                              translations\n"));
+      printf ("\n");
+      printf (_("\
 Input file syntax:\n"));
       printf (_("\
   -P, --properties-input      input file is in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input file is in NeXTstep/GNUstep .strings syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input file is in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Informative output:\n"));
@@ -333,6 +373,36 @@ nonintr_close (int fd)
 #endif
 
 
+/* Set the environment variables for the subprocess that processes a
+   translation of MP.
+   Note: These environment variables, especially MSGEXEC_MSGCTXT and
+   MSGEXEC_MSGCTXT, may contain non-ASCII characters.  The subprocess
+   may not interpret these values correctly if the locale encoding is
+   different from the PO file's encoding.  We want about this situation,
+   above.
+   On Unix, this problem is often harmless.  On Windows, however, - both
+   native Windows and Cygwin - the values of environment variables *must*
+   be in the encoding that is the value of GetACP(), because the system
+   may convert the environment from char** to wchar_t** before spawning
+   the subprocess and back from wchar_t** to char** in the subprocess,
+   and it does so using the GetACP() codepage.  */
+static void
+set_environment (const message_ty *mp)
+{
+  char *location;
+
+  if (mp->msgctxt != NULL)
+    xsetenv ("MSGEXEC_MSGCTXT", mp->msgctxt, 1);
+  else
+    unsetenv ("MSGEXEC_MSGCTXT");
+  xsetenv ("MSGEXEC_MSGID", mp->msgid, 1);
+  location = xasprintf ("%s:%ld", mp->pos.file_name,
+                        (long) mp->pos.line_number);
+  xsetenv ("MSGEXEC_LOCATION", location, 1);
+  free (location);
+}
+
+
 /* Pipe a string STR of size LEN bytes to the subprogram.
    The byte after STR is known to be a '\0' byte.  */
 static void
@@ -347,33 +417,13 @@ process_string (const message_ty *mp, const char *str, size_t len)
   else
     {
       /* General command.  */
-      char *location;
       pid_t child;
       int fd[1];
       void (*orig_sigpipe_handler)(int);
       int exitstatus;
 
-      /* Set environment variables for the subprocess.
-         Note: These environment variables, especially MSGEXEC_MSGCTXT and
-         MSGEXEC_MSGCTXT, may contain non-ASCII characters.  The subprocess
-         may not interpret these values correctly if the locale encoding is
-         different from the PO file's encoding.  We want about this situation,
-         above.
-         On Unix, this problem is often harmless.  On Windows, however, - both
-         native Windows and Cygwin - the values of environment variables *must*
-         be in the encoding that is the value of GetACP(), because the system
-         may convert the environment from char** to wchar_t** before spawning
-         the subprocess and back from wchar_t** to char** in the subprocess,
-         and it does so using the GetACP() codepage.  */
-      if (mp->msgctxt != NULL)
-        xsetenv ("MSGEXEC_MSGCTXT", mp->msgctxt, 1);
-      else
-        unsetenv ("MSGEXEC_MSGCTXT");
-      xsetenv ("MSGEXEC_MSGID", mp->msgid, 1);
-      location = xasprintf ("%s:%ld", mp->pos.file_name,
-                            (long) mp->pos.line_number);
-      xsetenv ("MSGEXEC_LOCATION", location, 1);
-      free (location);
+      /* Set environment variables for the subprocess.  */
+      set_environment (mp);
 
       /* Open a pipe to a subprocess.  */
       child = create_pipe_out (sub_name, sub_path, sub_argv, NULL, false, true,
@@ -432,11 +482,272 @@ process_message_list (const message_list_ty *mlp)
 }
 
 
+/* With --jobs, several subprocesses run at the same time.  The standard
+   output of each subprocess is collected in memory and written out in the
+   order of the translations, so that the result is the same as if the
+   subprocesses had been run one after the other.  */
+
+struct job
+{
+  const message_ty *mp;
+  /* The part of the translation that has not yet been written to the
+     subprocess.  */
+  const char *str;
+  size_t len;
+  /* The subprocess, and the pipes to it: fd[0] reads its standard output,
+     fd[1] writes to its standard input, or is -1 once the input has been
+     written completely.  */
+  pid_t child;
+  int fd[2];
+  /* The output of the subprocess so far.  */
+  char *output;
+  size_t output_length;
+  size_t output_allocated;
+  /* Whether the subprocess has terminated.  */
+  bool done;
+};
+
+/* Start the subprocess for JOB.  */
+static void
+start_job (struct job *job)
+{
+  set_environment (job->mp);
+  job->child = create_pipe_bidi (sub_name, sub_path, sub_argv, false, true,
+                                 true, job->fd);
+  if (job->fd[0] >= FD_SETSIZE || job->fd[1] >= FD_SETSIZE)
+    error (EXIT_FAILURE, EMFILE,
+           _("communication with %s subprocess failed"), sub_name);
+  job->output = NULL;
+  job->output_length = 0;
+  job->output_allocated = 0;
+  job->done = false;
+}
+
+/* Feed the next piece of the translation to the subprocess of JOB.  */
+static void
+job_write (struct job *job)
+{
+  if (job->len > 0)
+    {
+      /* Write at most PIPE_BUF bytes, so that the write does not block.  */
+      size_t count = (job->len < PIPE_BUF ? job->len : PIPE_BUF);
+      ssize_t nwritten = write (job->fd[1], job->str, count);
+
+      if (nwritten < 0)
+        {
+          if (errno == EINTR || errno == EAGAIN)
+            return;
+          /* We don't care if the subprocess terminates successfully without
+             having read all of the input that we feed it.  */
+          if (errno != EPIPE)
+            error (EXIT_FAILURE, errno,
+                   _("write to %s subprocess failed"), sub_name);
+          job->len = 0;
+        }
+      else
+        {
+          job->str += nwritten;
+          job->len -= nwritten;
+        }
+    }
+  if (job->len == 0)
+    {
+      close (job->fd[1]);
+      job->fd[1] = -1;
+    }
+}
+
+/* Read the available output of the subprocess of JOB.  Return true when the
+   subprocess has terminated.  */
+static bool
+job_read (struct job *job)
+{
+  ssize_t nread;
+
+  if (job->output_allocated - job->output_length < 4096)
+    {
+      job->output_allocated = 2 * job->output_allocated + 4096;
+      job->output = xrealloc (job->output, job->output_allocated);
+    }
+  nread = read (job->fd[0], job->output + job->output_length,
+                job->output_allocated - job->output_length);
+  if (nread < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN)
+        return false;
+      error (EXIT_FAILURE, errno,
+             _("read from %s subprocess failed"), sub_name);
+    }
+  if (nread > 0)
+    {
+      job->output_length += nread;
+      return false;
+    }
+
+  /* End of file.  */
+  close (job->fd[0]);
+  if (job->fd[1] >= 0)
+    {
+      close (job->fd[1]);
+      job->fd[1] = -1;
+    }
+
+  /* Remove zombie process from process list, and retrieve exit status.  */
+  {
+    int exitstatus =
+      wait_subprocess (job->child, sub_name, false, false, true, true, NULL);
+    if (exitcode < exitstatus)
+      exitcode = exitstatus;
+  }
+
+  job->done = true;
+  return true;
+}
+
+static void
+process_msgdomain_list_jobs (const msgdomain_list_ty *mdlp)
+{
+  struct job *all;
+  size_t njobs;
+  size_t next_start;
+  size_t next_emit;
+  size_t running;
+  void (*orig_sigpipe_handler)(int);
+  size_t k;
+
+  /* Collect the NUL delimited substrings of all translations.  */
+  njobs = 0;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      const message_list_ty *mlp = mdlp->item[k]->messages;
+      size_t j;
+
+      for (j = 0; j < mlp->nitems; j++)
+        {
+          const message_ty *mp = mlp->item[j];
+          const char *p;
+
+          for (p = mp->msgstr; p < mp->msgstr + mp->msgstr_len; )
+            {
+              njobs++;
+              p += strlen (p) + 1;
+            }
+        }
+    }
+  all = XNMALLOC (njobs, struct job);
+  njobs = 0;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      const message_list_ty *mlp = mdlp->item[k]->messages;
+      size_t j;
+
+      for (j = 0; j < mlp->nitems; j++)
+        {
+          const message_ty *mp = mlp->item[j];
+          const char *p;
+
+          for (p = mp->msgstr; p < mp->msgstr + mp->msgstr_len; )
+            {
+              size_t length = strlen (p);
+
+              all[njobs].mp = mp;
+              all[njobs].str = p;
+              all[njobs].len = length;
+              njobs++;
+              p += length + 1;
+            }
+        }
+    }
+
+  /* Ignore SIGPIPE here.  We don't care if a subprocess terminates
+     successfully without having read all of the input that we feed it.  */
+  orig_sigpipe_handler = signal (SIGPIPE, SIG_IGN);
+
+  next_start = 0;
+  next_emit = 0;
+  running = 0;
+  while (next_emit < njobs)
+    {
+      fd_set readfds;
+      fd_set writefds;
+      int maxfd;
+      size_t i;
+
+      /* Start new subprocesses, up to the given limit.  */
+      while (running < (size_t) jobs && next_start < njobs)
+        {
+          start_job (&all[next_start]);
+          next_start++;
+          running++;
+        }
+
+      /* Wait until some subprocess can take input or has produced
+         output.  */
+      FD_ZERO (&readfds);
+      FD_ZERO (&writefds);
+      maxfd = -1;
+      for (i = next_emit; i < next_start; i++)
+        if (!all[i].done)
+          {
+            FD_SET (all[i].fd[0], &readfds);
+            if (maxfd < all[i].fd[0])
+              maxfd = all[i].fd[0];
+            if (all[i].fd[1] >= 0)
+              {
+                FD_SET (all[i].fd[1], &writefds);
+                if (maxfd < all[i].fd[1])
+                  maxfd = all[i].fd[1];
+              }
+          }
+      if (maxfd >= 0
+          && select (maxfd + 1, &readfds, &writefds, NULL, NULL) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          error (EXIT_FAILURE, errno,
+                 _("communication with %s subprocess failed"), sub_name);
+        }
+
+      for (i = next_emit; i < next_start; i++)
+        if (!all[i].done)
+          {
+            if (all[i].fd[1] >= 0 && FD_ISSET (all[i].fd[1], &writefds))
+              job_write (&all[i]);
+            if (FD_ISSET (all[i].fd[0], &readfds))
+              if (job_read (&all[i]))
+                running--;
+          }
+
+      /* Write out the outputs of the terminated subprocesses, in order.  */
+      while (next_emit < next_start && all[next_emit].done)
+        {
+          struct job *job = &all[next_emit];
+
+          if (full_write (STDOUT_FILENO, job->output, job->output_length)
+              < job->output_length)
+            error (EXIT_FAILURE, errno, _("write to stdout failed"));
+          free (job->output);
+          next_emit++;
+        }
+    }
+
+  signal (SIGPIPE, orig_sigpipe_handler);
+
+  free (all);
+}
+
+
 static void
 process_msgdomain_list (const msgdomain_list_ty *mdlp)
 {
   size_t k;
 
+  if (jobs > 1 && strcmp (sub_name, "0") != 0)
+    {
+      process_msgdomain_list_jobs (mdlp);
+      return;
+    }
+
   for (k = 0; k < mdlp->nitems; k++)
     process_message_list (mdlp->item[k]->messages);
 }
@@ -20,16 +20,23 @@
 # include "config.h"
 #endif
 
+#include <errno.h>
 #include <getopt.h>
 #include <limits.h>
 #include <locale.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/select.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
 #include "closeout.h"
 #include "dir-list.h"
 #include "error.h"
@@ -47,11 +54,14 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "msgl-charset.h"
 #include "xalloc.h"
 #include "findprog.h"
 #include "pipe-filter.h"
+#include "spawn-pipe.h"
+#include "wait-process.h"
 #include "xsetenv.h"
 #include "filters.h"
 #include "msgl-iconv.h"
@@ -71,6 +81,9 @@ static int force_po;
 /* Keep the header entry unmodified.  */
 static int keep_header;
 
+/* Pass all translations through a few long-lived subprocesses.  */
+static int batch;
+
 /* Name of the subprogram.  */
 static const char *sub_name;
 
@@ -88,6 +101,7 @@ static void (*filter) (const char *str, size_t len, char **resultp, size_t *leng
 static const struct option long_options[] =
 {
   { "add-location", no_argument, &line_comment, 1 },
+  { "batch", no_argument, &batch, 1 },
   { "color", optional_argument, NULL, CHAR_MAX + 6 },
   { "directory", required_argument, NULL, 'D' },
   { "escape", no_argument, NULL, 'E' },
@@ -95,11 +109,13 @@ static const struct option long_options[] =
   { "help", no_argument, NULL, 'h' },
   { "indent", no_argument, NULL, CHAR_MAX + 1 },
   { "input", required_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 8 },
   { "keep-header", no_argument, &keep_header, 1 },
   { "no-escape", no_argument, NULL, CHAR_MAX + 2 },
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 3 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 9 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "sort-by-file", no_argument, NULL, 'F' },
@@ -122,6 +138,7 @@ static void usage (int status)
 ;
 static void generic_filter (const char *str, size_t len, char **resultp, size_t *lengthp);
 static msgdomain_list_ty *process_msgdomain_list (msgdomain_list_ty *mdlp);
+static msgdomain_list_ty *batch_process_msgdomain_list (msgdomain_list_ty *mdlp);
 
 
 int
@@ -260,6 +277,14 @@ main (int argc, char **argv)
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 8: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 9: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -340,10 +365,29 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (strcmp (sub_name, "recode-sr-latin") == 0 && sub_argc == 1)
     {
       filter = serbian_to_latin;
+      /* A built-in filter costs no subprocess.  */
+      batch = false;
 
       /* Convert the input to UTF-8 first.  */
       result = iconv_msgdomain_list (result, po_charset_utf8, true, input_file);
     }
+  else if (strcmp (sub_name, "sed") == 0
+           && sed_filter_compile (sub_argc, sub_argv))
+    {
+      /* A sed script consisting only of substitutions and
+         transliterations is executed in-process.  */
+      filter = sed_filter;
+      batch = false;
+
+      /* Warn if the current locale is not suitable for this PO file.  */
+      compare_po_locale_charsets (result);
+    }
+  else if (strcmp (sub_name, "tr") == 0
+           && tr_filter_compile (sub_argc, sub_argv))
+    {
+      filter = tr_filter;
+      batch = false;
+    }
   else
     {
       filter = generic_filter;
@@ -361,7 +405,10 @@ There is NO WARRANTY, to the extent permitted by law.\n\
     }
 
   /* Apply the subprogram.  */
-  result = process_msgdomain_list (result);
+  if (batch)
+    result = batch_process_msgdomain_list (result);
+  else
+    result = process_msgdomain_list (result);
 
   /* Sort the results.  */
   if (sort_by_filepos)
@@ -417,6 +464,11 @@ or if it is -.\n"));
 The FILTER can be any program that reads a translation from standard input\n\
 and writes a modified translation to standard output.\n\
 "));
+      printf (_("\
+      --batch                 start the FILTER only once (per thread), and\n\
+                              pass it all translations, each terminated by\n\
+                              a NUL byte; the FILTER must write the results\n\
+                              in the same way, e.g. 'sed -z'\n"));
       printf ("\n");
       printf (_("\
 Useful FILTER-OPTIONs when the FILTER is 'sed':\n"));
@@ -434,6 +486,9 @@ Input file syntax:\n"));
   -P, --properties-input      input file is in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input file is in NeXTstep/GNUstep .strings syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input file is in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -464,6 +519,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -627,7 +685,8 @@ process_message (message_ty *mp)
   if (is_header (mp) && keep_header)
     return;
 
-  /* Set environment variables for the subprocess.
+  /* Set environment variables for the subprocess.  The built-in filters
+     don't need them.
      Note: These environment variables, especially MSGEXEC_MSGCTXT and
      MSGEXEC_MSGCTXT, may contain non-ASCII characters.  The subprocess
      may not interpret these values correctly if the locale encoding is
@@ -639,15 +698,18 @@ process_message (message_ty *mp)
      may convert the environment from char** to wchar_t** before spawning
      the subprocess and back from wchar_t** to char** in the subprocess,
      and it does so using the GetACP() codepage.  */
-  if (mp->msgctxt != NULL)
-    xsetenv ("MSGFILTER_MSGCTXT", mp->msgctxt, 1);
-  else
-    unsetenv ("MSGFILTER_MSGCTXT");
-  xsetenv ("MSGFILTER_MSGID", mp->msgid, 1);
-  location = xasprintf ("%s:%ld", mp->pos.file_name,
-                        (long) mp->pos.line_number);
-  xsetenv ("MSGFILTER_LOCATION", location, 1);
-  free (location);
+  if (filter == generic_filter)
+    {
+      if (mp->msgctxt != NULL)
+        xsetenv ("MSGFILTER_MSGCTXT", mp->msgctxt, 1);
+      else
+        unsetenv ("MSGFILTER_MSGCTXT");
+      xsetenv ("MSGFILTER_MSGID", mp->msgid, 1);
+      location = xasprintf ("%s:%ld", mp->pos.file_name,
+                            (long) mp->pos.line_number);
+      xsetenv ("MSGFILTER_LOCATION", location, 1);
+      free (location);
+    }
 
   /* Count NUL delimited substrings.  */
   for (p = msgstr, nsubstrings = 0;
@@ -707,3 +769,317 @@ process_msgdomain_list (msgdomain_list_ty *mdlp)
 
   return mdlp;
 }
+
+
+/* In batch mode, the translations are passed to a few long-lived
+   subprocesses, as many as there are OpenMP threads, instead of to a new
+   subprocess for each of them.  Each translation is terminated by a NUL byte, and the
+   subprocess terminates each result by a NUL byte.  Each subprocess handles
+   a contiguous range of messages, so that the results come back in the
+   order of the messages.  Like msgexec --jobs, the main thread starts all
+   subprocesses and feeds them and reads from them in a single loop: the
+   spawn-pipe functions must not be used by several threads at once.  */
+
+struct batch_worker
+{
+  message_ty **messages;
+  size_t nmessages;
+  /* The input of the subprocess, and the part that has not yet been
+     written to it.  */
+  char *input;
+  const char *str;
+  size_t len;
+  /* The subprocess, and the pipes to it: fd[0] reads its standard output,
+     fd[1] writes to its standard input, or is -1 once the input has been
+     written completely.  */
+  pid_t child;
+  int fd[2];
+  /* The output of the subprocess so far.  */
+  char *output;
+  size_t output_length;
+  size_t output_allocated;
+  /* Whether the subprocess has terminated.  */
+  bool done;
+};
+
+/* Start the subprocess for WORKER.  */
+static void
+batch_start (struct batch_worker *worker)
+{
+  size_t input_length;
+  size_t j;
+
+  /* The msgstr of a message already is a sequence of NUL terminated
+     strings, one for each plural form.  */
+  input_length = 0;
+  for (j = 0; j < worker->nmessages; j++)
+    input_length += worker->messages[j]->msgstr_len;
+  worker->input = XNMALLOC (input_length, char);
+  input_length = 0;
+  for (j = 0; j < worker->nmessages; j++)
+    {
+      const message_ty *mp = worker->messages[j];
+
+      memcpy (worker->input + input_length, mp->msgstr, mp->msgstr_len);
+      input_length += mp->msgstr_len;
+    }
+  worker->str = worker->input;
+  worker->len = input_length;
+
+  worker->child = create_pipe_bidi (sub_name, sub_path, sub_argv, false, true,
+                                    true, worker->fd);
+  if (worker->fd[0] >= FD_SETSIZE || worker->fd[1] >= FD_SETSIZE)
+    error (EXIT_FAILURE, EMFILE,
+           _("communication with %s subprocess failed"), sub_name);
+  worker->output = NULL;
+  worker->output_length = 0;
+  worker->output_allocated = 0;
+  worker->done = false;
+}
+
+/* Feed the next piece of the input to the subprocess of WORKER.  */
+static void
+batch_write (struct batch_worker *worker)
+{
+  if (worker->len > 0)
+    {
+      /* Write at most PIPE_BUF bytes, so that the write does not block.  */
+      size_t count = (worker->len < PIPE_BUF ? worker->len : PIPE_BUF);
+      ssize_t nwritten = write (worker->fd[1], worker->str, count);
+
+      if (nwritten < 0)
+        {
+          if (errno == EINTR || errno == EAGAIN)
+            return;
+          error (EXIT_FAILURE, errno,
+                 _("write to %s subprocess failed"), sub_name);
+        }
+      worker->str += nwritten;
+      worker->len -= nwritten;
+    }
+  if (worker->len == 0)
+    {
+      close (worker->fd[1]);
+      worker->fd[1] = -1;
+    }
+}
+
+/* Read the available output of the subprocess of WORKER.  Return true when
+   the subprocess has terminated.  */
+static bool
+batch_read (struct batch_worker *worker)
+{
+  ssize_t nread;
+
+  if (worker->output_allocated - worker->output_length < 4096)
+    {
+      worker->output_allocated = 2 * worker->output_allocated + 4096;
+      worker->output = xrealloc (worker->output, worker->output_allocated);
+    }
+  nread = read (worker->fd[0], worker->output + worker->output_length,
+                worker->output_allocated - worker->output_length);
+  if (nread < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN)
+        return false;
+      error (EXIT_FAILURE, errno,
+             _("read from %s subprocess failed"), sub_name);
+    }
+  if (nread > 0)
+    {
+      worker->output_length += nread;
+      return false;
+    }
+
+  /* End of file.  */
+  close (worker->fd[0]);
+  if (worker->fd[1] >= 0)
+    {
+      close (worker->fd[1]);
+      worker->fd[1] = -1;
+    }
+
+  /* Remove zombie process from process list, and retrieve exit status.  */
+  wait_subprocess (worker->child, sub_name, false, false, true, true, NULL);
+
+  worker->done = true;
+  return true;
+}
+
+/* Replace the msgstrs of the messages of WORKER with the results in the
+   output of its subprocess.  */
+static void
+batch_store_results (struct batch_worker *worker)
+{
+  const char *p;
+  const char *p_end;
+  size_t j;
+
+  p = worker->output;
+  p_end = worker->output + worker->output_length;
+  for (j = 0; j < worker->nmessages; j++)
+    {
+      message_ty *mp = worker->messages[j];
+      const char *start = p;
+      const char *q;
+      size_t length;
+      bool add_nul;
+      char *msgstr;
+
+      for (q = mp->msgstr;
+           q < mp->msgstr + mp->msgstr_len;
+           q += strlen (q) + 1)
+        {
+          const char *nul;
+
+          if (p == p_end)
+            error (EXIT_FAILURE, 0,
+                   _("%s subprocess returned fewer results than it was given translations"),
+                   sub_name);
+          nul = (const char *) memchr (p, '\0', p_end - p);
+          p = (nul != NULL ? nul + 1 : p_end);
+        }
+
+      /* The last result may lack its terminating NUL byte.  */
+      length = p - start;
+      add_nul = (start[length - 1] != '\0');
+      msgstr = XNMALLOC (length + add_nul, char);
+      memcpy (msgstr, start, length);
+      if (add_nul)
+        msgstr[length] = '\0';
+
+      mp->msgstr = msgstr;
+      mp->msgstr_len = length + add_nul;
+    }
+  if (p != p_end)
+    error (EXIT_FAILURE, 0,
+           _("%s subprocess returned more results than it was given translations"),
+           sub_name);
+}
+
+
+static msgdomain_list_ty *
+batch_process_msgdomain_list (msgdomain_list_ty *mdlp)
+{
+  message_ty **messages;
+  size_t nmessages;
+  size_t nmessages_max;
+  struct batch_worker *workers;
+  size_t nworkers;
+  size_t running;
+  void (*orig_sigpipe_handler)(int);
+  size_t w;
+  size_t k;
+
+  /* Collect the messages to be filtered.  */
+  messages = NULL;
+  nmessages = 0;
+  nmessages_max = 0;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      message_list_ty *mlp = mdlp->item[k]->messages;
+      size_t j;
+
+      for (j = 0; j < mlp->nitems; j++)
+        {
+          message_ty *mp = mlp->item[j];
+
+          /* Keep the header entry unmodified, if --keep-header was given.  */
+          if (is_header (mp) && keep_header)
+            continue;
+
+          if (nmessages == nmessages_max)
+            {
+              nmessages_max = 2 * nmessages_max + 64;
+              messages = (message_ty **)
+                xrealloc (messages, nmessages_max * sizeof (message_ty *));
+            }
+          messages[nmessages++] = mp;
+        }
+    }
+  if (nmessages == 0)
+    {
+      free (messages);
+      return mdlp;
+    }
+
+  nworkers = 1;
+#ifdef _OPENMP
+  nworkers = omp_get_max_threads ();
+#endif
+  if (nworkers > nmessages)
+    nworkers = nmessages;
+
+  /* Ignore SIGPIPE here.  A subprocess that terminates early is detected
+     through its exit status or through its missing results.  */
+  orig_sigpipe_handler = signal (SIGPIPE, SIG_IGN);
+
+  workers = XNMALLOC (nworkers, struct batch_worker);
+  for (w = 0; w < nworkers; w++)
+    {
+      size_t start = nmessages * w / nworkers;
+      size_t end = nmessages * (w + 1) / nworkers;
+
+      workers[w].messages = messages + start;
+      workers[w].nmessages = end - start;
+      batch_start (&workers[w]);
+    }
+
+  running = nworkers;
+  while (running > 0)
+    {
+      fd_set readfds;
+      fd_set writefds;
+      int maxfd;
+
+      /* Wait until some subprocess can take input or has produced
+         output.  */
+      FD_ZERO (&readfds);
+      FD_ZERO (&writefds);
+      maxfd = -1;
+      for (w = 0; w < nworkers; w++)
+        if (!workers[w].done)
+          {
+            FD_SET (workers[w].fd[0], &readfds);
+            if (maxfd < workers[w].fd[0])
+              maxfd = workers[w].fd[0];
+            if (workers[w].fd[1] >= 0)
+              {
+                FD_SET (workers[w].fd[1], &writefds);
+                if (maxfd < workers[w].fd[1])
+                  maxfd = workers[w].fd[1];
+              }
+          }
+      if (select (maxfd + 1, &readfds, &writefds, NULL, NULL) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          error (EXIT_FAILURE, errno,
+                 _("communication with %s subprocess failed"), sub_name);
+        }
+
+      for (w = 0; w < nworkers; w++)
+        if (!workers[w].done)
+          {
+            if (workers[w].fd[1] >= 0
+                && FD_ISSET (workers[w].fd[1], &writefds))
+              batch_write (&workers[w]);
+            if (FD_ISSET (workers[w].fd[0], &readfds))
+              if (batch_read (&workers[w]))
+                running--;
+          }
+    }
+
+  signal (SIGPIPE, orig_sigpipe_handler);
+
+  for (w = 0; w < nworkers; w++)
+    {
+      batch_store_results (&workers[w]);
+      free (workers[w].output);
+      free (workers[w].input);
+    }
+  free (workers);
+  free (messages);
+
+  return mdlp;
+}
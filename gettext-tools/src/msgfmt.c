@@ -20,12 +20,16 @@
 #endif
 
 #include <ctype.h>
+#include <errno.h>
 #include <getopt.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <locale.h>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
 #include "closeout.h"
 #include "str-list.h"
@@ -50,10 +54,14 @@
 #include "open-catalog.h"
 #include "read-catalog.h"
 #include "read-po.h"
+#include "read-profile.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
+#include "catalog-format.h"
 #include "po-charset.h"
+#include "po-xerror.h"
 #include "msgl-check.h"
+#include "format.h"
 #include "gettext.h"
 
 #define _(str) gettext (str)
@@ -70,6 +78,10 @@ static bool include_untranslated = false;
 /* Specifies name of the output file.  */
 static const char *output_file_name;
 
+/* Manifest mode: name of the file listing pairs of input and output
+   files, which are compiled independently of each other.  */
+static const char *manifest_file_name;
+
 /* Java mode output file specification.  */
 static bool java_mode;
 static bool assume_java2;
@@ -94,6 +106,9 @@ static const char *tcl_base_directory;
 /* Qt mode output file specification.  */
 static bool qt_mode;
 
+/* Bundle mode: write the .mo files of all domains into a single file.  */
+static bool bundle_mode;
+
 /* We may have more than one input file.  Domains with same names in
    different files have to merged.  So we need a list of tables for
    each output file.  */
@@ -110,6 +125,11 @@ struct msg_domain
 };
 static struct msg_domain *domain_list;
 static struct msg_domain *current_domain;
+#ifdef _OPENMP
+/* In manifest mode, these variables describe the compilation performed by
+   the current thread.  */
+# pragma omp threadprivate (output_file_name, domain_list, current_domain)
+#endif
 
 /* Be more verbose.  Use only 'fprintf' and 'multiline_warning' but not
    'error' or 'multiline_error' to emit verbosity messages, because 'error'
@@ -149,6 +169,7 @@ static int do_statistics;
 static const struct option long_options[] =
 {
   { "alignment", required_argument, NULL, 'a' },
+  { "bundle", no_argument, NULL, CHAR_MAX + 14 },
   { "check", no_argument, NULL, 'c' },
   { "check-accelerators", optional_argument, NULL, CHAR_MAX + 1 },
   { "check-compatibility", no_argument, NULL, 'C' },
@@ -160,9 +181,12 @@ static const struct option long_options[] =
   { "directory", required_argument, NULL, 'D' },
   { "endianness", required_argument, NULL, CHAR_MAX + 13 },
   { "help", no_argument, NULL, 'h' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 15 },
   { "java", no_argument, NULL, 'j' },
   { "java2", no_argument, NULL, CHAR_MAX + 5 },
   { "locale", required_argument, NULL, 'l' },
+  { "manifest", required_argument, NULL, CHAR_MAX + 16 },
+  { "merge-suffixes", no_argument, NULL, CHAR_MAX + 17 },
   { "no-hash", no_argument, NULL, CHAR_MAX + 6 },
   { "output-file", required_argument, NULL, 'o' },
   { "properties-input", no_argument, NULL, 'P' },
@@ -170,6 +194,8 @@ static const struct option long_options[] =
   { "resource", required_argument, NULL, 'r' },
   { "statistics", no_argument, &do_statistics, 1 },
   { "strict", no_argument, NULL, 'S' },
+  { "string-order", required_argument, NULL, CHAR_MAX + 18 },
+  { "string-profile", required_argument, NULL, CHAR_MAX + 19 },
   { "stringtable-input", no_argument, NULL, CHAR_MAX + 8 },
   { "tcl", no_argument, NULL, CHAR_MAX + 7 },
   { "use-fuzzy", no_argument, NULL, 'f' },
@@ -187,8 +213,13 @@ static void usage (int status)
 #endif
 ;
 static const char *add_mo_suffix (const char *);
+static const char *bundle_domain_name (const char *filename);
 static struct msg_domain *new_domain (const char *name, const char *file_name);
 static bool is_nonobsolete (const message_ty *mp);
+static int check_domain_messages (message_list_ty *mlp);
+static int compile_manifest (const char *file_name,
+                             catalog_input_format_ty input_syntax,
+                             bool strict_uniforum);
 static void read_catalog_file_msgfmt (char *filename,
                                       catalog_input_format_ty input_syntax);
 
@@ -204,6 +235,8 @@ main (int argc, char *argv[])
   int arg_i;
   const char *canon_encoding;
   struct msg_domain *domain;
+  int nerrors = 0;
+  const char *string_profile_file_name = NULL;
 
   /* Set default value for global variables.  */
   alignment = DEFAULT_OUTPUT_ALIGNMENT;
@@ -353,6 +386,30 @@ main (int argc, char *argv[])
           byteswap = endianness ^ ENDIANNESS;
         }
         break;
+      case CHAR_MAX + 14: /* --bundle */
+        bundle_mode = true;
+        break;
+      case CHAR_MAX + 15: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+      case CHAR_MAX + 16: /* --manifest */
+        manifest_file_name = optarg;
+        break;
+      case CHAR_MAX + 17: /* --merge-suffixes */
+        merge_suffixes = true;
+        break;
+      case CHAR_MAX + 18: /* --string-order={msgid|hash} */
+        if (strcmp (optarg, "msgid") == 0)
+          string_order = mo_string_order_msgid;
+        else if (strcmp (optarg, "hash") == 0)
+          string_order = mo_string_order_hash;
+        else
+          error (EXIT_FAILURE, 0, _("invalid string order: %s"), optarg);
+        break;
+      case CHAR_MAX + 19: /* --string-profile */
+        string_profile_file_name = optarg;
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -377,8 +434,18 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (do_help)
     usage (EXIT_SUCCESS);
 
-  /* Test whether we have a .po file name as argument.  */
-  if (optind >= argc)
+  /* Test whether we have a .po file name as argument.  In manifest mode,
+     the input files are listed in the manifest instead.  */
+  if (manifest_file_name != NULL)
+    {
+      if (optind < argc)
+        {
+          error (EXIT_SUCCESS, 0, _("%s does not accept input file arguments"),
+                 "--manifest");
+          usage (EXIT_FAILURE);
+        }
+    }
+  else if (optind >= argc)
     {
       error (EXIT_SUCCESS, 0, _("no input file given"));
       usage (EXIT_FAILURE);
@@ -391,9 +458,12 @@ There is NO WARRANTY, to the extent permitted by law.\n\
       | (csharp_mode ? 2 : 0)
       | (csharp_resources_mode ? 4 : 0)
       | (tcl_mode ? 8 : 0)
-      | (qt_mode ? 16 : 0);
+      | (qt_mode ? 16 : 0)
+      | (bundle_mode ? 32 : 0)
+      | (manifest_file_name != NULL ? 64 : 0);
     static const char *mode_options[] =
-      { "--java", "--csharp", "--csharp-resources", "--tcl", "--qt" };
+      { "--java", "--csharp", "--csharp-resources", "--tcl", "--qt",
+        "--bundle", "--manifest" };
     /* More than one bit set?  */
     if (modes & (modes - 1))
       {
@@ -491,28 +561,77 @@ There is NO WARRANTY, to the extent permitted by law.\n\
                  "-d", "--java", "--csharp", "--tcl");
           usage (EXIT_FAILURE);
         }
+      if (bundle_mode)
+        {
+          if (output_file_name == NULL)
+            {
+              error (EXIT_SUCCESS, 0,
+                     _("%s requires a \"-o file\" specification"),
+                     "--bundle");
+              usage (EXIT_FAILURE);
+            }
+          if (strcmp (output_file_name, "-") == 0)
+            error (EXIT_FAILURE, 0, _("%s cannot write to standard output"),
+                   "--bundle");
+        }
+      if (manifest_file_name != NULL && output_file_name != NULL)
+        error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+               "--manifest", "--output-file");
+    }
+
+  /* Read the profile that determines the order of the strings.  The
+     messages of all its domains are taken, in the order of the file.
+     It can also be a lookup profile written by libintl.  */
+  if (string_profile_file_name != NULL)
+    {
+      msgdomain_list_ty *profile =
+        read_catalog_file (string_profile_file_name,
+                           is_lookup_profile (string_profile_file_name)
+                           ? &input_format_profile : &input_format_po);
+      size_t k, j;
+
+      string_order_profile = message_list_alloc (false);
+      for (k = 0; k < profile->nitems; k++)
+        {
+          message_list_ty *mlp = profile->item[k]->messages;
+
+          for (j = 0; j < mlp->nitems; j++)
+            message_list_append (string_order_profile, mlp->item[j]);
+        }
     }
 
   /* The -o option determines the name of the domain and therefore
-     the output file.  */
-  if (output_file_name != NULL)
+     the output file.  In bundle mode, it only names the bundle.  */
+  if (output_file_name != NULL && !bundle_mode)
     current_domain =
       new_domain (output_file_name,
                   strict_uniforum && !csharp_resources_mode && !qt_mode
                   ? add_mo_suffix (output_file_name)
                   : output_file_name);
 
-  /* Process all given .po files.  */
-  for (arg_i = optind; arg_i < argc; arg_i++)
-    {
-      /* Remember that we currently have not specified any domain.  This
-         is of course not true when we saw the -o option.  */
-      if (output_file_name == NULL)
-        current_domain = NULL;
-
-      /* And process the input file.  */
-      read_catalog_file_msgfmt (argv[arg_i], input_syntax);
-    }
+  /* Process all given .po files.  In manifest mode, each file is compiled,
+     checked and written on its own, and the loops below have nothing left
+     to do.  */
+  if (manifest_file_name != NULL)
+    nerrors = compile_manifest (manifest_file_name, input_syntax,
+                                strict_uniforum);
+  else
+    for (arg_i = optind; arg_i < argc; arg_i++)
+      {
+        /* Remember that we currently have not specified any domain.  This
+           is of course not true when we saw the -o option.  In bundle mode,
+           the default domain is named after the input file.  */
+        if (bundle_mode)
+          current_domain =
+            (strcmp (argv[arg_i], "-") != 0
+             ? new_domain (bundle_domain_name (argv[arg_i]), output_file_name)
+             : NULL);
+        else if (output_file_name == NULL)
+          current_domain = NULL;
+
+        /* And process the input file.  */
+        read_catalog_file_msgfmt (argv[arg_i], input_syntax);
+      }
 
   /* We know a priori that some input_syntax->parse() functions convert
      strings to UTF-8.  */
@@ -525,18 +644,8 @@ There is NO WARRANTY, to the extent permitted by law.\n\
 
   /* Perform all kinds of checks: plural expressions, format strings, ...  */
   {
-    int nerrors = 0;
-
     for (domain = domain_list; domain != NULL; domain = domain->next)
-      nerrors +=
-        check_message_list (domain->mlp,
-                            /* Untranslated and fuzzy messages have already
-                               been dealt with during parsing, see below in
-                               msgfmt_frob_new_message.  */
-                            0, 0,
-                            1, check_format_strings, check_header,
-                            check_compatibility,
-                            check_accelerators, accelerator_char);
+      nerrors += check_domain_messages (domain->mlp);
 
     /* Exit with status 1 on any error.  */
     if (nerrors > 0)
@@ -550,6 +659,35 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   }
 
   /* Now write out all domains.  */
+  if (bundle_mode)
+    {
+      size_t ndomains;
+      message_list_ty **mlps;
+      const char **domain_names;
+      size_t i;
+
+      ndomains = 0;
+      for (domain = domain_list; domain != NULL; domain = domain->next)
+        ndomains++;
+      mlps = XNMALLOC (ndomains, message_list_ty *);
+      domain_names = XNMALLOC (ndomains, const char *);
+      for (domain = domain_list, i = 0; domain != NULL;
+           domain = domain->next, i++)
+        {
+          mlps[i] = domain->mlp;
+          domain_names[i] = domain->domain_name;
+        }
+
+      if (msgdomain_write_mo_bundle (ndomains, mlps, domain_names,
+                                     output_file_name))
+        exit_status = EXIT_FAILURE;
+
+      for (i = 0; i < ndomains; i++)
+        message_list_free (mlps[i], 0);
+      free (domain_names);
+      free (mlps);
+      domain_list = NULL;
+    }
   for (domain = domain_list; domain != NULL; domain = domain->next)
     {
       if (java_mode)
@@ -599,7 +737,11 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   /* Print statistics if requested.  */
   if (verbose || do_statistics)
     {
-      if (do_statistics + verbose >= 2 && optind < argc)
+      if (do_statistics + verbose >= 2 && manifest_file_name != NULL)
+        /* TRANSLATORS: The prefix before a statistics message.  The argument
+           is a file name or a comma separated list of file names.  */
+        fprintf (stderr, _("%s: "), manifest_file_name);
+      else if (do_statistics + verbose >= 2 && optind < argc)
         {
           /* Print the input file name(s) in front of the statistics line.  */
           char *all_input_file_names;
@@ -636,6 +778,9 @@ There is NO WARRANTY, to the extent permitted by law.\n\
                            msgs_untranslated),
                  msgs_untranslated);
       fputs (".\n", stderr);
+
+      if (verbose >= 2 && check_format_strings)
+        print_formatstring_cache_statistics ();
     }
 
   exit (exit_status);
@@ -672,6 +817,9 @@ Input file location:\n"));
       printf (_("\
   -D, --directory=DIRECTORY   add DIRECTORY to list for input files search\n"));
       printf (_("\
+      --manifest=FILE         compile the pairs of input and output files\n\
+                                listed in FILE, in parallel\n"));
+      printf (_("\
 If input file is -, standard input is read.\n"));
       printf ("\n");
       printf (_("\
@@ -688,6 +836,9 @@ Operation mode:\n"));
       --tcl                   Tcl mode: generate a tcl/msgcat .msg file\n"));
       printf (_("\
       --qt                    Qt mode: generate a Qt .qm file\n"));
+      printf (_("\
+      --bundle                bundle mode: generate a single file containing\n\
+                                the .mo files of all domains\n"));
       printf ("\n");
       printf (_("\
 Output file location:\n"));
@@ -735,12 +886,24 @@ The -l and -d options are mandatory.  The .msg file is written in the\n\
 specified directory.\n"));
       printf ("\n");
       printf (_("\
+Output file location in bundle mode:\n"));
+      printf (_("\
+  -o, --output-file=FILE      write the bundle to the specified file\n"));
+      printf (_("\
+The -o option is mandatory.  Each input file contributes the domain named\n\
+after the file, without .po suffix, and the domains named by its 'domain'\n\
+directives.  Install the bundle as LOCALE/LC_MESSAGES/catalogs.mob.\n"));
+      printf ("\n");
+      printf (_("\
 Input file syntax:\n"));
       printf (_("\
   -P, --properties-input      input files are in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input files are in NeXTstep/GNUstep .strings\n\
                               syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input files are in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Input file interpretation:\n"));
@@ -771,6 +934,16 @@ Output details:\n"));
                                 (big or little, default depends on platform)\n"));
       printf (_("\
       --no-hash               binary file will not include the hash table\n"));
+      printf (_("\
+      --merge-suffixes        store a string that is the tail of another\n\
+                                string as part of it\n"));
+      printf (_("\
+      --string-order=ORDER    order of the strings in the binary file:\n\
+                                msgid (default) or hash\n"));
+      printf (_("\
+      --string-profile=FILE   place the strings of the messages listed in\n\
+                                the PO file or lookup profile FILE first,\n\
+                                in this order\n"));
       printf ("\n");
       printf (_("\
 Informative output:\n"));
@@ -811,6 +984,26 @@ add_mo_suffix (const char *fname)
 }
 
 
+/* Return the default domain of the input file FILENAME in bundle mode:
+   its base name, without .po suffix.  */
+static const char *
+bundle_domain_name (const char *filename)
+{
+  const char *base;
+  size_t len;
+  char *result;
+
+  base = basename (filename);
+  len = strlen (base);
+  if (len > 3 && memcmp (base + len - 3, ".po", 3) == 0)
+    len -= 3;
+  result = XNMALLOC (len + 1, char);
+  memcpy (result, base, len);
+  result[len] = '\0';
+  return result;
+}
+
+
 static struct msg_domain *
 new_domain (const char *name, const char *file_name)
 {
@@ -842,6 +1035,306 @@ is_nonobsolete (const message_ty *mp)
 }
 
 
+/* Perform the checks on the messages of a domain.  Return the number of
+   fatal errors.  */
+static int
+check_domain_messages (message_list_ty *mlp)
+{
+  return check_message_list (mlp,
+                             /* Untranslated and fuzzy messages have already
+                                been dealt with during parsing, see below in
+                                msgfmt_frob_new_message.  */
+                             0, 0,
+                             1, check_format_strings, check_header,
+                             check_compatibility,
+                             check_accelerators, accelerator_char);
+}
+
+
+/* An entry of the manifest: the input file and the .mo file to create.  */
+struct manifest_entry
+{
+  char *input_file_name;
+  char *output_file_name;
+};
+
+/* Read the manifest FILE_NAME.  Each line that is not empty and does not
+   start with '#' consists of an input file name and an output file name,
+   separated by whitespace.  */
+static struct manifest_entry *
+read_manifest (const char *file_name, size_t *nentriesp)
+{
+  size_t line_len = 0;
+  char *line_buf = NULL;
+  unsigned long line_number = 0;
+  struct manifest_entry *entries = NULL;
+  size_t nentries = 0;
+  size_t nentries_max = 0;
+  FILE *fp;
+
+  if (strcmp (file_name, "-") == 0)
+    fp = stdin;
+  else
+    {
+      fp = fopen (file_name, "r");
+      if (fp == NULL)
+        error (EXIT_FAILURE, errno,
+               _("error while opening \"%s\" for reading"), file_name);
+    }
+
+  while (!feof (fp))
+    {
+      /* Read next line from file.  */
+      int len = getline (&line_buf, &line_len, fp);
+      char *input;
+      char *output;
+      char *p;
+
+      /* In case of an error leave loop.  */
+      if (len < 0)
+        break;
+      line_number++;
+
+      /* Remove trailing '\n' and trailing whitespace.  */
+      if (len > 0 && line_buf[len - 1] == '\n')
+        line_buf[--len] = '\0';
+      while (len > 0
+             && (line_buf[len - 1] == ' '
+                 || line_buf[len - 1] == '\t'
+                 || line_buf[len - 1] == '\r'))
+        line_buf[--len] = '\0';
+
+      /* Test if we have to ignore the line.  */
+      if (*line_buf == '\0' || *line_buf == '#')
+        continue;
+
+      /* Split the line into the two file names.  */
+      input = line_buf;
+      for (p = input; *p != '\0' && *p != ' ' && *p != '\t'; p++)
+        ;
+      output = p;
+      while (*output == ' ' || *output == '\t')
+        output++;
+      *p = '\0';
+      if (*output == '\0')
+        error_at_line (EXIT_FAILURE, 0, file_name, line_number,
+                       _("missing output file name"));
+      if (strcmp (output, "-") == 0)
+        error_at_line (EXIT_FAILURE, 0, file_name, line_number,
+                       _("%s cannot write to standard output"),
+                       "--manifest");
+
+      if (nentries == nentries_max)
+        {
+          nentries_max = 2 * nentries_max + 16;
+          entries =
+            (struct manifest_entry *)
+            xrealloc (entries, nentries_max * sizeof (struct manifest_entry));
+        }
+      entries[nentries].input_file_name = xstrdup (input);
+      entries[nentries].output_file_name = xstrdup (output);
+      nentries++;
+    }
+
+  /* Free buffer allocated through getline.  */
+  if (line_buf != NULL)
+    free (line_buf);
+
+  /* Close input stream.  */
+  if (fp != stdin)
+    fclose (fp);
+
+  *nentriesp = nentries;
+  return entries;
+}
+
+/* In manifest mode, several threads emit diagnostics.  error_message_count
+   is shared by all threads, and catalog_reader_parse reads and resets it.
+   Therefore the diagnostics are emitted one at a time, between begin_report
+   and end_report, and the errors among them are counted per thread in
+   manifest_error_count, leaving error_message_count unchanged.
+   manifest_parsing tells whether the current thread is parsing its input
+   file; like po_gram_error, it then gives up after too many errors.  */
+static unsigned int manifest_error_count;
+static bool manifest_parsing;
+#ifdef _OPENMP
+# pragma omp threadprivate (manifest_error_count, manifest_parsing)
+static omp_lock_t report_lock;
+#endif
+static unsigned int report_saved_count;
+
+static void
+begin_report (void)
+{
+  if (manifest_file_name != NULL)
+    {
+#ifdef _OPENMP
+      omp_set_lock (&report_lock);
+#endif
+      report_saved_count = error_message_count;
+    }
+}
+
+static void
+end_report (void)
+{
+  if (manifest_file_name != NULL)
+    {
+      manifest_error_count += error_message_count - report_saved_count;
+      error_message_count = report_saved_count;
+      if (manifest_parsing && manifest_error_count >= gram_max_allowed_errors)
+        error (EXIT_FAILURE, 0, _("too many errors, aborting"));
+#ifdef _OPENMP
+      omp_unset_lock (&report_lock);
+#endif
+    }
+}
+
+/* The error handlers that are in effect outside the manifest compilation.  */
+static void (*saved_xerror) (int, const struct message_ty *, const char *,
+                             size_t, size_t, int, const char *);
+static void (*saved_xerror2) (int, const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *,
+                              const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *);
+
+/* The error handlers in effect during the manifest compilation.  */
+static void
+manifest_xerror (int severity,
+                 const struct message_ty *message,
+                 const char *filename, size_t lineno, size_t column,
+                 int multiline_p, const char *message_text)
+{
+  begin_report ();
+  saved_xerror (severity, message, filename, lineno, column,
+                multiline_p, message_text);
+  end_report ();
+}
+
+static void
+manifest_xerror2 (int severity,
+                  const struct message_ty *message1,
+                  const char *filename1, size_t lineno1, size_t column1,
+                  int multiline_p1, const char *message_text1,
+                  const struct message_ty *message2,
+                  const char *filename2, size_t lineno2, size_t column2,
+                  int multiline_p2, const char *message_text2)
+{
+  begin_report ();
+  saved_xerror2 (severity, message1, filename1, lineno1, column1,
+                 multiline_p1, message_text1,
+                 message2, filename2, lineno2, column2,
+                 multiline_p2, message_text2);
+  end_report ();
+}
+
+/* Compile the input file of ENTRY into a .mo file.  Return the number of
+   errors found in it.  Set *WRITE_FAILEDP to true if the .mo file could
+   not be written.  An input file with errors produces no .mo file.  */
+static int
+compile_manifest_entry (const struct manifest_entry *entry,
+                        catalog_input_format_ty input_syntax,
+                        bool strict_uniforum, bool *write_failedp)
+{
+  struct msg_domain *domain;
+  int nerrors;
+
+  /* As with the -o option, the output file determines the domain, and
+     'domain' directives in the input file are ignored.  */
+  domain_list = NULL;
+  output_file_name = entry->output_file_name;
+  current_domain =
+    new_domain (output_file_name,
+                strict_uniforum
+                ? add_mo_suffix (output_file_name)
+                : output_file_name);
+  domain = current_domain;
+
+  manifest_error_count = 0;
+  manifest_parsing = true;
+  read_catalog_file_msgfmt (entry->input_file_name, input_syntax);
+  manifest_parsing = false;
+
+  message_list_remove_if_not (domain->mlp, is_nonobsolete);
+
+  /* The errors found while parsing would make msgfmt without --manifest
+     stop before the checks.  */
+  if (manifest_error_count > 0)
+    nerrors = manifest_error_count;
+  else
+    nerrors = check_domain_messages (domain->mlp);
+
+  if (nerrors == 0
+      && msgdomain_write_mo (domain->mlp, domain->domain_name,
+                             domain->file_name))
+    *write_failedp = true;
+
+  message_list_free (domain->mlp, 0);
+  free (domain);
+  domain_list = NULL;
+  current_domain = NULL;
+  output_file_name = NULL;
+
+  return nerrors;
+}
+
+/* Compile all entries of the manifest FILE_NAME, in parallel.  Return the
+   total number of errors found in the input files.  */
+static int
+compile_manifest (const char *file_name, catalog_input_format_ty input_syntax,
+                  bool strict_uniforum)
+{
+  struct manifest_entry *entries;
+  size_t nentries;
+  int nerrors = 0;
+  int nwrite_failures = 0;
+  long int i;
+
+  entries = read_manifest (file_name, &nentries);
+
+  saved_xerror = po_xerror;
+  saved_xerror2 = po_xerror2;
+  po_xerror = manifest_xerror;
+  po_xerror2 = manifest_xerror2;
+#ifdef _OPENMP
+  omp_init_lock (&report_lock);
+#endif
+
+  #ifdef _OPENMP
+   #pragma omp parallel for schedule(dynamic) \
+           reduction(+:nerrors) reduction(+:nwrite_failures)
+  #endif
+  for (i = 0; i < (long int) nentries; i++)
+    {
+      bool write_failed = false;
+
+      nerrors +=
+        compile_manifest_entry (&entries[i], input_syntax, strict_uniforum,
+                                &write_failed);
+      if (write_failed)
+        nwrite_failures++;
+    }
+
+#ifdef _OPENMP
+  omp_destroy_lock (&report_lock);
+#endif
+  po_xerror = saved_xerror;
+  po_xerror2 = saved_xerror2;
+
+  if (nwrite_failures > 0)
+    exit_status = EXIT_FAILURE;
+
+  for (i = 0; i < (long int) nentries; i++)
+    {
+      free (entries[i].input_file_name);
+      free (entries[i].output_file_name);
+    }
+  free (entries);
+
+  return nerrors;
+}
+
+
 /* The rest of the file defines a subclass msgfmt_catalog_reader_ty of
    default_catalog_reader_ty.  Its particularities are:
    - The header entry check is performed on-the-fly.
@@ -893,12 +1386,14 @@ msgfmt_parse_debrief (abstract_catalog_reader_ty *that)
     {
       if (!this->has_header_entry)
         {
+          begin_report ();
           multiline_error (xasprintf ("%s: ", this->file_name),
                            xasprintf (_("\
 warning: PO file header missing or invalid\n")));
           multiline_error (NULL,
                            xasprintf (_("\
 warning: charset conversion will not work\n")));
+          end_report ();
         }
       else if (!this->has_nonfuzzy_header_entry)
         {
@@ -923,7 +1418,7 @@ msgfmt_set_domain (default_catalog_reader_ty *this, char *name)
   /* If no output file was given, we change it with each 'domain'
      directive.  */
   if (!java_mode && !csharp_mode && !csharp_resources_mode && !tcl_mode
-      && !qt_mode && output_file_name == NULL)
+      && !qt_mode && (output_file_name == NULL || bundle_mode))
     {
       size_t correct;
 
@@ -951,7 +1446,7 @@ domain name \"%s\" not suitable as file name: will use prefix"), name);
   else
     {
       if (check_domain)
-        po_gram_error_at_line (&gram_pos,
+        po_gram_error_at_line (po_lex_current_pos (),
                                _("'domain %s' directive ignored"), name);
 
       /* NAME was allocated in po-gram-gen.y but is not used anywhere.  */
@@ -1009,19 +1504,31 @@ msgfmt_frob_new_message (default_catalog_reader_ty *that, message_ty *mp,
         {
           if (check_compatibility)
             {
+              begin_report ();
               error_with_progname = false;
               error_at_line (0, 0, mp->pos.file_name, mp->pos.line_number,
                              (mp->msgstr[0] == '\0'
                               ? _("empty 'msgstr' entry ignored")
                               : _("fuzzy 'msgstr' entry ignored")));
               error_with_progname = true;
+              end_report ();
             }
 
           /* Increment counter for fuzzy/untranslated messages.  */
           if (mp->msgstr[0] == '\0')
-            ++msgs_untranslated;
+            {
+              #ifdef _OPENMP
+               #pragma omp atomic
+              #endif
+              ++msgs_untranslated;
+            }
           else
-            ++msgs_fuzzy;
+            {
+              #ifdef _OPENMP
+               #pragma omp atomic
+              #endif
+              ++msgs_fuzzy;
+            }
 
           mp->obsolete = true;
         }
@@ -1038,9 +1545,19 @@ msgfmt_frob_new_message (default_catalog_reader_ty *that, message_ty *mp,
             /* We don't count the header entry in the statistic so place
                the counter incrementation here.  */
             if (mp->is_fuzzy)
-              ++msgs_fuzzy;
+              {
+                #ifdef _OPENMP
+                 #pragma omp atomic
+                #endif
+                ++msgs_fuzzy;
+              }
             else
-              ++msgs_translated;
+              {
+                #ifdef _OPENMP
+                 #pragma omp atomic
+                #endif
+                ++msgs_translated;
+              }
         }
     }
 }
@@ -1061,10 +1578,12 @@ msgfmt_comment_special (abstract_catalog_reader_ty *that, const char *s)
 
       if (!include_fuzzies && check_compatibility && !warned)
         {
+          begin_report ();
           warned = true;
           error (0, 0, _("\
 %s: warning: source file contains fuzzy translation"),
-                 gram_pos.file_name);
+                 po_lex_current_pos ()->file_name);
+          end_report ();
         }
     }
 }
@@ -1089,7 +1608,8 @@ static default_catalog_reader_class_ty msgfmt_methods =
     default_comment,
     default_comment_dot,
     default_comment_filepos,
-    msgfmt_comment_special
+    msgfmt_comment_special,
+    default_comment_format
   },
   msgfmt_set_domain, /* set_domain */
   msgfmt_add_message, /* add_message */
@@ -29,6 +29,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <unistd.h>
 #if defined _MSC_VER || defined __MINGW32__
@@ -46,6 +49,8 @@
 #include "basename.h"
 #include "message.h"
 #include "read-catalog.h"
+#include "open-catalog.h"
+#include "catalog-index.h"
 #include "read-po.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
@@ -53,6 +58,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "str-list.h"
 #include "msgl-charset.h"
@@ -77,6 +83,9 @@ static string_list_ty *location_files;
 /* Selected domain names.  */
 static string_list_ty *domain_names;
 
+/* The search index of the input file, or NULL.  */
+static const char *index_file;
+
 /* Task for each grep pass.  */
 struct grep_task {
   matcher_t *matcher;
@@ -88,6 +97,10 @@ struct grep_task {
 };
 static struct grep_task grep_task[5];
 
+/* Whether the matchers of all grep passes can be executed in several
+   threads at the same time.  */
+static bool matchers_reentrant;
+
 /* Long options.  */
 static const struct option long_options[] =
 {
@@ -105,6 +118,8 @@ static const struct option long_options[] =
   { "help", no_argument, NULL, 'h' },
   { "ignore-case", no_argument, NULL, 'i' },
   { "indent", no_argument, NULL, CHAR_MAX + 2 },
+  { "index", required_argument, NULL, CHAR_MAX + 13 },
+  { "input-format", required_argument, NULL, CHAR_MAX + 11 },
   { "invert-match", no_argument, NULL, 'v' },
   { "location", required_argument, NULL, 'N' },
   { "msgctxt", no_argument, NULL, 'J' },
@@ -114,6 +129,7 @@ static const struct option long_options[] =
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 6 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 12 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
   { "regexp", required_argument, NULL, 'e' },
@@ -140,6 +156,10 @@ static void usage (int status)
         __attribute__ ((noreturn))
 #endif
 ;
+static bool patterns_are_fixed_strings (const struct grep_task *gt);
+static msgdomain_list_ty *
+       read_catalog_file_indexed (const char *filename,
+                                  catalog_input_format_ty input_syntax);
 static msgdomain_list_ty *process_msgdomain_list (msgdomain_list_ty *mdlp);
 
 
@@ -184,6 +204,7 @@ main (int argc, char **argv)
   grep_pass = -1;
   location_files = string_list_alloc ();
   domain_names = string_list_alloc ();
+  index_file = NULL;
 
   for (i = 0; i < 5; i++)
     {
@@ -397,6 +418,18 @@ error while reading \"%s\""), optarg);
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 11: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 12: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 13: /* --index */
+        index_file = optarg;
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -441,7 +474,11 @@ There is NO WARRANTY, to the extent permitted by law.\n\
     error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
            "--sort-output", "--sort-by-file");
 
+  if (index_file != NULL && strcmp (input_file, "-") == 0)
+    error (EXIT_FAILURE, 0, _("option --index requires an input file"));
+
   /* Compile the patterns.  */
+  matchers_reentrant = true;
   for (grep_pass = 0; grep_pass < 5; grep_pass++)
     {
       struct grep_task *gt = &grep_task[grep_pass];
@@ -454,14 +491,27 @@ There is NO WARRANTY, to the extent permitted by law.\n\
               assert (gt->patterns[gt->patterns_size - 1] == '\n');
               gt->patterns_size--;
             }
+          /* Regular expressions without special characters match like
+             fixed strings.  The fixed string matcher searches all of them
+             at once, with a single keyword set, instead of trying one
+             regular expression after the other.  */
+          if (gt->matcher != &matcher_fgrep && patterns_are_fixed_strings (gt))
+            gt->matcher = &matcher_fgrep;
           gt->compiled_patterns =
             gt->matcher->compile (gt->patterns, gt->patterns_size,
                                   gt->case_insensitive, false, false, '\n');
+          /* The regular expression matchers keep the match registers in
+             the compiled pattern.  */
+          if (gt->matcher != &matcher_fgrep)
+            matchers_reentrant = false;
         }
     }
 
   /* Read input file.  */
-  result = read_catalog_file (input_file, input_syntax);
+  if (index_file != NULL)
+    result = read_catalog_file_indexed (input_file, input_syntax);
+  else
+    result = read_catalog_file (input_file, input_syntax);
 
   if (grep_task[0].pattern_count > 0
       || grep_task[1].pattern_count > 0
@@ -528,6 +578,9 @@ Input file location:\n"));
       printf (_("\
   -D, --directory=DIRECTORY   add DIRECTORY to list for input files search\n"));
       printf (_("\
+      --index=FILE            use FILE as search index of the input file,\n\
+                              and create or update it if necessary\n"));
+      printf (_("\
 If no input file is given or if it is -, standard input is read.\n"));
       printf ("\n");
       printf (_("\
@@ -583,6 +636,9 @@ Input file syntax:\n"));
   -P, --properties-input      input file is in Java .properties syntax\n"));
       printf (_("\
       --stringtable-input     input file is in NeXTstep/GNUstep .strings syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input file is in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -611,6 +667,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -675,6 +734,39 @@ nonintr_close (int fd)
 #endif
 
 
+/* Return true if the patterns of the grep task GT contain no character
+   that is special in basic or extended regular expressions, and no empty
+   pattern, so that they can be searched as fixed strings.  */
+static bool
+patterns_are_fixed_strings (const struct grep_task *gt)
+{
+  const char *p = gt->patterns;
+  const char *pend = gt->patterns + gt->patterns_size;
+  bool at_start = true;
+
+  for (; p < pend; p++)
+    {
+      unsigned char c = (unsigned char) *p;
+
+      if (c == '\n')
+        {
+          if (at_start)
+            return false;
+          at_start = true;
+          continue;
+        }
+      at_start = false;
+      if (strchr ("\\.[]*^$+?(){}|", c) != NULL)
+        return false;
+      /* The fixed string matcher ignores the case of ASCII characters
+         only.  */
+      if (gt->case_insensitive && c >= 0x80 && MB_CUR_MAX > 1)
+        return false;
+    }
+  return !at_start;
+}
+
+
 /* Process a string STR of size LEN bytes through grep, and return true
    if it matches.  */
 static bool
@@ -727,16 +819,24 @@ is_message_selected_no_invert (const message_ty *mp)
   /* Test msgstr using the --msgstr arguments.  */
   msgstr = mp->msgstr;
   msgstr_len = mp->msgstr_len;
-  /* Process each NUL delimited substring separately.  */
-  for (p = msgstr; p < msgstr + msgstr_len; )
+  if (grep_task[2].matcher == &matcher_fgrep)
     {
-      size_t length = strlen (p);
-
-      if (is_string_selected (2, p, length))
+      /* A fixed string does not contain a NUL byte.  Therefore a single
+         scan over all plural forms finds the same matches.  */
+      if (is_string_selected (2, msgstr, msgstr_len))
         return true;
-
-      p += length + 1;
     }
+  else
+    /* Process each NUL delimited substring separately.  */
+    for (p = msgstr; p < msgstr + msgstr_len; )
+      {
+        size_t length = strlen (p);
+
+        if (is_string_selected (2, p, length))
+          return true;
+
+        p += length + 1;
+      }
 
   /* Test translator comments using the --comment arguments.  */
   if (grep_task[3].pattern_count > 0
@@ -831,6 +931,14 @@ is_message_selected (const message_ty *mp)
 }
 
 
+/* Return true if a message was selected by is_message_selected.  */
+static bool
+is_message_used (const message_ty *mp)
+{
+  return mp->used;
+}
+
+
 static void
 process_message_list (const char *domain, message_list_ty *mlp)
 {
@@ -838,8 +946,22 @@ process_message_list (const char *domain, message_list_ty *mlp)
     /* Keep all the messages in the list.  */
     ;
   else
-    /* Keep only the selected messages.  */
-    message_list_remove_if_not (mlp, is_message_selected);
+    {
+      /* Keep only the selected messages.
+         The messages are tested in a separate loop that can be
+         parallelized by an OpenMP capable compiler, if the matchers allow
+         it.  */
+      long int nn = mlp->nitems;
+      long int jj;
+
+      #ifdef _OPENMP
+       #pragma omp parallel for schedule(dynamic, 64) if (matchers_reentrant)
+      #endif
+      for (jj = 0; jj < nn; jj++)
+        mlp->item[jj]->used = is_message_selected (mlp->item[jj]);
+
+      message_list_remove_if_not (mlp, is_message_used);
+    }
 }
 
 
@@ -853,3 +975,107 @@ process_msgdomain_list (msgdomain_list_ty *mdlp)
 
   return mdlp;
 }
+
+
+static bool
+is_location_selected (const char *file_name)
+{
+  return filename_list_match (location_files, file_name);
+}
+
+
+/* Mark in SELECTION the messages of the index IDX that may be selected.
+   Return false if the index cannot rule out any message.  */
+static bool
+mark_candidates (const catalog_index_ty *idx, bool *selection)
+{
+  int pass;
+  size_t i;
+
+  if (invert_match)
+    return false;
+
+  for (pass = 0; pass < 5; pass++)
+    {
+      const struct grep_task *gt = &grep_task[pass];
+
+      if (gt->pattern_count > 0)
+        {
+          const char *p = gt->patterns;
+          const char *pend = gt->patterns + gt->patterns_size;
+
+          /* Only fixed strings can be looked up.  Regular expressions are
+             tested on all messages.  */
+          if (gt->matcher != &matcher_fgrep)
+            return false;
+
+          for (;;)
+            {
+              const char *eol = (const char *) memchr (p, '\n', pend - p);
+              const char *end = (eol != NULL ? eol : pend);
+              enum catalog_index_field field = (enum catalog_index_field) pass;
+
+              if (!catalog_index_mark_substring (idx, field, p, end - p,
+                                                 gt->case_insensitive,
+                                                 selection))
+                return false;
+              if (eol == NULL)
+                break;
+              p = eol + 1;
+            }
+        }
+    }
+
+  if (location_files->nitems > 0)
+    catalog_index_mark_location (idx, is_location_selected, selection);
+  for (i = 0; i < domain_names->nitems; i++)
+    catalog_index_mark_domain (idx, domain_names->item[i], selection);
+  catalog_index_mark_headers (idx, selection);
+
+  return true;
+}
+
+
+/* Read the input file FILENAME, using the search index.  Return the
+   messages that may be selected, in their original order; the caller tests
+   them like the messages of the entire file.  If the index does not exist
+   or is older than the input file, the entire file is read and the index
+   is created.  */
+static msgdomain_list_ty *
+read_catalog_file_indexed (const char *filename,
+                           catalog_input_format_ty input_syntax)
+{
+  char *real_filename;
+  FILE *fp;
+  struct stat statbuf;
+  catalog_index_ty *idx;
+  msgdomain_list_ty *mdlp;
+
+  fp = open_catalog_file (filename, &real_filename, true);
+  if (fstat (fileno (fp), &statbuf) < 0)
+    error (EXIT_FAILURE, errno, _("error while reading \"%s\""),
+           real_filename);
+
+  idx = catalog_index_open (index_file, &statbuf);
+  if (idx == NULL)
+    {
+      mdlp = read_catalog_stream (fp, real_filename, filename, input_syntax);
+      fclose (fp);
+      catalog_index_write (mdlp, &statbuf, index_file);
+    }
+  else
+    {
+      size_t n = catalog_index_message_count (idx);
+      bool *selection = XCALLOC (n, bool);
+
+      fclose (fp);
+      if (mark_candidates (idx, selection))
+        mdlp = catalog_index_read (idx, selection);
+      else
+        mdlp = catalog_index_read (idx, NULL);
+      free (selection);
+      catalog_index_close (idx);
+    }
+
+  return mdlp;
+}
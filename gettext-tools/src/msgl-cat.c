@@ -27,14 +27,17 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "error.h"
 #include "xerror.h"
 #include "xvasprintf.h"
 #include "message.h"
 #include "read-catalog.h"
+#include "po-xerror.h"
 #include "po-charset.h"
 #include "msgl-ascii.h"
 #include "msgl-equal.h"
@@ -42,6 +45,7 @@
 #include "xalloc.h"
 #include "xmalloca.h"
 #include "c-strstr.h"
+#include "hash.h"
 #include "basename.h"
 #include "gettext.h"
 
@@ -65,305 +69,636 @@ bool msgcomm_mode = false;
 bool omit_header = false;
 
 
+
+/* Input files are read twice: once to count the translations of each
+   message, and once to fill the resulting messages.  Between the two
+   passes, the contents of the input files are kept in memory only up to
+   this total size; larger input files are read again.  */
+#define CATENATE_KEEP_INPUT_SIZE (64 * 1024 * 1024)
+
+/* Number of input files that are read, or converted, at the same time.  */
+#define CATENATE_BATCH_SIZE 32
+
+/* A message of the result, identified by its msgctxt and msgid.  */
+struct catenate_entry
+{
+  /* Positive: the number of good translations.
+     Negative: minus the number of weak translations, if there is no good
+     translation.  */
+  int used;
+  /* True if this is the header entry.  */
+  bool header;
+  /* True when, with use_first, a translation has been taken already.  */
+  bool taken;
+  /* The resulting message, or NULL if it has not been created yet.  */
+  message_ty *tmp;
+};
+
+/* The messages of a domain of the result, in the order of their first
+   occurrence in the input files.  */
+struct catenate_domain
+{
+  hash_table htable;    /* maps msgctxt + msgid to an index into entries */
+  struct catenate_entry *entries;
+  size_t nentries;
+  size_t nentries_max;
+};
+
+/* A message of an input file.  */
+struct catenate_occurrence
+{
+  size_t entry;         /* index into the domain's entries */
+  bool needed;          /* true if it contributes to the result */
+  bool weak;            /* true if it is a fuzzy or empty translation */
+};
+
+/* A domain of an input file.  */
+struct catenate_input_domain
+{
+  size_t total_domain;  /* index of the domain in the result */
+  size_t nmessages;
+  struct catenate_occurrence *occurrences;
+};
+
+/* An input file.  */
+struct catenate_input
+{
+  /* The contents of the file, or NULL if it has to be read again.  */
+  msgdomain_list_ty *mdlp;
+  /* The a-priori known encoding of the file, or NULL.  */
+  const char *encoding;
+  size_t ndomains;
+  struct catenate_input_domain *domains;
+};
+
+
 static bool
-is_message_selected (const message_ty *tmp)
+is_entry_selected (const struct catenate_entry *entry)
 {
-  int used = (tmp->used >= 0 ? tmp->used : - tmp->used);
+  int used = (entry->used >= 0 ? entry->used : - entry->used);
 
-  return (is_header (tmp)
+  return (entry->header
           ? !omit_header        /* keep the header entry */
           : (used > more_than && used < less_than));
 }
 
 
 static bool
-is_message_needed (const message_ty *mp)
+is_occurrence_needed (const struct catenate_occurrence *occ,
+                      const struct catenate_entry *entry)
 {
-  if (!msgcomm_mode
-      && ((!is_header (mp) && mp->is_fuzzy) || mp->msgstr[0] == '\0'))
+  if (occ->weak)
     /* Weak translation.  Needed if there are only weak translations.  */
-    return mp->tmp->used < 0 && is_message_selected (mp->tmp);
+    return entry->used < 0 && is_entry_selected (entry);
   else
     /* Good translation.  */
-    return is_message_selected (mp->tmp);
+    return is_entry_selected (entry);
 }
 
 
-/* The use_first logic.  */
-static bool
-is_message_first_needed (const message_ty *mp)
+/* Return the entry for the message MP in the domain CDP.  If there is none,
+   create it if CREATE is true, otherwise return SIZE_MAX.  */
+static size_t
+catenate_domain_lookup (struct catenate_domain *cdp, const message_ty *mp,
+                        bool create)
 {
-  if (mp->tmp->obsolete && is_message_needed (mp))
+  char *alloced_key;
+  const char *key;
+  size_t keylen;
+  void *value;
+  size_t index;
+
+  if (mp->msgctxt != NULL)
+    {
+      /* Concatenate mp->msgctxt and mp->msgid, to form the hash table key.  */
+      size_t msgctxt_len = strlen (mp->msgctxt);
+      size_t msgid_len = strlen (mp->msgid);
+      keylen = msgctxt_len + 1 + msgid_len + 1;
+      alloced_key = (char *) xmalloca (keylen);
+      memcpy (alloced_key, mp->msgctxt, msgctxt_len);
+      alloced_key[msgctxt_len] = MSGCTXT_SEPARATOR;
+      memcpy (alloced_key + msgctxt_len + 1, mp->msgid, msgid_len + 1);
+      key = alloced_key;
+    }
+  else
     {
-      mp->tmp->obsolete = false;
-      return true;
+      alloced_key = NULL;
+      key = mp->msgid;
+      keylen = strlen (mp->msgid) + 1;
     }
+
+  if (hash_find_entry (&cdp->htable, key, keylen, &value) == 0)
+    index = (uintptr_t) value;
+  else if (!create)
+    index = SIZE_MAX;
   else
-    return false;
+    {
+      struct catenate_entry *entry;
+
+      if (cdp->nentries >= cdp->nentries_max)
+        {
+          cdp->nentries_max = 2 * cdp->nentries_max + 64;
+          cdp->entries =
+            xrealloc (cdp->entries,
+                      cdp->nentries_max * sizeof (struct catenate_entry));
+        }
+      index = cdp->nentries++;
+      entry = &cdp->entries[index];
+      entry->used = 0;
+      entry->header = is_header (mp);
+      entry->taken = false;
+      entry->tmp = NULL;
+      hash_insert_entry (&cdp->htable, key, keylen,
+                         (void *) (uintptr_t) index);
+    }
+
+  if (mp->msgctxt != NULL)
+    freea (alloced_key);
+
+  return index;
 }
 
 
-msgdomain_list_ty *
-catenate_msgdomain_list (string_list_ty *file_list,
-                         catalog_input_format_ty input_syntax,
-                         const char *to_code)
+/* Determine the canonical name of the encoding of the domain K of the
+   input file FILENAME, with contents MDLP.  */
+static const char *
+input_charset (msgdomain_list_ty *mdlp, size_t k, const char *filename)
 {
-  const char * const *files = file_list->item;
-  size_t nfiles = file_list->nitems;
-  msgdomain_list_ty **mdlps;
-  const char ***canon_charsets;
-  const char ***identifications;
-  msgdomain_list_ty *total_mdlp;
-  const char *canon_to_code;
-  size_t n, j;
+  message_list_ty *mlp = mdlp->item[k]->messages;
+  const char *canon_from_code = NULL;
+  size_t j;
 
-  /* Read input files.  */
-  mdlps = XNMALLOC (nfiles, msgdomain_list_ty *);
-  for (n = 0; n < nfiles; n++)
-    mdlps[n] = read_catalog_file (files[n], input_syntax);
-
-  /* Determine the canonical name of each input file's encoding.  */
-  canon_charsets = XNMALLOC (nfiles, const char **);
-  for (n = 0; n < nfiles; n++)
+  if (mlp->nitems > 0)
     {
-      msgdomain_list_ty *mdlp = mdlps[n];
-      size_t k;
+      for (j = 0; j < mlp->nitems; j++)
+        if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
+          {
+            const char *header = mlp->item[j]->msgstr;
 
-      canon_charsets[n] = XNMALLOC (mdlp->nitems, const char *);
-      for (k = 0; k < mdlp->nitems; k++)
-        {
-          message_list_ty *mlp = mdlp->item[k]->messages;
-          const char *canon_from_code = NULL;
+            if (header != NULL)
+              {
+                const char *charsetstr = c_strstr (header, "charset=");
 
-          if (mlp->nitems > 0)
-            {
-              for (j = 0; j < mlp->nitems; j++)
-                if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
+                if (charsetstr != NULL)
                   {
-                    const char *header = mlp->item[j]->msgstr;
+                    size_t len;
+                    char *charset;
+                    const char *canon_charset;
 
-                    if (header != NULL)
+                    charsetstr += strlen ("charset=");
+                    len = strcspn (charsetstr, " \t\n");
+                    charset = (char *) xmalloca (len + 1);
+                    memcpy (charset, charsetstr, len);
+                    charset[len] = '\0';
+
+                    canon_charset = po_charset_canonicalize (charset);
+                    if (canon_charset == NULL)
                       {
-                        const char *charsetstr = c_strstr (header, "charset=");
-
-                        if (charsetstr != NULL)
-                          {
-                            size_t len;
-                            char *charset;
-                            const char *canon_charset;
-
-                            charsetstr += strlen ("charset=");
-                            len = strcspn (charsetstr, " \t\n");
-                            charset = (char *) xmalloca (len + 1);
-                            memcpy (charset, charsetstr, len);
-                            charset[len] = '\0';
-
-                            canon_charset = po_charset_canonicalize (charset);
-                            if (canon_charset == NULL)
-                              {
-                                /* Don't give an error for POT files, because
-                                   POT files usually contain only ASCII
-                                   msgids.  */
-                                const char *filename = files[n];
-                                size_t filenamelen = strlen (filename);
-
-                                if (filenamelen >= 4
-                                    && memcmp (filename + filenamelen - 4,
-                                               ".pot", 4) == 0
-                                    && strcmp (charset, "CHARSET") == 0)
-                                  canon_charset = po_charset_ascii;
-                                else
-                                  error (EXIT_FAILURE, 0,
-                                         _("\
+                        /* Don't give an error for POT files, because
+                           POT files usually contain only ASCII
+                           msgids.  */
+                        size_t filenamelen = strlen (filename);
+
+                        if (filenamelen >= 4
+                            && memcmp (filename + filenamelen - 4,
+                                       ".pot", 4) == 0
+                            && strcmp (charset, "CHARSET") == 0)
+                          canon_charset = po_charset_ascii;
+                        else
+                          error (EXIT_FAILURE, 0,
+                                 _("\
 present charset \"%s\" is not a portable encoding name"),
-                                         charset);
-                              }
+                                 charset);
+                      }
 
-                            freea (charset);
+                    freea (charset);
 
-                            if (canon_from_code == NULL)
-                              canon_from_code = canon_charset;
-                            else if (canon_from_code != canon_charset)
-                              error (EXIT_FAILURE, 0,
-                                     _("\
+                    if (canon_from_code == NULL)
+                      canon_from_code = canon_charset;
+                    else if (canon_from_code != canon_charset)
+                      error (EXIT_FAILURE, 0,
+                             _("\
 two different charsets \"%s\" and \"%s\" in input file"),
-                                     canon_from_code, canon_charset);
-                          }
-                      }
+                             canon_from_code, canon_charset);
                   }
-              if (canon_from_code == NULL)
-                {
-                  if (is_ascii_message_list (mlp))
-                    canon_from_code = po_charset_ascii;
-                  else if (mdlp->encoding != NULL)
-                    canon_from_code = mdlp->encoding;
-                  else
-                    {
-                      if (k == 0)
-                        error (EXIT_FAILURE, 0, _("\
+              }
+          }
+      if (canon_from_code == NULL)
+        {
+          if (is_ascii_message_list (mlp))
+            canon_from_code = po_charset_ascii;
+          else if (mdlp->encoding != NULL)
+            canon_from_code = mdlp->encoding;
+          else
+            {
+              if (k == 0)
+                error (EXIT_FAILURE, 0, _("\
 input file '%s' doesn't contain a header entry with a charset specification"),
-                               files[n]);
-                      else
-                        error (EXIT_FAILURE, 0, _("\
+                       filename);
+              else
+                error (EXIT_FAILURE, 0, _("\
 domain \"%s\" in input file '%s' doesn't contain a header entry with a charset specification"),
-                               mdlp->item[k]->domain, files[n]);
-                    }
-                }
+                       mdlp->item[k]->domain, filename);
             }
-          canon_charsets[n][k] = canon_from_code;
         }
     }
+  return canon_from_code;
+}
 
-  /* Determine textual identifications of each file/domain combination.  */
-  identifications = XNMALLOC (nfiles, const char **);
-  for (n = 0; n < nfiles; n++)
-    {
-      const char *filename = basename (files[n]);
-      msgdomain_list_ty *mdlp = mdlps[n];
-      size_t k;
 
-      identifications[n] = XNMALLOC (mdlp->nitems, const char *);
-      for (k = 0; k < mdlp->nitems; k++)
-        {
-          const char *domain = mdlp->item[k]->domain;
-          message_list_ty *mlp = mdlp->item[k]->messages;
-          char *project_id = NULL;
+/* Determine a textual identification of the domain K of the input file
+   FILENAME, with contents MDLP.  */
+static const char *
+input_identification (msgdomain_list_ty *mdlp, size_t k, const char *filename)
+{
+  const char *domain = mdlp->item[k]->domain;
+  message_list_ty *mlp = mdlp->item[k]->messages;
+  char *project_id = NULL;
+  size_t j;
 
-          for (j = 0; j < mlp->nitems; j++)
-            if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
-              {
-                const char *header = mlp->item[j]->msgstr;
+  filename = basename (filename);
 
-                if (header != NULL)
-                  {
-                    const char *cp = c_strstr (header, "Project-Id-Version:");
+  for (j = 0; j < mlp->nitems; j++)
+    if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
+      {
+        const char *header = mlp->item[j]->msgstr;
 
-                    if (cp != NULL)
-                      {
-                        const char *endp;
+        if (header != NULL)
+          {
+            const char *cp = c_strstr (header, "Project-Id-Version:");
 
-                        cp += sizeof ("Project-Id-Version:") - 1;
+            if (cp != NULL)
+              {
+                const char *endp;
 
-                        endp = strchr (cp, '\n');
-                        if (endp == NULL)
-                          endp = cp + strlen (cp);
+                cp += sizeof ("Project-Id-Version:") - 1;
 
-                        while (cp < endp && *cp == ' ')
-                          cp++;
+                endp = strchr (cp, '\n');
+                if (endp == NULL)
+                  endp = cp + strlen (cp);
 
-                        if (cp < endp)
-                          {
-                            size_t len = endp - cp;
-                            project_id = XNMALLOC (len + 1, char);
-                            memcpy (project_id, cp, len);
-                            project_id[len] = '\0';
-                          }
-                        break;
-                      }
+                while (cp < endp && *cp == ' ')
+                  cp++;
+
+                if (cp < endp)
+                  {
+                    size_t len = endp - cp;
+                    project_id = XNMALLOC (len + 1, char);
+                    memcpy (project_id, cp, len);
+                    project_id[len] = '\0';
                   }
+                break;
               }
+          }
+      }
 
-          identifications[n][k] =
-            (project_id != NULL
-             ? (k > 0 ? xasprintf ("%s:%s (%s)", filename, domain, project_id)
-                      : xasprintf ("%s (%s)", filename, project_id))
-             : (k > 0 ? xasprintf ("%s:%s", filename, domain)
-                      : xasprintf ("%s", filename)));
-        }
+  return (project_id != NULL
+          ? (k > 0 ? xasprintf ("%s:%s (%s)", filename, domain, project_id)
+                   : xasprintf ("%s (%s)", filename, project_id))
+          : (k > 0 ? xasprintf ("%s:%s", filename, domain)
+                   : xasprintf ("%s", filename)));
+}
+
+
+/* The error handlers that were in effect before reading an input file
+   again.  */
+static void (*saved_xerror) (int, const struct message_ty *, const char *,
+                             size_t, size_t, int, const char *);
+static void (*saved_xerror2) (int, const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *,
+                              const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *);
+
+/* The error handlers in effect while reading an input file again.  The
+   warnings have already been reported the first time.  */
+static void
+reread_xerror (int severity,
+               const struct message_ty *message,
+               const char *filename, size_t lineno, size_t column,
+               int multiline_p, const char *message_text)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror (severity, message, filename, lineno, column,
+                  multiline_p, message_text);
+}
+
+static void
+reread_xerror2 (int severity,
+                const struct message_ty *message1,
+                const char *filename1, size_t lineno1, size_t column1,
+                int multiline_p1, const char *message_text1,
+                const struct message_ty *message2,
+                const char *filename2, size_t lineno2, size_t column2,
+                int multiline_p2, const char *message_text2)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror2 (severity, message1, filename1, lineno1, column1,
+                   multiline_p1, message_text1,
+                   message2, filename2, lineno2, column2,
+                   multiline_p2, message_text2);
+}
+
+/* Read again those of the input files FILENAMES[0..NFILES-1] whose contents
+   were not kept after the first pass, and verify that they still contain the
+   domains and messages seen the first time, in the same order.  TOTAL_MDLP
+   and CDOMAINS are the domains of the result.  Store the contents of all
+   these input files in MDLPS[0..NFILES-1].  */
+static void
+reread_catalog_files (const char * const *filenames, size_t nfiles,
+                      catalog_input_format_ty input_syntax,
+                      const struct catenate_input *inputs,
+                      const msgdomain_list_ty *total_mdlp,
+                      struct catenate_domain *cdomains,
+                      msgdomain_list_ty **mdlps)
+{
+  const char **names = XNMALLOC (nfiles, const char *);
+  msgdomain_list_ty **contents;
+  size_t count;
+  size_t i, j, k;
+
+  count = 0;
+  for (i = 0; i < nfiles; i++)
+    if (inputs[i].mdlp == NULL)
+      names[count++] = filenames[i];
+
+  saved_xerror = po_xerror;
+  saved_xerror2 = po_xerror2;
+  po_xerror = reread_xerror;
+  po_xerror2 = reread_xerror2;
+
+  contents = read_catalog_files (names, count, input_syntax);
+
+  po_xerror = saved_xerror;
+  po_xerror2 = saved_xerror2;
+
+  count = 0;
+  for (i = 0; i < nfiles; i++)
+    if (inputs[i].mdlp != NULL)
+      mdlps[i] = inputs[i].mdlp;
+    else
+      {
+        msgdomain_list_ty *mdlp = contents[count++];
+
+        bool unchanged = (mdlp->nitems == inputs[i].ndomains);
+
+        for (k = 0; unchanged && k < mdlp->nitems; k++)
+          {
+            const struct catenate_input_domain *idp = &inputs[i].domains[k];
+            message_list_ty *mlp = mdlp->item[k]->messages;
+
+            /* The messages are identified by their msgctxt and msgid.  */
+            unchanged =
+              (strcmp (mdlp->item[k]->domain,
+                       total_mdlp->item[idp->total_domain]->domain) == 0
+               && mlp->nitems == idp->nmessages);
+            for (j = 0; unchanged && j < mlp->nitems; j++)
+              unchanged =
+                (catenate_domain_lookup (&cdomains[idp->total_domain],
+                                         mlp->item[j], false)
+                 == idp->occurrences[j].entry);
+          }
+        if (!unchanged)
+          error (EXIT_FAILURE, 0,
+                 _("input file '%s' changed while being read"), filenames[i]);
+        mdlps[i] = mdlp;
+      }
+
+  free (contents);
+  free (names);
+}
+
+
+/* Free MP, a message of an input file, except for the parts that TMP, the
+   resulting message, refers to.  TMP may be NULL.  */
+static void
+discard_message (message_ty *mp, const message_ty *tmp)
+{
+  bool shares_comment = false;
+  bool shares_comment_dot = false;
+  bool shares_msgstr = false;
+  size_t i;
+
+  if (tmp != NULL)
+    {
+      shares_msgstr = (mp->msgstr == tmp->msgstr);
+      for (i = 0; i < tmp->alternative_count; i++)
+        if (tmp->alternative[i].msgstr == mp->msgstr)
+          {
+            shares_msgstr = true;
+            shares_comment = (mp->comment == tmp->alternative[i].comment);
+            shares_comment_dot =
+              (mp->comment_dot == tmp->alternative[i].comment_dot);
+            break;
+          }
     }
 
-  /* Create list of resulting messages, but don't fill it.  Only count
-     the number of translations for each message.
+  if (tmp == NULL || mp->msgid != tmp->msgid)
+    free ((char *) mp->msgid);
+  if (mp->msgid_plural != NULL)
+    free ((char *) mp->msgid_plural);
+  if (!shares_msgstr)
+    free ((char *) mp->msgstr);
+  if (mp->comment != NULL && !shares_comment)
+    string_list_free (mp->comment);
+  if (mp->comment_dot != NULL && !shares_comment_dot)
+    string_list_free (mp->comment_dot);
+  for (i = 0; i < mp->filepos_count; ++i)
+    free ((char *) mp->filepos[i].file_name);
+  if (mp->filepos != NULL)
+    free (mp->filepos);
+  if (mp->prev_msgctxt != NULL
+      && (tmp == NULL || mp->prev_msgctxt != tmp->prev_msgctxt))
+    free ((char *) mp->prev_msgctxt);
+  if (mp->prev_msgid != NULL
+      && (tmp == NULL || mp->prev_msgid != tmp->prev_msgid))
+    free ((char *) mp->prev_msgid);
+  if (mp->prev_msgid_plural != NULL
+      && (tmp == NULL || mp->prev_msgid_plural != tmp->prev_msgid_plural))
+    free ((char *) mp->prev_msgid_plural);
+  free (mp);
+}
+
+
+msgdomain_list_ty *
+catenate_msgdomain_list (string_list_ty *file_list,
+                         catalog_input_format_ty input_syntax,
+                         const char *to_code)
+{
+  const char * const *files = file_list->item;
+  size_t nfiles = file_list->nitems;
+  struct catenate_input *inputs;
+  const char ***canon_charsets;
+  const char ***identifications;
+  struct catenate_domain *cdomains;
+  msgdomain_list_ty *total_mdlp;
+  const char *canon_to_code;
+  msgdomain_list_ty **batch;
+  size_t *changed;
+  size_t ncdomains;
+  size_t kept_size;
+  size_t n0, nbatch;
+  size_t n, j;
+
+  /* First pass: Read the input files, and count the number of translations
+     for each resulting message, without creating the resulting messages.
      If for a message, there is at least one non-fuzzy, non-empty translation,
      use only the non-fuzzy, non-empty translations.  Otherwise use the
      fuzzy or empty translations as well.  */
+  inputs = XNMALLOC (nfiles, struct catenate_input);
+  canon_charsets = XNMALLOC (nfiles, const char **);
+  identifications = XNMALLOC (nfiles, const char **);
   total_mdlp = msgdomain_list_alloc (true);
+  cdomains = NULL;
+  ncdomains = 0;
+  kept_size = 0;
+  batch = NULL;
   for (n = 0; n < nfiles; n++)
     {
-      msgdomain_list_ty *mdlp = mdlps[n];
+      msgdomain_list_ty *mdlp;
+      struct catenate_input *input = &inputs[n];
+      struct stat statbuf;
+      bool regular;
       size_t k;
 
+      /* Read the input files in batches, several of them at the same
+         time.  */
+      if (n % CATENATE_BATCH_SIZE == 0)
+        {
+          free (batch);
+          batch = read_catalog_files (files + n,
+                                      nfiles - n < CATENATE_BATCH_SIZE
+                                      ? nfiles - n : CATENATE_BATCH_SIZE,
+                                      input_syntax);
+        }
+      mdlp = batch[n % CATENATE_BATCH_SIZE];
+
+      input->encoding = mdlp->encoding;
+      input->ndomains = mdlp->nitems;
+      input->domains =
+        XNMALLOC (mdlp->nitems, struct catenate_input_domain);
+      canon_charsets[n] = XNMALLOC (mdlp->nitems, const char *);
+      identifications[n] = XNMALLOC (mdlp->nitems, const char *);
+
       for (k = 0; k < mdlp->nitems; k++)
         {
           const char *domain = mdlp->item[k]->domain;
           message_list_ty *mlp = mdlp->item[k]->messages;
+          struct catenate_input_domain *idp = &input->domains[k];
           message_list_ty *total_mlp;
+          struct catenate_domain *cdp;
+          size_t t;
+
+          canon_charsets[n][k] = input_charset (mdlp, k, files[n]);
+          identifications[n][k] = input_identification (mdlp, k, files[n]);
 
           total_mlp = msgdomain_list_sublist (total_mdlp, domain, true);
+          for (; ncdomains < total_mdlp->nitems; ncdomains++)
+            {
+              cdomains =
+                xrealloc (cdomains,
+                          (ncdomains + 1) * sizeof (struct catenate_domain));
+              cdp = &cdomains[ncdomains];
+              hash_init (&cdp->htable, 100);
+              cdp->entries = NULL;
+              cdp->nentries = 0;
+              cdp->nentries_max = 0;
+            }
+          for (t = 0; total_mdlp->item[t]->messages != total_mlp; t++)
+            ;
+          idp->total_domain = t;
+          idp->nmessages = mlp->nitems;
+          idp->occurrences =
+            XNMALLOC (mlp->nitems, struct catenate_occurrence);
+          cdp = &cdomains[t];
 
           for (j = 0; j < mlp->nitems; j++)
             {
               message_ty *mp = mlp->item[j];
-              message_ty *tmp;
-              size_t i;
-
-              tmp = message_list_search (total_mlp, mp->msgctxt, mp->msgid);
-              if (tmp == NULL)
-                {
-                  tmp = message_alloc (mp->msgctxt, mp->msgid, mp->msgid_plural,
-                                       NULL, 0, &mp->pos);
-                  tmp->is_fuzzy = true; /* may be set to false later */
-                  for (i = 0; i < NFORMATS; i++)
-                    tmp->is_format[i] = undecided; /* may be set to yes/no later */
-                  tmp->range.min = - INT_MAX;
-                  tmp->range.max = - INT_MAX;
-                  tmp->do_wrap = yes; /* may be set to no later */
-                  tmp->obsolete = true; /* may be set to false later */
-                  tmp->alternative_count = 0;
-                  tmp->alternative = NULL;
-                  message_list_append (total_mlp, tmp);
-                }
-
-              if (!msgcomm_mode
-                  && ((!is_header (mp) && mp->is_fuzzy)
-                      || mp->msgstr[0] == '\0'))
-                /* Weak translation.  Counted as negative tmp->used.  */
+              struct catenate_occurrence *occ = &idp->occurrences[j];
+              struct catenate_entry *entry;
+
+              occ->entry = catenate_domain_lookup (cdp, mp, true);
+              occ->needed = false;
+              occ->weak =
+                (!msgcomm_mode
+                 && ((!is_header (mp) && mp->is_fuzzy)
+                     || mp->msgstr[0] == '\0'));
+              entry = &cdp->entries[occ->entry];
+
+              if (occ->weak)
+                /* Weak translation.  Counted as negative entry->used.  */
                 {
-                  if (tmp->used <= 0)
-                    tmp->used--;
+                  if (entry->used <= 0)
+                    entry->used--;
                 }
               else
-                /* Good translation.  Counted as positive tmp->used.  */
+                /* Good translation.  Counted as positive entry->used.  */
                 {
-                  if (tmp->used < 0)
-                    tmp->used = 0;
-                  tmp->used++;
+                  if (entry->used < 0)
+                    entry->used = 0;
+                  entry->used++;
                 }
-              mp->tmp = tmp;
             }
         }
+
+      /* Keep the contents of the input file for the second pass, unless it
+         is a large file that can be read again.  */
+      regular = (strcmp (files[n], "-") != 0
+                 && strcmp (files[n], "/dev/stdin") != 0
+                 && stat (files[n], &statbuf) == 0
+                 && S_ISREG (statbuf.st_mode));
+      if (regular
+          && statbuf.st_size > (off_t) (CATENATE_KEEP_INPUT_SIZE - kept_size))
+        {
+          input->mdlp = NULL;
+          msgdomain_list_free (mdlp);
+        }
+      else
+        {
+          input->mdlp = mdlp;
+          if (regular)
+            kept_size += statbuf.st_size;
+        }
     }
+  free (batch);
 
-  /* Remove messages that are not used and need not be converted.  */
+  /* Determine which translations are needed.  */
   for (n = 0; n < nfiles; n++)
     {
-      msgdomain_list_ty *mdlp = mdlps[n];
+      struct catenate_input *input = &inputs[n];
       size_t k;
 
-      for (k = 0; k < mdlp->nitems; k++)
+      for (k = 0; k < input->ndomains; k++)
         {
-          message_list_ty *mlp = mdlp->item[k]->messages;
+          struct catenate_input_domain *idp = &input->domains[k];
+          struct catenate_domain *cdp = &cdomains[idp->total_domain];
+          bool any_needed = false;
+
+          for (j = 0; j < idp->nmessages; j++)
+            {
+              struct catenate_occurrence *occ = &idp->occurrences[j];
+              struct catenate_entry *entry = &cdp->entries[occ->entry];
 
-          message_list_remove_if_not (mlp,
-                                      use_first
-                                      ? is_message_first_needed
-                                      : is_message_needed);
+              if (is_occurrence_needed (occ, entry))
+                {
+                  if (use_first)
+                    {
+                      /* The use_first logic.  */
+                      occ->needed = !entry->taken;
+                      entry->taken = true;
+                    }
+                  else
+                    occ->needed = true;
+                }
+              if (occ->needed)
+                any_needed = true;
+            }
 
-          /* If no messages are remaining, drop the charset.  */
-          if (mlp->nitems == 0)
+          /* If no messages are needed, drop the charset.  */
+          if (!any_needed)
             canon_charsets[n][k] = NULL;
         }
     }
-  {
-    size_t k;
-
-    for (k = 0; k < total_mdlp->nitems; k++)
-      {
-        message_list_ty *mlp = total_mdlp->item[k]->messages;
-
-        message_list_remove_if_not (mlp, is_message_selected);
-      }
-  }
 
   /* Determine the common known a-priori encoding, if any.  */
   if (nfiles > 0)
@@ -371,14 +706,14 @@ domain \"%s\" in input file '%s' doesn't contain a header entry with a charset s
       bool all_same_encoding = true;
 
       for (n = 1; n < nfiles; n++)
-        if (mdlps[n]->encoding != mdlps[0]->encoding)
+        if (inputs[n].encoding != inputs[0].encoding)
           {
             all_same_encoding = false;
             break;
           }
 
       if (all_same_encoding)
-        total_mdlp->encoding = mdlps[0]->encoding;
+        total_mdlp->encoding = inputs[0].encoding;
     }
 
   /* Determine the target encoding for the remaining messages.  */
@@ -403,10 +738,9 @@ domain \"%s\" in input file '%s' doesn't contain a header entry with a charset s
 
       for (n = 0; n < nfiles; n++)
         {
-          msgdomain_list_ty *mdlp = mdlps[n];
           size_t k;
 
-          for (k = 0; k < mdlp->nitems; k++)
+          for (k = 0; k < inputs[n].ndomains; k++)
             if (canon_charsets[n][k] != NULL)
               {
                 if (canon_charsets[n][k] == po_charset_ascii)
@@ -467,181 +801,298 @@ To select a different output encoding, use the --to-code option.\n\
         }
     }
 
-  /* Now convert the remaining messages to to_code.  */
-  if (canon_to_code != NULL)
-    for (n = 0; n < nfiles; n++)
-      {
-        msgdomain_list_ty *mdlp = mdlps[n];
-        size_t k;
-
-        for (k = 0; k < mdlp->nitems; k++)
-          if (canon_charsets[n][k] != NULL)
-            /* If the user hasn't given a to_code, don't bother doing a noop
-               conversion that would only replace the charset name in the
-               header entry with its canonical equivalent.  */
-            if (!(to_code == NULL && canon_charsets[n][k] == canon_to_code))
-              if (iconv_message_list (mdlp->item[k]->messages,
-                                      canon_charsets[n][k], canon_to_code,
-                                      files[n]))
-                {
-                  multiline_error (xstrdup (""),
-                                   xasprintf (_("\
-Conversion of file %s from %s encoding to %s encoding\n\
-changes some msgids or msgctxts.\n\
-Either change all msgids and msgctxts to be pure ASCII, or ensure they are\n\
-UTF-8 encoded from the beginning, i.e. already in your source code files.\n"),
-                                              files[n], canon_charsets[n][k],
-                                              canon_to_code));
-                  exit (EXIT_FAILURE);
-                }
-      }
 
-  /* Fill the resulting messages.  */
-  for (n = 0; n < nfiles; n++)
+  /* Second pass: Create the resulting messages, convert the needed
+     translations to to_code, and fill the resulting messages with them.
+     The input files are processed in batches; the conversions of the files
+     of a batch are done at the same time.  Each input file is released as
+     soon as it has been processed.  */
+  batch = XNMALLOC (CATENATE_BATCH_SIZE, msgdomain_list_ty *);
+  changed = XNMALLOC (CATENATE_BATCH_SIZE, size_t);
+  for (n0 = 0; n0 < nfiles; n0 += nbatch)
     {
-      msgdomain_list_ty *mdlp = mdlps[n];
-      size_t k;
+      long int b;
 
-      for (k = 0; k < mdlp->nitems; k++)
+      nbatch = (nfiles - n0 < CATENATE_BATCH_SIZE
+                ? nfiles - n0 : CATENATE_BATCH_SIZE);
+
+      reread_catalog_files (files + n0, nbatch, input_syntax, inputs + n0,
+                            total_mdlp, cdomains, batch);
+
+      for (n = n0; n < n0 + nbatch; n++)
         {
-          message_list_ty *mlp = mdlp->item[k]->messages;
+          msgdomain_list_ty *mdlp = batch[n - n0];
+          size_t k;
 
-          for (j = 0; j < mlp->nitems; j++)
+          for (k = 0; k < mdlp->nitems; k++)
             {
-              message_ty *mp = mlp->item[j];
-              message_ty *tmp = mp->tmp;
-              size_t i;
-
-              /* No need to discard unneeded weak translations here;
-                 they have already been filtered out above.  */
-              if (use_first || tmp->used == 1 || tmp->used == -1)
+              message_list_ty *mlp = mdlp->item[k]->messages;
+              struct catenate_input_domain *idp = &inputs[n].domains[k];
+              struct catenate_domain *cdp = &cdomains[idp->total_domain];
+              size_t kept;
+
+              /* Create the resulting messages in the order of their first
+                 occurrence, and remove the messages that are not needed.  */
+              kept = 0;
+              for (j = 0; j < mlp->nitems; j++)
                 {
-                  /* Copy mp, as only message, into tmp.  */
-                  tmp->msgstr = mp->msgstr;
-                  tmp->msgstr_len = mp->msgstr_len;
-                  tmp->pos = mp->pos;
-                  if (mp->comment)
-                    for (i = 0; i < mp->comment->nitems; i++)
-                      message_comment_append (tmp, mp->comment->item[i]);
-                  if (mp->comment_dot)
-                    for (i = 0; i < mp->comment_dot->nitems; i++)
-                      message_comment_dot_append (tmp,
-                                                  mp->comment_dot->item[i]);
-                  for (i = 0; i < mp->filepos_count; i++)
-                    message_comment_filepos (tmp, mp->filepos[i].file_name,
-                                             mp->filepos[i].line_number);
-                  tmp->is_fuzzy = mp->is_fuzzy;
-                  for (i = 0; i < NFORMATS; i++)
-                    tmp->is_format[i] = mp->is_format[i];
-                  tmp->range = mp->range;
-                  tmp->do_wrap = mp->do_wrap;
-                  tmp->prev_msgctxt = mp->prev_msgctxt;
-                  tmp->prev_msgid = mp->prev_msgid;
-                  tmp->prev_msgid_plural = mp->prev_msgid_plural;
-                  tmp->obsolete = mp->obsolete;
+                  message_ty *mp = mlp->item[j];
+                  struct catenate_occurrence *occ = &idp->occurrences[j];
+                  struct catenate_entry *entry = &cdp->entries[occ->entry];
+
+                  if (entry->tmp == NULL && is_entry_selected (entry))
+                    {
+                      message_ty *tmp;
+                      size_t i;
+
+                      tmp = message_alloc (mp->msgctxt, mp->msgid,
+                                           mp->msgid_plural, NULL, 0, &mp->pos);
+                      tmp->is_fuzzy = true; /* may be set to false later */
+                      for (i = 0; i < NFORMATS; i++)
+                        /* may be set to yes/no later */
+                        tmp->is_format[i] = undecided;
+                      tmp->range.min = - INT_MAX;
+                      tmp->range.max = - INT_MAX;
+                      tmp->do_wrap = yes; /* may be set to no later */
+                      tmp->obsolete = true; /* may be set to false later */
+                      tmp->alternative_count = 0;
+                      tmp->alternative = NULL;
+                      tmp->used = entry->used;
+                      entry->tmp = tmp;
+                    }
+
+                  if (occ->needed)
+                    {
+                      mp->tmp = entry->tmp;
+                      mlp->item[kept++] = mp;
+                    }
+                  else
+                    discard_message (mp, entry->tmp);
                 }
-              else if (msgcomm_mode)
+              mlp->nitems = kept;
+            }
+        }
+
+      /* Now convert the remaining messages to to_code.  */
+      #ifdef _OPENMP
+       #pragma omp parallel for schedule(dynamic)
+      #endif
+      for (b = 0; b < (long int) nbatch; b++)
+        {
+          msgdomain_list_ty *mdlp = batch[b];
+          size_t nn = n0 + b;
+          size_t k;
+
+          changed[b] = mdlp->nitems;
+          for (k = 0; k < mdlp->nitems; k++)
+            if (canon_to_code != NULL && canon_charsets[nn][k] != NULL)
+              /* If the user hasn't given a to_code, don't bother doing a noop
+                 conversion that would only replace the charset name in the
+                 header entry with its canonical equivalent.  */
+              if (!(to_code == NULL && canon_charsets[nn][k] == canon_to_code))
+                if (iconv_message_list (mdlp->item[k]->messages,
+                                        canon_charsets[nn][k], canon_to_code,
+                                        files[nn]))
+                  {
+                    changed[b] = k;
+                    break;
+                  }
+        }
+
+      for (n = n0; n < n0 + nbatch; n++)
+        {
+          msgdomain_list_ty *mdlp = batch[n - n0];
+          struct catenate_input *input = &inputs[n];
+          size_t k;
+
+          if (changed[n - n0] < mdlp->nitems)
+            {
+              k = changed[n - n0];
+              multiline_error (xstrdup (""),
+                               xasprintf (_("\
+Conversion of file %s from %s encoding to %s encoding\n\
+changes some msgids or msgctxts.\n\
+Either change all msgids and msgctxts to be pure ASCII, or ensure they are\n\
+UTF-8 encoded from the beginning, i.e. already in your source code files.\n"),
+                                          files[n], canon_charsets[n][k],
+                                          canon_to_code));
+              exit (EXIT_FAILURE);
+            }
+
+          for (k = 0; k < mdlp->nitems; k++)
+            {
+              message_list_ty *mlp = mdlp->item[k]->messages;
+              struct catenate_input_domain *idp = &input->domains[k];
+
+              /* Fill the resulting messages.  */
+              for (j = 0; j < mlp->nitems; j++)
                 {
-                  /* Copy mp, as only message, into tmp.  */
-                  if (tmp->msgstr == NULL)
+                  message_ty *mp = mlp->item[j];
+                  message_ty *tmp = mp->tmp;
+                  size_t i;
+
+                  /* No need to discard unneeded weak translations here;
+                     they have already been filtered out above.  */
+                  if (use_first || tmp->used == 1 || tmp->used == -1)
                     {
+                      /* Copy mp, as only message, into tmp.  */
                       tmp->msgstr = mp->msgstr;
                       tmp->msgstr_len = mp->msgstr_len;
                       tmp->pos = mp->pos;
+                      if (mp->comment)
+                        for (i = 0; i < mp->comment->nitems; i++)
+                          message_comment_append (tmp, mp->comment->item[i]);
+                      if (mp->comment_dot)
+                        for (i = 0; i < mp->comment_dot->nitems; i++)
+                          message_comment_dot_append (tmp,
+                                                      mp->comment_dot->item[i]);
+                      for (i = 0; i < mp->filepos_count; i++)
+                        message_comment_filepos (tmp, mp->filepos[i].file_name,
+                                                 mp->filepos[i].line_number);
                       tmp->is_fuzzy = mp->is_fuzzy;
+                      for (i = 0; i < NFORMATS; i++)
+                        tmp->is_format[i] = mp->is_format[i];
+                      tmp->range = mp->range;
+                      tmp->do_wrap = mp->do_wrap;
                       tmp->prev_msgctxt = mp->prev_msgctxt;
                       tmp->prev_msgid = mp->prev_msgid;
                       tmp->prev_msgid_plural = mp->prev_msgid_plural;
+                      tmp->obsolete = mp->obsolete;
                     }
-                  if (mp->comment && tmp->comment == NULL)
-                    for (i = 0; i < mp->comment->nitems; i++)
-                      message_comment_append (tmp, mp->comment->item[i]);
-                  if (mp->comment_dot && tmp->comment_dot == NULL)
-                    for (i = 0; i < mp->comment_dot->nitems; i++)
-                      message_comment_dot_append (tmp,
-                                                  mp->comment_dot->item[i]);
-                  for (i = 0; i < mp->filepos_count; i++)
-                    message_comment_filepos (tmp, mp->filepos[i].file_name,
-                                             mp->filepos[i].line_number);
-                  for (i = 0; i < NFORMATS; i++)
-                    if (tmp->is_format[i] == undecided)
-                      tmp->is_format[i] = mp->is_format[i];
-                  if (tmp->range.min == - INT_MAX
-                      && tmp->range.max == - INT_MAX)
-                    tmp->range = mp->range;
-                  else if (has_range_p (mp->range) && has_range_p (tmp->range))
-                    {
-                      if (mp->range.min < tmp->range.min)
-                        tmp->range.min = mp->range.min;
-                      if (mp->range.max > tmp->range.max)
-                        tmp->range.max = mp->range.max;
-                    }
-                  else
-                    {
-                      tmp->range.min = -1;
-                      tmp->range.max = -1;
-                    }
-                  if (tmp->do_wrap == undecided)
-                    tmp->do_wrap = mp->do_wrap;
-                  tmp->obsolete = false;
-                }
-              else
-                {
-                  /* Copy mp, among others, into tmp.  */
-                  char *id = xasprintf ("#-#-#-#-#  %s  #-#-#-#-#",
-                                        identifications[n][k]);
-                  size_t nbytes;
-
-                  if (tmp->alternative_count == 0)
-                    tmp->pos = mp->pos;
-
-                  i = tmp->alternative_count;
-                  nbytes = (i + 1) * sizeof (struct altstr);
-                  tmp->alternative = xrealloc (tmp->alternative, nbytes);
-                  tmp->alternative[i].msgstr = mp->msgstr;
-                  tmp->alternative[i].msgstr_len = mp->msgstr_len;
-                  tmp->alternative[i].msgstr_end =
-                    tmp->alternative[i].msgstr + tmp->alternative[i].msgstr_len;
-                  tmp->alternative[i].comment = mp->comment;
-                  tmp->alternative[i].comment_dot = mp->comment_dot;
-                  tmp->alternative[i].id = id;
-                  tmp->alternative_count = i + 1;
-
-                  for (i = 0; i < mp->filepos_count; i++)
-                    message_comment_filepos (tmp, mp->filepos[i].file_name,
-                                             mp->filepos[i].line_number);
-                  if (!mp->is_fuzzy)
-                    tmp->is_fuzzy = false;
-                  for (i = 0; i < NFORMATS; i++)
-                    if (mp->is_format[i] == yes)
-                      tmp->is_format[i] = yes;
-                    else if (mp->is_format[i] == no
-                             && tmp->is_format[i] == undecided)
-                      tmp->is_format[i] = no;
-                  if (tmp->range.min == - INT_MAX
-                      && tmp->range.max == - INT_MAX)
-                    tmp->range = mp->range;
-                  else if (has_range_p (mp->range) && has_range_p (tmp->range))
+                  else if (msgcomm_mode)
                     {
-                      if (mp->range.min < tmp->range.min)
-                        tmp->range.min = mp->range.min;
-                      if (mp->range.max > tmp->range.max)
-                        tmp->range.max = mp->range.max;
+                      /* Copy mp, as only message, into tmp.  */
+                      if (tmp->msgstr == NULL)
+                        {
+                          tmp->msgstr = mp->msgstr;
+                          tmp->msgstr_len = mp->msgstr_len;
+                          tmp->pos = mp->pos;
+                          tmp->is_fuzzy = mp->is_fuzzy;
+                          tmp->prev_msgctxt = mp->prev_msgctxt;
+                          tmp->prev_msgid = mp->prev_msgid;
+                          tmp->prev_msgid_plural = mp->prev_msgid_plural;
+                        }
+                      if (mp->comment && tmp->comment == NULL)
+                        for (i = 0; i < mp->comment->nitems; i++)
+                          message_comment_append (tmp, mp->comment->item[i]);
+                      if (mp->comment_dot && tmp->comment_dot == NULL)
+                        for (i = 0; i < mp->comment_dot->nitems; i++)
+                          message_comment_dot_append (tmp,
+                                                      mp->comment_dot->item[i]);
+                      for (i = 0; i < mp->filepos_count; i++)
+                        message_comment_filepos (tmp, mp->filepos[i].file_name,
+                                                 mp->filepos[i].line_number);
+                      for (i = 0; i < NFORMATS; i++)
+                        if (tmp->is_format[i] == undecided)
+                          tmp->is_format[i] = mp->is_format[i];
+                      if (tmp->range.min == - INT_MAX
+                          && tmp->range.max == - INT_MAX)
+                        tmp->range = mp->range;
+                      else if (has_range_p (mp->range)
+                               && has_range_p (tmp->range))
+                        {
+                          if (mp->range.min < tmp->range.min)
+                            tmp->range.min = mp->range.min;
+                          if (mp->range.max > tmp->range.max)
+                            tmp->range.max = mp->range.max;
+                        }
+                      else
+                        {
+                          tmp->range.min = -1;
+                          tmp->range.max = -1;
+                        }
+                      if (tmp->do_wrap == undecided)
+                        tmp->do_wrap = mp->do_wrap;
+                      tmp->obsolete = false;
                     }
                   else
                     {
-                      tmp->range.min = -1;
-                      tmp->range.max = -1;
+                      /* Copy mp, among others, into tmp.  */
+                      char *id = xasprintf ("#-#-#-#-#  %s  #-#-#-#-#",
+                                            identifications[n][k]);
+                      size_t nbytes;
+
+                      if (tmp->alternative_count == 0)
+                        tmp->pos = mp->pos;
+
+                      i = tmp->alternative_count;
+                      nbytes = (i + 1) * sizeof (struct altstr);
+                      tmp->alternative = xrealloc (tmp->alternative, nbytes);
+                      tmp->alternative[i].msgstr = mp->msgstr;
+                      tmp->alternative[i].msgstr_len = mp->msgstr_len;
+                      tmp->alternative[i].msgstr_end =
+                        tmp->alternative[i].msgstr
+                        + tmp->alternative[i].msgstr_len;
+                      tmp->alternative[i].comment = mp->comment;
+                      tmp->alternative[i].comment_dot = mp->comment_dot;
+                      tmp->alternative[i].id = id;
+                      tmp->alternative_count = i + 1;
+
+                      for (i = 0; i < mp->filepos_count; i++)
+                        message_comment_filepos (tmp, mp->filepos[i].file_name,
+                                                 mp->filepos[i].line_number);
+                      if (!mp->is_fuzzy)
+                        tmp->is_fuzzy = false;
+                      for (i = 0; i < NFORMATS; i++)
+                        if (mp->is_format[i] == yes)
+                          tmp->is_format[i] = yes;
+                        else if (mp->is_format[i] == no
+                                 && tmp->is_format[i] == undecided)
+                          tmp->is_format[i] = no;
+                      if (tmp->range.min == - INT_MAX
+                          && tmp->range.max == - INT_MAX)
+                        tmp->range = mp->range;
+                      else if (has_range_p (mp->range)
+                               && has_range_p (tmp->range))
+                        {
+                          if (mp->range.min < tmp->range.min)
+                            tmp->range.min = mp->range.min;
+                          if (mp->range.max > tmp->range.max)
+                            tmp->range.max = mp->range.max;
+                        }
+                      else
+                        {
+                          tmp->range.min = -1;
+                          tmp->range.max = -1;
+                        }
+                      if (mp->do_wrap == no)
+                        tmp->do_wrap = no;
+                      /* Don't fill tmp->prev_msgid in this case.  */
+                      if (!mp->obsolete)
+                        tmp->obsolete = false;
                     }
-                  if (mp->do_wrap == no)
-                    tmp->do_wrap = no;
-                  /* Don't fill tmp->prev_msgid in this case.  */
-                  if (!mp->obsolete)
-                    tmp->obsolete = false;
                 }
+
+              /* Release the input messages.  */
+              for (j = 0; j < mlp->nitems; j++)
+                discard_message (mlp->item[j], mlp->item[j]->tmp);
+              mlp->nitems = 0;
+              free (idp->occurrences);
             }
+
+          msgdomain_list_free (mdlp);
+          free (input->domains);
         }
     }
+  free (changed);
+  free (batch);
+  free (inputs);
+
+  /* Add the resulting messages to the result, in the order of their first
+     occurrence.  */
+  for (n = 0; n < ncdomains; n++)
+    {
+      struct catenate_domain *cdp = &cdomains[n];
+      message_list_ty *total_mlp = total_mdlp->item[n]->messages;
+
+      for (j = 0; j < cdp->nentries; j++)
+        if (cdp->entries[j].tmp != NULL)
+          message_list_append (total_mlp, cdp->entries[j].tmp);
+      free (cdp->entries);
+      hash_destroy (&cdp->htable);
+    }
+  free (cdomains);
+
   {
     size_t k;
 
@@ -23,8 +23,7 @@
 #include "msgl-check.h"
 
 #include <limits.h>
-#include <setjmp.h>
-#include <signal.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,6 +46,148 @@
 #define SIZEOF(a) (sizeof(a) / sizeof(a[0]))
 
 
+/* Reports of the checks, when they are not output immediately.  When the
+   messages of a list are checked in parallel, the reports of each message
+   are collected, and they are output afterwards in the order of the
+   messages.  */
+struct check_report
+{
+  int severity;
+  /* The second part, if the report refers to two messages.  */
+  bool is_pair;
+  const message_ty *message[2];
+  const char *filename[2];
+  size_t lineno[2];
+  size_t column[2];
+  int multiline_p[2];
+  char *message_text[2];
+};
+
+struct check_report_list
+{
+  struct check_report *item;
+  size_t nitems;
+  size_t nitems_max;
+};
+
+/* Where the reports of the current thread go, or NULL if they are output
+   immediately.  */
+static struct check_report_list *deferred_reports;
+#ifdef _OPENMP
+# pragma omp threadprivate (deferred_reports)
+#endif
+
+static struct check_report *
+check_report_add (struct check_report_list *list, int severity, bool is_pair)
+{
+  struct check_report *report;
+
+  if (list->nitems == list->nitems_max)
+    {
+      list->nitems_max = 2 * list->nitems_max + 1;
+      list->item =
+        (struct check_report *)
+        xrealloc (list->item, list->nitems_max * sizeof (struct check_report));
+    }
+  report = &list->item[list->nitems++];
+  report->severity = severity;
+  report->is_pair = is_pair;
+  return report;
+}
+
+/* Signal a problem, like po_xerror.  */
+static void
+check_xerror (int severity, const message_ty *message,
+              const char *filename, size_t lineno, size_t column,
+              int multiline_p, const char *message_text)
+{
+  if (deferred_reports != NULL)
+    {
+      struct check_report *report =
+        check_report_add (deferred_reports, severity, false);
+
+      report->message[0] = message;
+      report->filename[0] = filename;
+      report->lineno[0] = lineno;
+      report->column[0] = column;
+      report->multiline_p[0] = multiline_p;
+      report->message_text[0] = xstrdup (message_text);
+    }
+  else
+    po_xerror (severity, message, filename, lineno, column,
+               multiline_p, message_text);
+}
+
+/* Signal a problem that refers to two messages, like po_xerror2.  */
+static void
+check_xerror2 (int severity,
+               const message_ty *message1,
+               const char *filename1, size_t lineno1, size_t column1,
+               int multiline_p1, const char *message_text1,
+               const message_ty *message2,
+               const char *filename2, size_t lineno2, size_t column2,
+               int multiline_p2, const char *message_text2)
+{
+  if (deferred_reports != NULL)
+    {
+      struct check_report *report =
+        check_report_add (deferred_reports, severity, true);
+
+      report->message[0] = message1;
+      report->filename[0] = filename1;
+      report->lineno[0] = lineno1;
+      report->column[0] = column1;
+      report->multiline_p[0] = multiline_p1;
+      report->message_text[0] = xstrdup (message_text1);
+      report->message[1] = message2;
+      report->filename[1] = filename2;
+      report->lineno[1] = lineno2;
+      report->column[1] = column2;
+      report->multiline_p[1] = multiline_p2;
+      report->message_text[1] = xstrdup (message_text2);
+    }
+  else
+    po_xerror2 (severity,
+                message1, filename1, lineno1, column1,
+                multiline_p1, message_text1,
+                message2, filename2, lineno2, column2,
+                multiline_p2, message_text2);
+}
+
+/* Output the collected reports, and free them.  */
+static void
+check_report_flush (struct check_report_list *list)
+{
+  size_t i;
+
+  for (i = 0; i < list->nitems; i++)
+    {
+      struct check_report *report = &list->item[i];
+
+      if (report->is_pair)
+        {
+          po_xerror2 (report->severity,
+                      report->message[0], report->filename[0],
+                      report->lineno[0], report->column[0],
+                      report->multiline_p[0], report->message_text[0],
+                      report->message[1], report->filename[1],
+                      report->lineno[1], report->column[1],
+                      report->multiline_p[1], report->message_text[1]);
+          free (report->message_text[1]);
+        }
+      else
+        po_xerror (report->severity,
+                   report->message[0], report->filename[0],
+                   report->lineno[0], report->column[0],
+                   report->multiline_p[0], report->message_text[0]);
+      free (report->message_text[0]);
+    }
+  free (list->item);
+  list->item = NULL;
+  list->nitems = list->nitems_max = 0;
+}
+
+
 /* Evaluates the plural formula for min <= n <= max
    and returns the estimated number of times the value j was assumed.  */
 static unsigned int
@@ -65,21 +206,16 @@ plural_expression_histogram (const struct plural_distribution *self,
       unsigned long n;
       unsigned int count;
 
-      /* Protect against arithmetic exceptions.  */
-      install_sigfpe_handler ();
-
       count = 0;
       for (n = min; n <= max; n++)
         {
-          unsigned long val = plural_eval (expr, n);
+          bool div0 = false;
+          unsigned long val = plural_eval_checked (expr, n, &div0);
 
-          if (val == j)
+          if (!div0 && val == j)
             count++;
         }
 
-      /* End of protection against arithmetic exceptions.  */
-      uninstall_sigfpe_handler ();
-
       return count;
     }
   else
@@ -91,7 +227,9 @@ plural_expression_histogram (const struct plural_distribution *self,
    Signals the errors through po_xerror.
    Return the number of errors that were seen.
    If no errors, returns in *DISTRIBUTION information about the plural_eval
-   values distribution.  */
+   values distribution.
+   This function does not install a signal handler; it can be called in
+   several threads at the same time.  */
 int
 check_plural_eval (const struct expression *plural_expr,
                    unsigned long nplurals_value,
@@ -101,7 +239,8 @@ check_plural_eval (const struct expression *plural_expr,
   /* Do as if the plural formula assumes a value N infinitely often if it
      assumes it at least 5 times.  */
 #define OFTEN 5
-  unsigned char * volatile array;
+  unsigned char *array;
+  unsigned long n;
 
   /* Allocate a distribution array.  */
   if (nplurals_value <= 100)
@@ -110,99 +249,56 @@ check_plural_eval (const struct expression *plural_expr,
     /* nplurals_value is nonsense.  Don't risk an out-of-memory.  */
     array = NULL;
 
-  if (sigsetjmp (sigfpe_exit, 1) == 0)
+  for (n = 0; n <= 1000; n++)
     {
-      unsigned long n;
-
-      /* Protect against arithmetic exceptions.  */
-      install_sigfpe_handler ();
+      bool div0 = false;
+      unsigned long val = plural_eval_checked (plural_expr, n, &div0);
 
-      for (n = 0; n <= 1000; n++)
+      if (div0)
         {
-          unsigned long val = plural_eval (plural_expr, n);
-
-          if ((long) val < 0)
-            {
-              /* End of protection against arithmetic exceptions.  */
-              uninstall_sigfpe_handler ();
-
-              po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false,
-                         _("plural expression can produce negative values"));
-              free (array);
-              return 1;
-            }
-          else if (val >= nplurals_value)
-            {
-              char *msg;
-
-              /* End of protection against arithmetic exceptions.  */
-              uninstall_sigfpe_handler ();
-
-              msg = xasprintf (_("nplurals = %lu but plural expression can produce values as large as %lu"),
-                               nplurals_value, val);
-              po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, msg);
-              free (msg);
-              free (array);
-              return 1;
-            }
-
-          if (array != NULL && array[val] < OFTEN)
-            array[val]++;
+          check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false,
+                        _("plural expression can produce division by zero"));
+          free (array);
+          return 1;
         }
-
-      /* End of protection against arithmetic exceptions.  */
-      uninstall_sigfpe_handler ();
-
-      /* Normalize the array[val] statistics.  */
-      if (array != NULL)
+      else if ((long) val < 0)
         {
-          unsigned long val;
-
-          for (val = 0; val < nplurals_value; val++)
-            array[val] = (array[val] == OFTEN ? 1 : 0);
+          check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false,
+                        _("plural expression can produce negative values"));
+          free (array);
+          return 1;
         }
+      else if (val >= nplurals_value)
+        {
+          char *msg;
 
-      distribution->expr = plural_expr;
-      distribution->often = array;
-      distribution->often_length = (array != NULL ? nplurals_value : 0);
-      distribution->histogram = plural_expression_histogram;
+          msg = xasprintf (_("nplurals = %lu but plural expression can produce values as large as %lu"),
+                           nplurals_value, val);
+          check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, msg);
+          free (msg);
+          free (array);
+          return 1;
+        }
 
-      return 0;
+      if (array != NULL && array[val] < OFTEN)
+        array[val]++;
     }
-  else
-    {
-      /* Caught an arithmetic exception.  */
-      const char *msg;
 
-      /* End of protection against arithmetic exceptions.  */
-      uninstall_sigfpe_handler ();
-
-#if USE_SIGINFO
-      switch (sigfpe_code)
-#endif
-        {
-#if USE_SIGINFO
-# ifdef FPE_INTDIV
-        case FPE_INTDIV:
-          msg = _("plural expression can produce division by zero");
-          break;
-# endif
-# ifdef FPE_INTOVF
-        case FPE_INTOVF:
-          msg = _("plural expression can produce integer overflow");
-          break;
-# endif
-        default:
-#endif
-          msg = _("plural expression can produce arithmetic exceptions, possibly division by zero");
-        }
+  /* Normalize the array[val] statistics.  */
+  if (array != NULL)
+    {
+      unsigned long val;
 
-      po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, msg);
+      for (val = 0; val < nplurals_value; val++)
+        array[val] = (array[val] == OFTEN ? 1 : 0);
+    }
 
-      free (array);
+  distribution->expr = plural_expr;
+  distribution->often = array;
+  distribution->often_length = (array != NULL ? nplurals_value : 0);
+  distribution->histogram = plural_expression_histogram;
 
-      return 1;
-    }
+  return 0;
 #undef OFTEN
 }
 
@@ -363,16 +459,16 @@ check_plural (message_list_ty *mlp,
           if (help != NULL)
             {
               char *msg2ext = xasprintf ("%s\n%s", msg2, help);
-              po_xerror2 (PO_SEVERITY_ERROR,
-                          has_plural, NULL, 0, 0, false, msg1,
-                          header, NULL, 0, 0, true, msg2ext);
+              check_xerror2 (PO_SEVERITY_ERROR,
+                             has_plural, NULL, 0, 0, false, msg1,
+                             header, NULL, 0, 0, true, msg2ext);
               free (msg2ext);
               free (help);
             }
           else
-            po_xerror2 (PO_SEVERITY_ERROR,
-                        has_plural, NULL, 0, 0, false, msg1,
-                        header, NULL, 0, 0, false, msg2);
+            check_xerror2 (PO_SEVERITY_ERROR,
+                           has_plural, NULL, 0, 0, false, msg1,
+                           header, NULL, 0, 0, false, msg2);
 
           seen_errors++;
         }
@@ -387,16 +483,16 @@ check_plural (message_list_ty *mlp,
           if (help != NULL)
             {
               char *msg2ext = xasprintf ("%s\n%s", msg2, help);
-              po_xerror2 (PO_SEVERITY_ERROR,
-                          has_plural, NULL, 0, 0, false, msg1,
-                          header, NULL, 0, 0, true, msg2ext);
+              check_xerror2 (PO_SEVERITY_ERROR,
+                             has_plural, NULL, 0, 0, false, msg1,
+                             header, NULL, 0, 0, true, msg2ext);
               free (msg2ext);
               free (help);
             }
           else
-            po_xerror2 (PO_SEVERITY_ERROR,
-                        has_plural, NULL, 0, 0, false, msg1,
-                        header, NULL, 0, 0, false, msg2);
+            check_xerror2 (PO_SEVERITY_ERROR,
+                           has_plural, NULL, 0, 0, false, msg1,
+                           header, NULL, 0, 0, false, msg2);
 
           seen_errors++;
         }
@@ -423,13 +519,14 @@ check_plural (message_list_ty *mlp,
               if (help != NULL)
                 {
                   char *msgext = xasprintf ("%s\n%s", msg, help);
-                  po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, true,
-                             msgext);
+                  check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, true,
+                                msgext);
                   free (msgext);
                   free (help);
                 }
               else
-                po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, msg);
+                check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false,
+                              msg);
 
               seen_errors++;
             }
@@ -445,13 +542,14 @@ check_plural (message_list_ty *mlp,
               if (help != NULL)
                 {
                   char *msgext = xasprintf ("%s\n%s", msg, help);
-                  po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, true,
-                             msgext);
+                  check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, true,
+                                msgext);
                   free (msgext);
                   free (help);
                 }
               else
-                po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, msg);
+                check_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false,
+                              msg);
 
               seen_errors++;
             }
@@ -475,9 +573,9 @@ check_plural (message_list_ty *mlp,
                                          "but some messages have only %lu plural forms",
                                          min_nplurals),
                                min_nplurals);
-                  po_xerror2 (PO_SEVERITY_ERROR,
-                              header, NULL, 0, 0, false, msg1,
-                              min_pos, NULL, 0, 0, false, msg2);
+                  check_xerror2 (PO_SEVERITY_ERROR,
+                                 header, NULL, 0, 0, false, msg1,
+                                 min_pos, NULL, 0, 0, false, msg2);
                   free (msg2);
                   free (msg1);
                   seen_errors++;
@@ -491,9 +589,9 @@ check_plural (message_list_ty *mlp,
                                          "but some messages have %lu plural forms",
                                          max_nplurals),
                                max_nplurals);
-                  po_xerror2 (PO_SEVERITY_ERROR,
-                              header, NULL, 0, 0, false, msg1,
-                              max_pos, NULL, 0, 0, false, msg2);
+                  check_xerror2 (PO_SEVERITY_ERROR,
+                                 header, NULL, 0, 0, false, msg1,
+                                 max_pos, NULL, 0, 0, false, msg2);
                   free (msg2);
                   free (msg1);
                   seen_errors++;
@@ -510,8 +608,8 @@ check_plural (message_list_ty *mlp,
     {
       if (has_plural != NULL)
         {
-          po_xerror (PO_SEVERITY_ERROR, has_plural, NULL, 0, 0, false,
-                     _("message catalog has plural form translations, but lacks a header entry with \"Plural-Forms: nplurals=INTEGER; plural=EXPRESSION;\""));
+          check_xerror (PO_SEVERITY_ERROR, has_plural, NULL, 0, 0, false,
+                        _("message catalog has plural form translations, but lacks a header entry with \"Plural-Forms: nplurals=INTEGER; plural=EXPRESSION;\""));
           seen_errors++;
         }
      no_plural:
@@ -542,6 +640,9 @@ check_plural (message_list_ty *mlp,
 /* Signal an error when checking format strings.  */
 static const message_ty *curr_mp;
 static lex_pos_ty curr_msgid_pos;
+#ifdef _OPENMP
+# pragma omp threadprivate (curr_mp, curr_msgid_pos)
+#endif
 static void
 formatstring_error_logger (const char *format, ...)
 #if defined __GNUC__ && ((__GNUC__ == 2 && __GNUC_MINOR__ >= 7) || __GNUC__ > 2)
@@ -558,9 +659,9 @@ formatstring_error_logger (const char *format, ...)
   if (vasprintf (&msg, format, args) < 0)
     error (EXIT_FAILURE, 0, _("memory exhausted"));
   va_end (args);
-  po_xerror (PO_SEVERITY_ERROR,
-             curr_mp, curr_msgid_pos.file_name, curr_msgid_pos.line_number,
-             (size_t)(-1), false, msg);
+  check_xerror (PO_SEVERITY_ERROR, curr_mp,
+                curr_msgid_pos.file_name, curr_msgid_pos.line_number,
+                (size_t)(-1), false, msg);
   free (msg);
 }
 
@@ -606,9 +707,9 @@ check_pair (const message_ty *mp,
 
           if (TEST_NEWLINE(msgid_plural) != has_newline)
             {
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, _("\
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, _("\
 'msgid' and 'msgid_plural' entries do not both begin with '\\n'"));
               seen_errors++;
             }
@@ -618,9 +719,9 @@ check_pair (const message_ty *mp,
                 char *msg =
                   xasprintf (_("\
 'msgid' and 'msgstr[%u]' entries do not both begin with '\\n'"), j);
-                po_xerror (PO_SEVERITY_ERROR,
-                           mp, msgid_pos->file_name, msgid_pos->line_number,
-                           (size_t)(-1), false, msg);
+                check_xerror (PO_SEVERITY_ERROR,
+                              mp, msgid_pos->file_name, msgid_pos->line_number,
+                              (size_t)(-1), false, msg);
                 free (msg);
                 seen_errors++;
               }
@@ -629,9 +730,9 @@ check_pair (const message_ty *mp,
         {
           if (TEST_NEWLINE(msgstr) != has_newline)
             {
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, _("\
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, _("\
 'msgid' and 'msgstr' entries do not both begin with '\\n'"));
               seen_errors++;
             }
@@ -647,9 +748,9 @@ check_pair (const message_ty *mp,
 
           if (TEST_NEWLINE(msgid_plural) != has_newline)
             {
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, _("\
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, _("\
 'msgid' and 'msgid_plural' entries do not both end with '\\n'"));
               seen_errors++;
             }
@@ -659,9 +760,9 @@ check_pair (const message_ty *mp,
                 char *msg =
                   xasprintf (_("\
 'msgid' and 'msgstr[%u]' entries do not both end with '\\n'"), j);
-                po_xerror (PO_SEVERITY_ERROR,
-                           mp, msgid_pos->file_name, msgid_pos->line_number,
-                           (size_t)(-1), false, msg);
+                check_xerror (PO_SEVERITY_ERROR,
+                              mp, msgid_pos->file_name, msgid_pos->line_number,
+                              (size_t)(-1), false, msg);
                 free (msg);
                 seen_errors++;
               }
@@ -670,9 +771,9 @@ check_pair (const message_ty *mp,
         {
           if (TEST_NEWLINE(msgstr) != has_newline)
             {
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, _("\
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, _("\
 'msgid' and 'msgstr' entries do not both end with '\\n'"));
               seen_errors++;
             }
@@ -682,9 +783,9 @@ check_pair (const message_ty *mp,
 
   if (check_compatibility && msgid_plural != NULL)
     {
-      po_xerror (PO_SEVERITY_ERROR,
-                 mp, msgid_pos->file_name, msgid_pos->line_number,
-                 (size_t)(-1), false, _("\
+      check_xerror (PO_SEVERITY_ERROR,
+                    mp, msgid_pos->file_name, msgid_pos->line_number,
+                    (size_t)(-1), false, _("\
 plural handling is a GNU gettext extension"));
       seen_errors++;
     }
@@ -728,9 +829,9 @@ plural handling is a GNU gettext extension"));
               char *msg =
                 xasprintf (_("msgstr lacks the keyboard accelerator mark '%c'"),
                            accelerator_char);
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, msg);
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, msg);
               free (msg);
             }
           else if (count > 1)
@@ -738,9 +839,9 @@ plural handling is a GNU gettext extension"));
               char *msg =
                 xasprintf (_("msgstr has too many keyboard accelerator marks '%c'"),
                            accelerator_char);
-              po_xerror (PO_SEVERITY_ERROR,
-                         mp, msgid_pos->file_name, msgid_pos->line_number,
-                         (size_t)(-1), false, msg);
+              check_xerror (PO_SEVERITY_ERROR,
+                            mp, msgid_pos->file_name, msgid_pos->line_number,
+                            (size_t)(-1), false, msg);
               free (msg);
             }
         }
@@ -800,7 +901,7 @@ check_header_entry (const message_ty *mp, const char *msgstr_string)
 		      char *msg =
 			xasprintf (_("header field '%s' still has the initial default value\n"),
 				   field);
-		      po_xerror (severity, mp, NULL, 0, 0, true, msg);
+		      check_xerror (severity, mp, NULL, 0, 0, true, msg);
 		      free (msg);
                     }
                 }
@@ -815,7 +916,7 @@ check_header_entry (const message_ty *mp, const char *msgstr_string)
           char *msg =
             xasprintf (_("header field '%s' missing in header\n"),
                        field);
-          po_xerror (severity, mp, NULL, 0, 0, true, msg);
+          check_xerror (severity, mp, NULL, 0, 0, true, msg);
           free (msg);
         }
     }
@@ -850,7 +951,9 @@ check_message (const message_ty *mp,
 
 
 /* Perform all checks on a message list.
-   Return the number of errors that were seen.  */
+   Return the number of errors that were seen.
+   The messages are checked in parallel, and the errors are reported in the
+   order of the messages.  */
 int
 check_message_list (message_list_ty *mlp,
                     int ignore_untranslated_messages,
@@ -863,31 +966,56 @@ check_message_list (message_list_ty *mlp,
 {
   int seen_errors = 0;
   struct plural_distribution distribution;
-  size_t j;
+  struct check_report_list *reports;
+  long int j;
 
   distribution.expr = NULL;
   distribution.often = NULL;
   distribution.often_length = 0;
   distribution.histogram = NULL;
 
+  /* reports[0] holds the reports about the header entry, reports[j + 1]
+     those about mlp->item[j].  */
+  reports = XCALLOC (mlp->nitems + 1, struct check_report_list);
+
   if (check_header)
-    seen_errors += check_plural (mlp, ignore_untranslated_messages,
-                                 ignore_fuzzy_messages, &distribution);
+    {
+      deferred_reports = &reports[0];
+      seen_errors += check_plural (mlp, ignore_untranslated_messages,
+                                   ignore_fuzzy_messages, &distribution);
+      deferred_reports = NULL;
+    }
 
-  for (j = 0; j < mlp->nitems; j++)
+  #ifdef _OPENMP
+   #pragma omp parallel for schedule(dynamic, 64) reduction(+:seen_errors)
+  #endif
+  for (j = 0; j < (long int) mlp->nitems; j++)
     {
       message_ty *mp = mlp->item[j];
 
       if (!mp->obsolete
           && !(ignore_untranslated_messages && mp->msgstr[0] == '\0')
           && !(ignore_fuzzy_messages && (mp->is_fuzzy && !is_header (mp))))
-        seen_errors += check_message (mp, &mp->pos,
-                                      check_newlines,
-                                      check_format_strings,
-                                      &distribution,
-                                      check_header, check_compatibility,
-                                      check_accelerators, accelerator_char);
+        {
+          deferred_reports = &reports[j + 1];
+          seen_errors += check_message (mp, &mp->pos,
+                                        check_newlines,
+                                        check_format_strings,
+                                        &distribution,
+                                        check_header, check_compatibility,
+                                        check_accelerators, accelerator_char);
+          deferred_reports = NULL;
+        }
     }
 
+  /* Output the reports.  Several message lists may be checked at the same
+     time; keep the reports of each list together.  */
+  #ifdef _OPENMP
+   #pragma omp critical (check_message_list)
+  #endif
+  for (j = 0; j <= (long int) mlp->nitems; j++)
+    check_report_flush (&reports[j]);
+  free (reports);
+
   return seen_errors;
 }
@@ -36,14 +36,18 @@
 #include "relocatable.h"
 #include "basename.h"
 #include "message.h"
+#include "open-catalog.h"
 #include "read-catalog.h"
 #include "read-po.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
+#include "read-binary.h"
 #include "write-catalog.h"
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "write-binary.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "format.h"
 #include "xalloc.h"
@@ -99,6 +103,11 @@ static message_list_list_ty *compendiums;
 /* List of corresponding filenames.  */
 static string_list_ty *compendium_filenames;
 
+/* Names of the user-specified compendium files, and the names under which
+   they were found, until they are read.  */
+static string_list_ty *compendium_file_list;
+static string_list_ty *compendium_real_file_list;
+
 /* Update mode.  */
 static bool update_mode = false;
 static const char *version_control_string;
@@ -116,6 +125,7 @@ static const struct option long_options[] =
   { "force-po", no_argument, &force_po, 1 },
   { "help", no_argument, NULL, 'h' },
   { "indent", no_argument, NULL, 'i' },
+  { "input-format", required_argument, NULL, CHAR_MAX + 11 },
   { "lang", required_argument, NULL, CHAR_MAX + 8 },
   { "multi-domain", no_argument, NULL, 'm' },
   { "no-escape", no_argument, NULL, 'e' },
@@ -123,6 +133,7 @@ static const struct option long_options[] =
   { "no-location", no_argument, &line_comment, 0 },
   { "no-wrap", no_argument, NULL, CHAR_MAX + 4 },
   { "output-file", required_argument, NULL, 'o' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 12 },
   { "previous", no_argument, NULL, CHAR_MAX + 7 },
   { "properties-input", no_argument, NULL, 'P' },
   { "properties-output", no_argument, NULL, 'p' },
@@ -159,6 +170,7 @@ static void usage (int status)
 #endif
 ;
 static void compendium (const char *filename);
+static void read_compendiums (void);
 static void msgdomain_list_stablesort_by_obsolete (msgdomain_list_ty *mdlp);
 static msgdomain_list_ty *merge (const char *fn1, const char *fn2,
                                  catalog_input_format_ty input_syntax,
@@ -331,6 +343,14 @@ main (int argc, char **argv)
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 11: /* --input-format */
+        input_syntax = catalog_input_format_by_name (optarg);
+        break;
+
+      case CHAR_MAX + 12: /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         break;
@@ -406,6 +426,12 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   /* In update mode, --stringtable-input implies --stringtable-output.  */
   if (update_mode && input_syntax == &input_format_stringtable)
     output_syntax = &output_format_stringtable;
+  /* In update mode, --input-format=binary implies --output-format=binary.  */
+  if (update_mode && input_syntax == &input_format_binary)
+    output_syntax = &output_format_binary;
+
+  /* Read the compendiums.  */
+  read_compendiums ();
 
   /* Merge the two files.  */
   result = merge (argv[optind], argv[optind + 1], input_syntax, &def);
@@ -559,6 +585,9 @@ Input file syntax:\n"));
       printf (_("\
       --stringtable-input     input files are in NeXTstep/GNUstep .strings\n\
                               syntax\n"));
+      printf (_("\
+      --input-format=FORMAT   input files are in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
       printf ("\n");
       printf (_("\
 Output details:\n"));
@@ -589,6 +618,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -624,20 +656,60 @@ Informative output:\n"));
 static void
 compendium (const char *filename)
 {
-  msgdomain_list_ty *mdlp;
-  size_t k;
+  char *real_filename;
+
+  /* Search the file now, so that a -D option given after this one doesn't
+     apply to it.  */
+  if (strcmp (filename, "-") == 0 || strcmp (filename, "/dev/stdin") == 0)
+    real_filename = xstrdup (filename);
+  else
+    fclose (open_catalog_file (filename, &real_filename, true));
 
-  mdlp = read_catalog_file (filename, &input_format_po);
-  if (compendiums == NULL)
+  if (compendium_file_list == NULL)
     {
-      compendiums = message_list_list_alloc ();
-      compendium_filenames = string_list_alloc ();
+      compendium_file_list = string_list_alloc ();
+      compendium_real_file_list = string_list_alloc ();
     }
-  for (k = 0; k < mdlp->nitems; k++)
+  string_list_append (compendium_file_list, filename);
+  string_list_append (compendium_real_file_list, real_filename);
+  free (real_filename);
+}
+
+
+/* Read the compendium files given on the command line, several of them at
+   the same time.  */
+static void
+read_compendiums ()
+{
+  void *saved_directory_list;
+  msgdomain_list_ty **mdlps;
+  size_t n, k;
+
+  if (compendium_file_list == NULL)
+    return;
+
+  /* Temporarily reset the directory list to empty, because the files have
+     already been searched.  */
+  saved_directory_list = dir_list_save_reset ();
+  mdlps =
+    read_catalog_files ((const char * const *) compendium_real_file_list->item,
+                        compendium_real_file_list->nitems, &input_format_po);
+  dir_list_restore (saved_directory_list);
+
+  compendiums = message_list_list_alloc ();
+  compendium_filenames = string_list_alloc ();
+  for (n = 0; n < compendium_file_list->nitems; n++)
     {
-      message_list_list_append (compendiums, mdlp->item[k]->messages);
-      string_list_append (compendium_filenames, filename);
+      msgdomain_list_ty *mdlp = mdlps[n];
+
+      for (k = 0; k < mdlp->nitems; k++)
+        {
+          message_list_list_append (compendiums, mdlp->item[k]->messages);
+          string_list_append (compendium_filenames,
+                              compendium_file_list->item[n]);
+        }
     }
+  free (mdlps);
 }
 
 
@@ -2027,13 +2099,17 @@ merge (const char *fn1, const char *fn2, catalog_input_format_ty input_syntax,
 
   /* Report some statistics.  */
   if (verbosity_level > 0)
-    fprintf (stderr, _("%s\
+    {
+      fprintf (stderr, _("%s\
 Read %ld old + %ld reference, \
 merged %ld, fuzzied %ld, missing %ld, obsolete %ld.\n"),
-             !quiet && verbosity_level <= 1 ? "\n" : "",
-             (long) def->nitems, (long) ref->nitems,
-             (long) stats.merged, (long) stats.fuzzied, (long) stats.missing,
-             (long) stats.obsolete);
+               !quiet && verbosity_level <= 1 ? "\n" : "",
+               (long) def->nitems, (long) ref->nitems,
+               (long) stats.merged, (long) stats.fuzzied,
+               (long) stats.missing, (long) stats.obsolete);
+      if (verbosity_level > 1)
+        print_formatstring_cache_statistics ();
+    }
   else if (!quiet)
     fputs (_(" done.\n"), stderr);
 
@@ -23,7 +23,6 @@
 #include "plural-eval.h"
 
 #include <stddef.h>
-#include <signal.h>
 
 #include "plural-exp.h"
 
@@ -35,59 +34,90 @@
 #include "eval-plural.h"
 
 
-/* Exit point.  Must be set before calling install_sigfpe_handler().  */
-sigjmp_buf sigfpe_exit;
-
-#if USE_SIGINFO
-
-/* Additional information that is set before sigfpe_exit is invoked.  */
-int sigfpe_code;
-
-/* Signal handler called in case of arithmetic exception (e.g. division
-   by zero) during plural_eval.  */
-static void
-sigfpe_handler (int sig, siginfo_t *sip, void *scp)
+/* Evaluate the plural expression, catching divisions by zero.  */
+unsigned long int
+plural_eval_checked (const struct expression *pexp, unsigned long int n,
+                     bool *div0p)
 {
-  sigfpe_code = sip->si_code;
-  siglongjmp (sigfpe_exit, 1);
-}
-
-#else
-
-/* Signal handler called in case of arithmetic exception (e.g. division
-   by zero) during plural_eval.  */
-static void
-sigfpe_handler (int sig)
-{
-  siglongjmp (sigfpe_exit, 1);
-}
-
-#endif
-
-void
-install_sigfpe_handler (void)
-{
-#if USE_SIGINFO
-  struct sigaction action;
-  action.sa_sigaction = sigfpe_handler;
-  action.sa_flags = SA_SIGINFO;
-  sigemptyset (&action.sa_mask);
-  sigaction (SIGFPE, &action, (struct sigaction *) NULL);
-#else
-  signal (SIGFPE, sigfpe_handler);
-#endif
-}
-
-void
-uninstall_sigfpe_handler (void)
-{
-#if USE_SIGINFO
-  struct sigaction action;
-  action.sa_handler = SIG_DFL;
-  action.sa_flags = 0;
-  sigemptyset (&action.sa_mask);
-  sigaction (SIGFPE, &action, (struct sigaction *) NULL);
-#else
-  signal (SIGFPE, SIG_DFL);
-#endif
+  switch (pexp->nargs)
+    {
+    case 0:
+      switch (pexp->operation)
+        {
+        case var:
+          return n;
+        case num:
+          return pexp->val.num;
+        default:
+          break;
+        }
+      /* NOTREACHED */
+      break;
+    case 1:
+      {
+        /* pexp->operation must be lnot.  */
+        unsigned long int arg =
+          plural_eval_checked (pexp->val.args[0], n, div0p);
+        return ! arg;
+      }
+    case 2:
+      {
+        unsigned long int leftarg =
+          plural_eval_checked (pexp->val.args[0], n, div0p);
+        if (pexp->operation == lor)
+          return leftarg || plural_eval_checked (pexp->val.args[1], n, div0p);
+        else if (pexp->operation == land)
+          return leftarg && plural_eval_checked (pexp->val.args[1], n, div0p);
+        else
+          {
+            unsigned long int rightarg =
+              plural_eval_checked (pexp->val.args[1], n, div0p);
+
+            switch (pexp->operation)
+              {
+              case mult:
+                return leftarg * rightarg;
+              case divide:
+              case module:
+                if (rightarg == 0)
+                  {
+                    *div0p = true;
+                    return 0;
+                  }
+                return (pexp->operation == divide
+                        ? leftarg / rightarg
+                        : leftarg % rightarg);
+              case plus:
+                return leftarg + rightarg;
+              case minus:
+                return leftarg - rightarg;
+              case less_than:
+                return leftarg < rightarg;
+              case greater_than:
+                return leftarg > rightarg;
+              case less_or_equal:
+                return leftarg <= rightarg;
+              case greater_or_equal:
+                return leftarg >= rightarg;
+              case equal:
+                return leftarg == rightarg;
+              case not_equal:
+                return leftarg != rightarg;
+              default:
+                break;
+              }
+          }
+        /* NOTREACHED */
+        break;
+      }
+    case 3:
+      {
+        /* pexp->operation must be qmop.  */
+        unsigned long int boolarg =
+          plural_eval_checked (pexp->val.args[0], n, div0p);
+        return plural_eval_checked (pexp->val.args[boolarg ? 1 : 2], n, div0p);
+      }
+    }
+  /* NOTREACHED */
+  return 0;
 }
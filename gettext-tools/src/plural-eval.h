@@ -23,41 +23,20 @@
    declaration of extract_plural_expression() and plural_eval().  */
 #include "plural-exp.h"
 
+#include <stdbool.h>
 
-/* Protection against signals during plural evaluation.  */
-
-#include <setjmp.h>
-
-/* Some platforms don't have the sigjmp_buf type in <setjmp.h>.  */
-#if defined _MSC_VER || defined __MINGW32__
-/* Native Woe32 API.  */
-# define sigjmp_buf jmp_buf
-# define sigsetjmp(env,savesigs) setjmp (env)
-# define siglongjmp longjmp
-#endif
-
-/* We use siginfo to get precise information about the signal.
-   But siginfo doesn't work on Irix 6.5 and on Cygwin 2005.  */
-#if HAVE_SIGINFO && !defined (__sgi) && !defined (__CYGWIN__)
-# define USE_SIGINFO 1
-#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* Exit point.  Must be set before calling install_sigfpe_handler().  */
-extern sigjmp_buf sigfpe_exit;
-
-#if USE_SIGINFO
-/* Additional information that is set before sigfpe_exit is invoked.  */
-extern int sigfpe_code;
-#endif
-
-/* Protect against signals during plural evaluation.  Must be called around
-   calls to plural_eval().  Must be called in pairs.  */
-extern void install_sigfpe_handler (void);
-extern void uninstall_sigfpe_handler (void);
+/* Evaluate the plural expression PEXP for N, like plural_eval(), but
+   without arithmetic exceptions: a division by zero sets *DIV0P to true
+   and yields 0.  This function may be called in several threads at the
+   same time.  */
+extern unsigned long int plural_eval_checked (const struct expression *pexp,
+                                              unsigned long int n,
+                                              bool *div0p);
 
 #ifdef __cplusplus
 }
@@ -64,15 +64,24 @@ extern character_iterator_t po_charset_character_iterator (const char *canon_cha
 
 
 /* The PO file's encoding, as specified in the header entry.  */
-extern DLL_VARIABLE const char *po_lex_charset;
+extern const char *po_lex_charset;
 
 #if HAVE_ICONV
 /* Converter from the PO file's encoding to UTF-8.  */
-extern DLL_VARIABLE iconv_t po_lex_iconv;
+extern iconv_t po_lex_iconv;
 #endif
 /* If no converter is available, some information about the structure of the
    PO file's encoding.  */
-extern DLL_VARIABLE bool po_lex_weird_cjk;
+extern bool po_lex_weird_cjk;
+/* Each thread parses its own PO file or part of a PO file.  These variables
+   are therefore private to libgettextsrc.  */
+#ifdef _OPENMP
+# if HAVE_ICONV
+#  pragma omp threadprivate (po_lex_charset, po_lex_iconv, po_lex_weird_cjk)
+# else
+#  pragma omp threadprivate (po_lex_charset, po_lex_weird_cjk)
+# endif
+#endif
 
 /* Initialize the PO file's encoding.  */
 extern void po_lex_charset_init (void);
@@ -51,7 +51,6 @@
 #define yyparse po_gram_parse
 #define yylex   po_gram_lex
 #define yyerror po_gram_error
-#define yylval  po_gram_lval
 #define yychar  po_gram_char
 #define yydebug po_gram_debug
 #define yypact  po_gram_pact
@@ -87,6 +86,9 @@
 #define yycheck  po_gram_yycheck
 
 static long plural_counter;
+#ifdef _OPENMP
+# pragma omp threadprivate (plural_counter)
+#endif
 
 #define check_obsolete(value1,value2) \
   if ((value1).obsolete != (value2).obsolete) \
@@ -123,6 +125,10 @@ do_callback_message (char *msgctxt,
 
 %}
 
+/* The parser is reentrant, so that several threads can parse different
+   PO files or parts of a PO file at the same time.  */
+%pure_parser
+
 %token COMMENT
 %token DOMAIN
 %token JUNK
@@ -31,6 +31,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if HAVE_MMAP
+# include <sys/mman.h>
+#endif
 
 #if HAVE_ICONV
 # include <iconv.h>
@@ -57,11 +63,6 @@
 # include "unistr.h"
 #endif
 
-#if HAVE_DECL_GETC_UNLOCKED
-# undef getc
-# define getc getc_unlocked
-#endif
-
 
 /* Current position within the PO file.  */
 lex_pos_ty gram_pos;
@@ -340,6 +341,10 @@ mb_copy (mbchar_t new_mbc, const mbchar_t old_mbc)
    We need 1 for lex_getc, plus 1 for lex_ungetc.  */
 #define NPUSHBACK 2
 
+/* Size of the block buffer through which the bytes are read, when the file
+   cannot be mapped into memory.  */
+#define MBFILE_BLOCK_SIZE 65536
+
 /* Data type of a multibyte character input stream.  */
 struct mbfile
 {
@@ -349,6 +354,16 @@ struct mbfile
   unsigned int bufcount;
   char buf[MBCHAR_BUF_SIZE];
   struct mbchar pushback[NPUSHBACK];
+  /* The bytes read from fp but not yet consumed are
+     block[block_pos..block_len-1].  block points either to heap_block or,
+     when the entire file is mapped into memory, to map_addr.  */
+  char *block;
+  size_t block_size;    /* number of bytes to read at once, > 0 */
+  size_t block_pos;
+  size_t block_len;
+  char *heap_block;
+  void *map_addr;       /* start of the mapping, or NULL */
+  size_t map_len;
 };
 
 /* We want to pass multibyte streams by reference automatically,
@@ -358,6 +373,9 @@ typedef struct mbfile mbfile_t[1];
 /* Whether invalid multibyte sequences in the input shall be signalled
    or silently tolerated.  */
 static bool signal_eilseq;
+#ifdef _OPENMP
+# pragma omp threadprivate (signal_eilseq)
+#endif
 
 static inline void
 mbfile_init (mbfile_t mbf, FILE *stream)
@@ -366,6 +384,107 @@ mbfile_init (mbfile_t mbf, FILE *stream)
   mbf->eof_seen = false;
   mbf->have_pushback = 0;
   mbf->bufcount = 0;
+  mbf->map_addr = NULL;
+
+#if HAVE_MMAP
+  /* When the stream is a regular file, map it into memory, so that the
+     lexer works directly on the file's contents, without copying them
+     through stdio buffers.  */
+  {
+    int fd = fileno (stream);
+    struct stat statbuf;
+    off_t pos;
+
+    if (fd >= 0
+        && fstat (fd, &statbuf) >= 0
+        && S_ISREG (statbuf.st_mode)
+        && statbuf.st_size > 0
+        && statbuf.st_size == (size_t) statbuf.st_size
+        && (pos = ftello (stream)) >= 0
+        && pos <= statbuf.st_size)
+      {
+        void *addr =
+          mmap (NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (addr != MAP_FAILED)
+          {
+            mbf->map_addr = addr;
+            mbf->map_len = statbuf.st_size;
+            mbf->block = (char *) addr;
+            mbf->block_size = 0;
+            mbf->block_pos = pos;
+            mbf->block_len = statbuf.st_size;
+            return;
+          }
+      }
+  }
+#endif
+
+  if (mbf->heap_block == NULL)
+    mbf->heap_block = XNMALLOC (MBFILE_BLOCK_SIZE, char);
+  mbf->block = mbf->heap_block;
+  /* Read only as many bytes as needed when the stream is connected to an
+     interactive tty.  Otherwise read large blocks at once.  */
+  mbf->block_size = (isatty (fileno (stream)) ? 1 : MBFILE_BLOCK_SIZE);
+  mbf->block_pos = 0;
+  mbf->block_len = 0;
+}
+
+/* Initialize mbf for reading the bytes DATA[0..LENGTH-1].  */
+static inline void
+mbfile_init_memory (mbfile_t mbf, const char *data, size_t length)
+{
+  mbf->fp = NULL;
+  mbf->eof_seen = false;
+  mbf->have_pushback = 0;
+  mbf->bufcount = 0;
+  mbf->map_addr = NULL;
+  mbf->block = (char *) data;
+  mbf->block_size = 0;
+  mbf->block_pos = 0;
+  mbf->block_len = length;
+}
+
+/* Release the resources of mbf.  */
+static void
+mbfile_close (mbfile_t mbf)
+{
+#if HAVE_MMAP
+  if (mbf->map_addr != NULL)
+    {
+      /* Leave the stream positioned at the end, like after reading it.  */
+      fseeko (mbf->fp, mbf->map_len, SEEK_SET);
+      munmap (mbf->map_addr, mbf->map_len);
+      mbf->map_addr = NULL;
+      mbf->block = NULL;
+    }
+#endif
+  mbf->fp = NULL;
+}
+
+/* Return true if a read error occurred on mbf.  */
+static inline bool
+mbfile_error (mbfile_t mbf)
+{
+  return (mbf->fp != NULL && ferror (mbf->fp));
+}
+
+/* Read the next byte from mbf.  Return EOF at end of file or if a read error
+   occurs.  */
+static inline int
+mbfile_getbyte (mbfile_t mbf)
+{
+  if (mbf->block_pos == mbf->block_len)
+    {
+      if (mbf->block_size == 0)
+        /* The entire input is in memory.  */
+        return EOF;
+      mbf->block_pos = 0;
+      mbf->block_len = fread (mbf->block, 1, mbf->block_size, mbf->fp);
+      if (mbf->block_len == 0)
+        return EOF;
+    }
+  return (unsigned char) mbf->block[mbf->block_pos++];
 }
 
 /* Read the next multibyte character from mbf and put it into mbc.
@@ -375,7 +494,7 @@ mbfile_getc (mbchar_t mbc, mbfile_t mbf)
 {
   size_t bytes;
 
-  /* If EOF has already been seen, don't use getc.  This matters if
+  /* If EOF has already been seen, don't read further.  This matters if
      mbf->fp is connected to an interactive tty.  */
   if (mbf->eof_seen)
     goto eof;
@@ -391,7 +510,7 @@ mbfile_getc (mbchar_t mbc, mbfile_t mbf)
   /* Before using iconv, we need at least one byte.  */
   if (mbf->bufcount == 0)
     {
-      int c = getc (mbf->fp);
+      int c = mbfile_getbyte (mbf);
       if (c == EOF)
         {
           mbf->eof_seen = true;
@@ -402,7 +521,70 @@ mbfile_getc (mbchar_t mbc, mbfile_t mbf)
     }
 
 #if HAVE_ICONV
-  if (po_lex_iconv != (iconv_t)(-1))
+  if (po_lex_iconv != (iconv_t)(-1) && po_lex_charset == po_charset_utf8)
+    {
+      /* Conversion from UTF-8 to UTF-8 is the identity; only the character
+         boundaries and the validity need to be determined.  Do this
+         without iconv.  */
+      if ((unsigned char) mbf->buf[0] < 0x80)
+        {
+          bytes = 1;
+          mbc->uc = (unsigned char) mbf->buf[0];
+          mbc->uc_valid = true;
+        }
+      else
+        for (;;)
+          {
+            int res = u8_mbtoucr (&mbc->uc, (const uint8_t *) &mbf->buf[0],
+                                  mbf->bufcount);
+
+            if (res > 0)
+              {
+                bytes = res;
+                mbc->uc_valid = true;
+                break;
+              }
+            else if (res == -1)
+              {
+                /* An invalid multibyte sequence was encountered.  */
+                /* Return a single byte.  */
+                if (signal_eilseq)
+                  po_gram_error (_("invalid multibyte sequence"));
+                bytes = 1;
+                mbc->uc_valid = false;
+                break;
+              }
+            else
+              {
+                /* An incomplete multibyte character.  */
+                /* Read one more byte and retry.  */
+                int c = mbfile_getbyte (mbf);
+                if (c == EOF)
+                  {
+                    mbf->eof_seen = true;
+                    if (mbfile_error (mbf))
+                      goto eof;
+                    if (signal_eilseq)
+                      po_gram_error (_("\
+incomplete multibyte sequence at end of file"));
+                    bytes = mbf->bufcount;
+                    mbc->uc_valid = false;
+                    break;
+                  }
+                mbf->buf[mbf->bufcount++] = (unsigned char) c;
+                if (c == '\n')
+                  {
+                    if (signal_eilseq)
+                      po_gram_error (_("\
+incomplete multibyte sequence at end of line"));
+                    bytes = mbf->bufcount - 1;
+                    mbc->uc_valid = false;
+                    break;
+                  }
+              }
+          }
+    }
+  else if (po_lex_iconv != (iconv_t)(-1))
     {
       /* Use iconv on an increasing number of bytes.  Read only as many
          bytes from mbf->fp as needed.  This is needed to give reasonable
@@ -455,11 +637,11 @@ mbfile_getc (mbchar_t mbc, mbfile_t mbf)
                     }
 
                   /* Read one more byte and retry iconv.  */
-                  c = getc (mbf->fp);
+                  c = mbfile_getbyte (mbf);
                   if (c == EOF)
                     {
                       mbf->eof_seen = true;
-                      if (ferror (mbf->fp))
+                      if (mbfile_error (mbf))
                         goto eof;
                       if (signal_eilseq)
                         po_gram_error (_("\
@@ -523,10 +705,10 @@ incomplete multibyte sequence at end of line"));
           if (mbf->bufcount == 1)
             {
               /* Read one more byte.  */
-              int c = getc (mbf->fp);
+              int c = mbfile_getbyte (mbf);
               if (c == EOF)
                 {
-                  if (ferror (mbf->fp))
+                  if (mbfile_error (mbf))
                     {
                       mbf->eof_seen = true;
                       goto eof;
@@ -602,6 +784,10 @@ static bool po_lex_obsolete;
 static bool po_lex_previous;
 static bool pass_comments = false;
 bool pass_obsolete_entries = false;
+#ifdef _OPENMP
+# pragma omp threadprivate (mbf, po_lex_obsolete, po_lex_previous, \
+                            pass_comments)
+#endif
 
 
 /* Prepare lexical analysis.  */
@@ -622,11 +808,31 @@ lex_start (FILE *fp, const char *real_filename, const char *logical_filename)
   po_lex_charset_init ();
 }
 
+/* Prepare lexical analysis of a part of a PO file in memory.  */
+void
+lex_start_memory (const char *data, size_t length,
+                  const char *real_filename, size_t line_number,
+                  const char *header_entry)
+{
+  gram_pos.file_name = xstrdup (real_filename);
+
+  mbfile_init_memory (mbf, data, length);
+
+  gram_pos.line_number = line_number;
+  gram_pos_column = 0;
+  signal_eilseq = true;
+  po_lex_obsolete = false;
+  po_lex_previous = false;
+  po_lex_charset_init ();
+  if (header_entry != NULL)
+    po_lex_charset_set (header_entry, real_filename);
+}
+
 /* Terminate lexical analysis.  */
 void
 lex_end ()
 {
-  mbf->fp = NULL;
+  mbfile_close (mbf);
   gram_pos.file_name = NULL;
   gram_pos.line_number = 0;
   gram_pos_column = 0;
@@ -648,7 +854,7 @@ lex_getc (mbchar_t mbc)
 
       if (mb_iseof (mbc))
         {
-          if (ferror (mbf->fp))
+          if (mbfile_error (mbf))
            bomb:
             {
               const char *errno_description = strerror (errno);
@@ -678,7 +884,7 @@ lex_getc (mbchar_t mbc)
 
           if (mb_iseof (mbc2))
             {
-              if (ferror (mbf->fp))
+              if (mbfile_error (mbf))
                 goto bomb;
               break;
             }
@@ -715,6 +921,42 @@ lex_ungetc (const mbchar_t mbc)
 }
 
 
+/* Consume the run of printable ASCII characters other than '"' and '\\'
+   that is already buffered at the current position, and return a pointer
+   to it.  Store its length, possibly 0, in *LENP.  Return NULL if the
+   current position is not in the input buffer, due to pushed back
+   characters.
+   In all supported encodings, these bytes are single characters of width 1,
+   so that they can be passed to the grammar without going through
+   lex_getc.  */
+static const char *
+lex_plain_run (size_t *lenp)
+{
+  const char *start = mbf->block + mbf->block_pos;
+  const char *p = start;
+  const char *end = mbf->block + mbf->block_len;
+
+  if (mbf->have_pushback > 0 || mbf->bufcount > 0)
+    {
+      *lenp = 0;
+      return NULL;
+    }
+
+  while (p < end)
+    {
+      unsigned char c = *p;
+      if (!(c >= 0x20 && c < 0x7F && c != '"' && c != '\\'))
+        break;
+      p++;
+    }
+
+  *lenp = p - start;
+  mbf->block_pos += p - start;
+  gram_pos_column += p - start;
+  return start;
+}
+
+
 static int
 keyword_p (const char *s)
 {
@@ -857,12 +1099,15 @@ control_sequence ()
 
 
 /* Return the next token in the PO file.  The return codes are defined
-   in "po-gram-gen2.h".  Associated data is put in 'po_gram_lval'.  */
+   in "po-gram-gen2.h".  Associated data is put in *LVAL.  */
 int
-po_gram_lex ()
+po_gram_lex (union YYSTYPE *lval)
 {
   static char *buf;
   static size_t bufmax;
+#ifdef _OPENMP
+# pragma omp threadprivate (buf, bufmax)
+#endif
   mbchar_t mbc;
   size_t bufpos;
 
@@ -941,13 +1186,28 @@ po_gram_lex ()
                     memcpy_small (&buf[bufpos], mb_ptr (mbc), mb_len (mbc));
                     bufpos += mb_len (mbc);
 
+                    {
+                      size_t runlen;
+                      const char *run = lex_plain_run (&runlen);
+                      if (runlen > 0)
+                        {
+                          if (bufpos + runlen >= bufmax)
+                            {
+                              bufmax = bufpos + runlen + 100;
+                              buf = xrealloc (buf, bufmax);
+                            }
+                          memcpy (&buf[bufpos], run, runlen);
+                          bufpos += runlen;
+                        }
+                    }
+
                     lex_getc (mbc);
                   }
                 buf[bufpos] = '\0';
 
-                po_gram_lval.string.string = buf;
-                po_gram_lval.string.pos = gram_pos;
-                po_gram_lval.string.obsolete = po_lex_obsolete;
+                lval->string.string = buf;
+                lval->string.pos = gram_pos;
+                lval->string.obsolete = po_lex_obsolete;
                 po_lex_obsolete = false;
                 signal_eilseq = true;
                 return COMMENT;
@@ -958,7 +1218,12 @@ po_gram_lex ()
                    comments while they get not passed to the upper layers
                    is not very efficient.  */
                 while (!mb_iseof (mbc) && !mb_iseq (mbc, '\n'))
-                  lex_getc (mbc);
+                  {
+                    size_t runlen;
+
+                    lex_plain_run (&runlen);
+                    lex_getc (mbc);
+                  }
                 po_lex_obsolete = false;
                 signal_eilseq = true;
               }
@@ -969,6 +1234,41 @@ po_gram_lex ()
             bufpos = 0;
             for (;;)
               {
+                const char *run;
+                size_t runlen;
+
+                /* Copy plain characters in bulk.  */
+                run = lex_plain_run (&runlen);
+                if (bufpos == 0 && run != NULL
+                    && mbf->block_pos < mbf->block_len
+                    && mbf->block[mbf->block_pos] == '"')
+                  {
+                    /* The entire string consists of plain characters.
+                       Take it directly from the input buffer.  */
+                    char *string = XNMALLOC (runlen + 1, char);
+
+                    memcpy (string, run, runlen);
+                    string[runlen] = '\0';
+                    /* Consume the closing quote.  */
+                    mbf->block_pos++;
+                    gram_pos_column++;
+
+                    lval->string.string = string;
+                    lval->string.pos = gram_pos;
+                    lval->string.obsolete = po_lex_obsolete;
+                    return (po_lex_previous ? PREV_STRING : STRING);
+                  }
+                if (runlen > 0)
+                  {
+                    if (bufpos + runlen >= bufmax)
+                      {
+                        bufmax = bufpos + runlen + 100;
+                        buf = xrealloc (buf, bufmax);
+                      }
+                    memcpy (&buf[bufpos], run, runlen);
+                    bufpos += runlen;
+                  }
+
                 lex_getc (mbc);
                 while (bufpos + mb_len (mbc) >= bufmax)
                   {
@@ -1008,9 +1308,9 @@ po_gram_lex ()
                                      _("context separator <EOT> within string"));
 
             /* FIXME: Treatment of embedded \000 chars is incorrect.  */
-            po_gram_lval.string.string = xstrdup (buf);
-            po_gram_lval.string.pos = gram_pos;
-            po_gram_lval.string.obsolete = po_lex_obsolete;
+            lval->string.string = xstrdup (buf);
+            lval->string.pos = gram_pos;
+            lval->string.obsolete = po_lex_obsolete;
             return (po_lex_previous ? PREV_STRING : STRING);
 
           case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
@@ -1067,14 +1367,14 @@ po_gram_lex ()
               int k = keyword_p (buf);
               if (k == NAME)
                 {
-                  po_gram_lval.string.string = xstrdup (buf);
-                  po_gram_lval.string.pos = gram_pos;
-                  po_gram_lval.string.obsolete = po_lex_obsolete;
+                  lval->string.string = xstrdup (buf);
+                  lval->string.pos = gram_pos;
+                  lval->string.obsolete = po_lex_obsolete;
                 }
               else
                 {
-                  po_gram_lval.pos.pos = gram_pos;
-                  po_gram_lval.pos.obsolete = po_lex_obsolete;
+                  lval->pos.pos = gram_pos;
+                  lval->pos.obsolete = po_lex_obsolete;
                 }
               return k;
             }
@@ -1108,19 +1408,19 @@ po_gram_lex ()
 
             buf[bufpos] = '\0';
 
-            po_gram_lval.number.number = atol (buf);
-            po_gram_lval.number.pos = gram_pos;
-            po_gram_lval.number.obsolete = po_lex_obsolete;
+            lval->number.number = atol (buf);
+            lval->number.pos = gram_pos;
+            lval->number.obsolete = po_lex_obsolete;
             return NUMBER;
 
           case '[':
-            po_gram_lval.pos.pos = gram_pos;
-            po_gram_lval.pos.obsolete = po_lex_obsolete;
+            lval->pos.pos = gram_pos;
+            lval->pos.obsolete = po_lex_obsolete;
             return '[';
 
           case ']':
-            po_gram_lval.pos.pos = gram_pos;
-            po_gram_lval.pos.obsolete = po_lex_obsolete;
+            lval->pos.pos = gram_pos;
+            lval->pos.obsolete = po_lex_obsolete;
             return ']';
 
           default:
@@ -1149,3 +1449,10 @@ po_lex_pass_obsolete_entries (bool flag)
 {
   pass_obsolete_entries = flag;
 }
+
+
+const lex_pos_ty *
+po_lex_current_pos ()
+{
+  return &gram_pos;
+}
@@ -51,9 +51,15 @@ extern "C" {
 
 /* Global variables from po-lex.c.  */
 
-/* Current position within the PO file.  */
-extern DLL_VARIABLE lex_pos_ty gram_pos;
-extern DLL_VARIABLE int gram_pos_column;
+/* Current position within the PO file.
+   Each thread parses its own PO file or part of a PO file.  Thread-local
+   variables cannot be exported from a shared library on all platforms;
+   therefore code outside libgettextsrc uses po_lex_current_pos instead.  */
+extern lex_pos_ty gram_pos;
+extern int gram_pos_column;
+#ifdef _OPENMP
+# pragma omp threadprivate (gram_pos, gram_pos_column)
+#endif
 
 /* Number of parse errors within a PO file that cause the program to
    terminate.  Cf. error_message_count, declared in <error.h>.  */
@@ -67,12 +73,25 @@ extern DLL_VARIABLE bool pass_obsolete_entries;
 extern void lex_start (FILE *fp, const char *real_filename,
                        const char *logical_filename);
 
+/* Prepare lexical analysis of a part of a PO file, given in memory as
+   DATA[0..LENGTH-1].  LINE_NUMBER is the line number of its first line.
+   HEADER_ENTRY, if non-NULL, is the msgstr of the file's header entry,
+   which precedes this part and determines its encoding.  */
+extern void lex_start_memory (const char *data, size_t length,
+                              const char *real_filename, size_t line_number,
+                              const char *header_entry);
+
 /* Terminate lexical analysis.  */
 extern void lex_end (void);
 
+/* Return the current position within the PO file that the current thread
+   parses.  */
+extern const lex_pos_ty *po_lex_current_pos (void);
+
 /* Return the next token in the PO file.  The return codes are defined
-   in "po-gram-gen2.h".  Associated data is put in 'po_gram_lval.  */
-extern int po_gram_lex (void);
+   in "po-gram-gen2.h".  Associated data is put in *LVAL.  */
+union YYSTYPE;
+extern int po_gram_lex (union YYSTYPE *lval);
 
 /* po_gram_lex() can return comments as COMMENT.  Switch this on or off.  */
 extern void po_lex_pass_comments (bool flag);
@@ -0,0 +1,474 @@
+/* Reading binary intermediate catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "read-binary.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
+/* This include file describes the binary catalog format.  */
+#include "binary-catalog.h"
+
+#include "binary-io.h"
+#include "message.h"
+#include "po-error.h"
+#include "po-lex.h"
+#include "xalloc.h"
+#include "gettext.h"
+
+#define _(str) gettext (str)
+
+
+/* If non-NULL, only the messages whose number, counted from 0 across all
+   domains, is marked in this array are passed on.  The others are skipped
+   without being decoded.  */
+const bool *binary_catalog_selection;
+
+
+/* We map the file into memory or, where this is not possible, read it
+   completely into memory, with a single read where the size of the file is
+   known in advance.  This struct represents the file in memory and the
+   current read position.  */
+struct binary_catalog_file
+{
+  const char *filename;
+  char *data;
+  size_t size;
+  size_t offset;
+  /* The address of the memory mapping, or NULL if DATA is on the heap.  */
+  void *map_addr;
+  size_t map_len;
+  /* The table of file names, see binary-catalog.h.  */
+  char **file_names;
+  size_t n_file_names;
+};
+
+
+/* Read the contents of the given input stream.  */
+static void
+read_binary_catalog_file (struct binary_catalog_file *bfp,
+                          FILE *fp, const char *filename)
+{
+  struct stat statbuf;
+  char *buf = NULL;
+  size_t alloc = 0;
+  size_t size = 0;
+  size_t count;
+
+  SET_BINARY (fileno (fp));
+
+  bfp->filename = filename;
+  bfp->offset = 0;
+  bfp->map_addr = NULL;
+
+#if HAVE_MMAP
+  /* Mapping the file avoids copying all of it when only a few messages
+     are decoded, see binary_catalog_selection.  */
+  {
+    off_t pos;
+
+    if (fstat (fileno (fp), &statbuf) >= 0 && S_ISREG (statbuf.st_mode)
+        && statbuf.st_size > 0 && statbuf.st_size == (size_t) statbuf.st_size
+        && (pos = ftello (fp)) >= 0 && pos <= statbuf.st_size)
+      {
+        void *addr =
+          mmap (NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fileno (fp), 0);
+
+        if (addr != MAP_FAILED)
+          {
+            bfp->map_addr = addr;
+            bfp->map_len = statbuf.st_size;
+            bfp->data = (char *) addr + pos;
+            bfp->size = statbuf.st_size - pos;
+            return;
+          }
+      }
+  }
+#endif
+
+  if (fstat (fileno (fp), &statbuf) >= 0 && S_ISREG (statbuf.st_mode)
+      && statbuf.st_size > 0 && statbuf.st_size == (size_t) statbuf.st_size)
+    {
+      /* Allocate one byte more, so that the loop below sees EOF without
+         growing the buffer.  */
+      alloc = statbuf.st_size + 1;
+      buf = (char *) xmalloc (alloc);
+    }
+
+  while (!feof (fp))
+    {
+      if (size == alloc)
+        {
+          alloc = alloc + alloc / 2 + 4096;
+          buf = (char *) xrealloc (buf, alloc);
+        }
+      count = fread (buf + size, 1, alloc - size, fp);
+      if (count == 0)
+        {
+          if (ferror (fp))
+            po_error (EXIT_FAILURE, errno, _("error while reading \"%s\""),
+                      filename);
+        }
+      else
+        size += count;
+    }
+  bfp->data = buf;
+  bfp->size = size;
+}
+
+/* Release the memory of the file.  */
+static void
+free_binary_catalog_file (struct binary_catalog_file *bfp)
+{
+#if HAVE_MMAP
+  if (bfp->map_addr != NULL)
+    {
+      munmap (bfp->map_addr, bfp->map_len);
+      return;
+    }
+#endif
+  free (bfp->data);
+}
+
+static void
+truncated (const struct binary_catalog_file *bfp)
+{
+  po_error (EXIT_FAILURE, 0, _("file \"%s\" is truncated"), bfp->filename);
+}
+
+/* Get a number, stored with 7 bits per byte.  */
+static size_t
+get_number (struct binary_catalog_file *bfp)
+{
+  size_t value = 0;
+  unsigned int shift = 0;
+
+  for (;;)
+    {
+      unsigned char c;
+
+      if (bfp->offset >= bfp->size)
+        truncated (bfp);
+      c = (unsigned char) bfp->data[bfp->offset++];
+      if (shift < sizeof (size_t) * 8)
+        value |= (size_t) (c & 0x7f) << shift;
+      shift += 7;
+      if ((c & 0x80) == 0)
+        return value;
+    }
+}
+
+/* Get a string of LENGTH bytes, in freshly allocated memory if COPY is
+   true.  If COPY is false, only skip the bytes and return NULL.  */
+static char *
+get_bytes (struct binary_catalog_file *bfp, size_t length, bool copy)
+{
+  char *result;
+
+  if (length > bfp->size - bfp->offset)
+    truncated (bfp);
+  if (copy)
+    {
+      result = XNMALLOC (length + 1, char);
+      memcpy (result, bfp->data + bfp->offset, length);
+      result[length] = '\0';
+    }
+  else
+    result = NULL;
+  bfp->offset += length;
+  return result;
+}
+
+/* Get a string that may be NULL, in freshly allocated memory.  */
+static char *
+get_string (struct binary_catalog_file *bfp)
+{
+  size_t n = get_number (bfp);
+
+  return (n > 0 ? get_bytes (bfp, n - 1, true) : NULL);
+}
+
+static inline size_t
+get_line_number (struct binary_catalog_file *bfp)
+{
+  return get_number (bfp) - 1;
+}
+
+/* Get a reference to the table of file names.  */
+static const char *
+get_file_name (struct binary_catalog_file *bfp, size_t index)
+{
+  if (index >= bfp->n_file_names)
+    po_error (EXIT_FAILURE, 0, _("file \"%s\" is not in binary catalog format"),
+              bfp->filename);
+  return bfp->file_names[index];
+}
+
+
+/* Read the comments and flags of a message.  If DISPATCH is true, pass them
+   to the callbacks; otherwise, skip them.  */
+static void
+read_comments (struct binary_catalog_file *bfp, bool dispatch)
+{
+  size_t n, j;
+  char *s;
+
+  n = get_number (bfp);
+  for (j = 0; j < n; j++)
+    {
+      s = get_bytes (bfp, get_number (bfp) - 1, dispatch);
+      if (dispatch)
+        {
+          po_callback_comment (s);
+          free (s);
+        }
+    }
+  n = get_number (bfp);
+  for (j = 0; j < n; j++)
+    {
+      s = get_bytes (bfp, get_number (bfp) - 1, dispatch);
+      if (dispatch)
+        {
+          po_callback_comment_dot (s);
+          free (s);
+        }
+    }
+  n = get_number (bfp);
+  for (j = 0; j < n; j++)
+    {
+      const char *file_name = get_file_name (bfp, get_number (bfp));
+      size_t line_number = get_line_number (bfp);
+
+      if (dispatch)
+        po_callback_comment_filepos (file_name, line_number);
+    }
+
+  s = get_bytes (bfp, get_number (bfp) - 1, dispatch);
+  if (dispatch)
+    {
+      if (s[0] != '\0')
+        po_callback_comment_special (s);
+      free (s);
+    }
+
+  n = get_number (bfp);
+  if (n > 0)
+    {
+      enum is_format formats[NFORMATS];
+      size_t i;
+
+      for (i = 0; i < NFORMATS; i++)
+        formats[i] = undecided;
+      for (j = 0; j < n; j++)
+        {
+          size_t length = get_number (bfp) - 1;
+          const char *name = bfp->data + bfp->offset;
+          size_t value;
+
+          get_bytes (bfp, length, false);
+          value = get_number (bfp);
+          if (value > impossible)
+            po_error (EXIT_FAILURE, 0,
+                      _("file \"%s\" is not in binary catalog format"),
+                      bfp->filename);
+          /* Like the PO parser, ignore unknown format languages.  */
+          for (i = 0; i < NFORMATS; i++)
+            if (strlen (format_language[i]) == length
+                && memcmp (format_language[i], name, length) == 0)
+              {
+                formats[i] = (enum is_format) value;
+                break;
+              }
+        }
+      if (dispatch)
+        po_callback_comment_format (formats);
+    }
+}
+
+/* Read a message and pass it, together with its comments, to the
+   callbacks.  */
+static void
+read_message (struct binary_catalog_file *bfp)
+{
+  char *msgctxt;
+  char *msgid;
+  char *msgid_plural;
+  char *msgstr;
+  size_t msgstr_len;
+  lex_pos_ty pos;
+  size_t file_index;
+  size_t comments_offset;
+  size_t end_offset;
+  char *prev_msgctxt;
+  char *prev_msgid;
+  char *prev_msgid_plural;
+  bool obsolete;
+
+  msgctxt = get_string (bfp);
+  msgid = get_string (bfp);
+  msgid_plural = get_string (bfp);
+  msgstr_len = get_number (bfp);
+  msgstr = get_bytes (bfp, msgstr_len, true);
+  if (msgid == NULL || msgstr_len == 0 || msgstr[msgstr_len - 1] != '\0')
+    po_error (EXIT_FAILURE, 0, _("file \"%s\" is not in binary catalog format"),
+              bfp->filename);
+
+  file_index = get_number (bfp);
+  pos.file_name =
+    (char *) (file_index > 0 ? get_file_name (bfp, file_index - 1) : NULL);
+  pos.line_number = get_line_number (bfp);
+
+  /* The comments are passed on only after it is known whether the message
+     is kept, since the callbacks attach them to the next message.  */
+  comments_offset = bfp->offset;
+  read_comments (bfp, false);
+
+  prev_msgctxt = get_string (bfp);
+  prev_msgid = get_string (bfp);
+  prev_msgid_plural = get_string (bfp);
+  obsolete = (get_number (bfp) != 0);
+
+  /* Like the PO lexer, drop obsolete entries unless they are wanted.  */
+  if (obsolete && !pass_obsolete_entries)
+    {
+      free (msgctxt);
+      free (msgid);
+      free (msgid_plural);
+      free (msgstr);
+      free (prev_msgctxt);
+      free (prev_msgid);
+      free (prev_msgid_plural);
+      return;
+    }
+
+  end_offset = bfp->offset;
+  bfp->offset = comments_offset;
+  read_comments (bfp, true);
+  bfp->offset = end_offset;
+
+  po_callback_message (msgctxt, msgid, &pos, msgid_plural,
+                       msgstr, msgstr_len, &pos,
+                       prev_msgctxt, prev_msgid, prev_msgid_plural,
+                       false, obsolete);
+}
+
+/* Skip a message, without decoding it.  */
+static void
+skip_message (struct binary_catalog_file *bfp)
+{
+  size_t n;
+
+  /* msgctxt, msgid, msgid_plural.  */
+  for (n = 0; n < 3; n++)
+    {
+      size_t length = get_number (bfp);
+
+      if (length > 0)
+        get_bytes (bfp, length - 1, false);
+    }
+  /* msgstr.  */
+  get_bytes (bfp, get_number (bfp), false);
+  /* The position.  */
+  get_number (bfp);
+  get_number (bfp);
+
+  read_comments (bfp, false);
+
+  /* prev_msgctxt, prev_msgid, prev_msgid_plural.  */
+  for (n = 0; n < 3; n++)
+    {
+      size_t length = get_number (bfp);
+
+      if (length > 0)
+        get_bytes (bfp, length - 1, false);
+    }
+  /* The obsolete flag.  */
+  get_number (bfp);
+}
+
+
+static void
+binary_parse (abstract_catalog_reader_ty *pop, FILE *fp,
+              const char *real_filename, const char *logical_filename)
+{
+  struct binary_catalog_file bf;
+  size_t ndomains;
+  size_t k, j;
+  size_t message_number;
+
+  read_binary_catalog_file (&bf, fp, real_filename);
+
+  if (bf.size < BINARY_CATALOG_MAGIC_LENGTH
+      || memcmp (bf.data, BINARY_CATALOG_MAGIC,
+                 BINARY_CATALOG_MAGIC_LENGTH) != 0)
+    po_error (EXIT_FAILURE, 0, _("file \"%s\" is not in binary catalog format"),
+              real_filename);
+  bf.offset = BINARY_CATALOG_MAGIC_LENGTH;
+  if (get_number (&bf) != BINARY_CATALOG_VERSION)
+    po_error (EXIT_FAILURE, 0,
+              _("file \"%s\" has an unsupported binary catalog format version"),
+              real_filename);
+
+  /* The file names are referenced by the messages' positions, which must
+     stay valid as long as the messages; therefore they are never freed.  */
+  bf.n_file_names = get_number (&bf);
+  bf.file_names = XNMALLOC (bf.n_file_names, char *);
+  for (j = 0; j < bf.n_file_names; j++)
+    bf.file_names[j] = get_bytes (&bf, get_number (&bf) - 1, true);
+
+  ndomains = get_number (&bf);
+  message_number = 0;
+  for (k = 0; k < ndomains; k++)
+    {
+      char *domain = get_bytes (&bf, get_number (&bf) - 1, true);
+      size_t nmessages;
+
+      if (k > 0 || strcmp (domain, MESSAGE_DOMAIN_DEFAULT) != 0)
+        po_callback_domain (domain);
+      else
+        free (domain);
+
+      nmessages = get_number (&bf);
+      for (j = 0; j < nmessages; j++, message_number++)
+        if (binary_catalog_selection == NULL
+            || binary_catalog_selection[message_number])
+          read_message (&bf);
+        else
+          skip_message (&bf);
+    }
+
+  free (bf.file_names);
+  free_binary_catalog_file (&bf);
+}
+
+const struct catalog_input_format input_format_binary =
+{
+  binary_parse,                         /* parse */
+  false                                 /* produces_utf8 */
+};
@@ -0,0 +1,31 @@
+/* Reading binary intermediate catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _READ_BINARY_H
+#define _READ_BINARY_H
+
+#include <stdbool.h>
+
+#include "read-catalog-abstract.h"
+
+/* Describes a binary catalog parser.  */
+extern DLL_VARIABLE const struct catalog_input_format input_format_binary;
+
+/* If non-NULL, the binary catalog parser passes on only the messages whose
+   number, counted from 0 across all domains, is marked in this array.  */
+extern DLL_VARIABLE const bool *binary_catalog_selection;
+
+#endif /* _READ_BINARY_H */
@@ -31,11 +31,16 @@
 #include "xalloc.h"
 #include "xvasprintf.h"
 #include "po-xerror.h"
+#include "po-lex.h"
+#include "po-gram.h"
 #include "error.h"
 #include "gettext.h"
 
 /* Local variables.  */
 static abstract_catalog_reader_ty *callback_arg;
+#ifdef _OPENMP
+# pragma omp threadprivate (callback_arg)
+#endif
 
 
 /* ========================================================================= */
@@ -141,6 +146,14 @@ call_comment_special (abstract_catalog_reader_ty *pop, const char *s)
     pop->methods->comment_special (pop, s);
 }
 
+static inline void
+call_comment_format (abstract_catalog_reader_ty *pop,
+                     const enum is_format formatp[NFORMATS])
+{
+  if (pop->methods->comment_format != NULL)
+    pop->methods->comment_format (pop, formatp);
+}
+
 
 /* ========================================================================= */
 /* Exported functions.  */
@@ -187,6 +200,20 @@ catalog_reader_parse (abstract_catalog_reader_ty *pop, FILE *fp,
 }
 
 
+void
+catalog_reader_parse_po_chunk (abstract_catalog_reader_ty *pop,
+                               const char *data, size_t length,
+                               const char *real_filename, size_t line_number,
+                               const char *header_entry)
+{
+  parse_start (pop);
+  lex_start_memory (data, length, real_filename, line_number, header_entry);
+  po_gram_parse ();
+  lex_end ();
+  parse_end (pop);
+}
+
+
 /* ========================================================================= */
 /* Callbacks used by po-gram.y or po-lex.c, indirectly from
    catalog_reader_parse.  */
@@ -256,6 +283,14 @@ po_callback_comment_special (const char *s)
 }
 
 
+void
+po_callback_comment_format (const enum is_format formatp[NFORMATS])
+{
+  /* assert(callback_arg); */
+  call_comment_format (callback_arg, formatp);
+}
+
+
 /* Parse a special comment and put the result in *fuzzyp, formatp, *rangep,
    *wrapp.  */
 void
@@ -107,6 +107,13 @@ struct abstract_catalog_reader_class_ty
      inexact translation.  */
   void (*comment_special) (struct abstract_catalog_reader_ty *pop,
                            const char *s);
+
+  /* What to do with the format flags of the next message, when they are
+     given as values rather than in a special comment.  Elements of FORMATP
+     that are undecided are to be ignored.  This method is invoked after
+     the comment_special method of the same message.  */
+  void (*comment_format) (struct abstract_catalog_reader_ty *pop,
+                          const enum is_format formatp[NFORMATS]);
 };
 
 
@@ -156,6 +163,18 @@ extern void
                              const char *logical_filename,
                              catalog_input_format_ty input_syntax);
 
+/* Read a part of a PO file, given in memory as DATA[0..LENGTH-1], and
+   dispatch to the various abstract_catalog_reader_class_ty methods.
+   LINE_NUMBER is the line number of the first line of DATA.  HEADER_ENTRY,
+   if non-NULL, is the msgstr of the file's header entry, that precedes DATA.
+   Unlike catalog_reader_parse, this function does not count the errors.  */
+extern void
+       catalog_reader_parse_po_chunk (abstract_catalog_reader_ty *pop,
+                                      const char *data, size_t length,
+                                      const char *real_filename,
+                                      size_t line_number,
+                                      const char *header_entry);
+
 /* Call the destructor and deallocate a abstract_catalog_reader_ty (or derived
    class) instance.  */
 extern void
@@ -177,6 +196,7 @@ extern void po_callback_comment (const char *s);
 extern void po_callback_comment_dot (const char *s);
 extern void po_callback_comment_filepos (const char *s, size_t line);
 extern void po_callback_comment_special (const char *s);
+extern void po_callback_comment_format (const enum is_format formatp[NFORMATS]);
 extern void po_callback_comment_dispatcher (const char *s);
 
 /* Parse a special comment and put the result in *fuzzyp, formatp, *rangep,
@@ -23,12 +23,23 @@
 #include "read-catalog.h"
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _OPENMP
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <omp.h>
+#endif
+#if defined _OPENMP && HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
 #include "open-catalog.h"
 #include "po-charset.h"
 #include "po-xerror.h"
+#include "read-po.h"
 #include "xalloc.h"
 #include "gettext.h"
 
@@ -317,6 +328,20 @@ default_comment_special (abstract_catalog_reader_ty *that, const char *s)
 }
 
 
+/* Take over the format flags that are decided.  */
+void
+default_comment_format (abstract_catalog_reader_ty *that,
+                        const enum is_format formatp[NFORMATS])
+{
+  default_catalog_reader_ty *this = (default_catalog_reader_ty *) that;
+  size_t i;
+
+  for (i = 0; i < NFORMATS; i++)
+    if (formatp[i] != undecided)
+      this->is_format[i] = formatp[i];
+}
+
+
 /* Default implementation of methods not inherited from the superclass.  */
 
 
@@ -438,7 +463,8 @@ static default_catalog_reader_class_ty default_methods =
     default_comment,
     default_comment_dot,
     default_comment_filepos,
-    default_comment_special
+    default_comment_special,
+    default_comment_format
   },
   default_set_domain, /* set_domain */
   default_add_message, /* add_message */
@@ -468,13 +494,11 @@ int line_comment = 1;
 bool allow_duplicates = false;
 
 
-msgdomain_list_ty *
-read_catalog_stream (FILE *fp, const char *real_filename,
-                     const char *logical_filename,
-                     catalog_input_format_ty input_syntax)
+/* Allocate the catalog reader used by read_catalog_stream.  */
+static default_catalog_reader_ty *
+read_catalog_reader_alloc (const char *real_filename)
 {
   default_catalog_reader_ty *pop;
-  msgdomain_list_ty *mdlp;
 
   pop = default_catalog_reader_alloc (&default_methods);
   pop->handle_comments = true;
@@ -485,10 +509,240 @@ read_catalog_stream (FILE *fp, const char *real_filename,
   pop->file_name = real_filename;
   pop->mdlp = msgdomain_list_alloc (!pop->allow_duplicates);
   pop->mlp = msgdomain_list_sublist (pop->mdlp, pop->domain, true);
+  return pop;
+}
+
+
+#ifdef _OPENMP
+
+/* The error handlers that were in effect before parsing in parallel.  */
+static void (*saved_xerror) (int, const struct message_ty *, const char *,
+                             size_t, size_t, int, const char *);
+static void (*saved_xerror2) (int, const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *,
+                              const struct message_ty *, const char *,
+                              size_t, size_t, int, const char *);
+
+#endif
+
+
+#if defined _OPENMP && HAVE_MMAP
+
+/* PO files of at least this size are parsed by several threads.  */
+#define PARALLEL_PARSE_MIN_SIZE 0x100000
+
+/* Number of errors seen by the threads that parse parts of a PO file.  */
+static int parallel_error_count;
+
+/* The error handlers in effect while parsing in parallel.  They only count
+   the errors: when there are errors, the file is parsed again sequentially,
+   so that they are reported in order.  The only warnings are those about
+   the header entry's charset; they are reproduced afterwards.  */
+static void
+parallel_xerror (int severity,
+                 const struct message_ty *message,
+                 const char *filename, size_t lineno, size_t column,
+                 int multiline_p, const char *message_text)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror (severity, message, filename, lineno, column,
+                  multiline_p, message_text);
+  else if (severity == PO_SEVERITY_ERROR)
+    {
+      #pragma omp atomic
+      parallel_error_count++;
+    }
+}
+
+static void
+parallel_xerror2 (int severity,
+                  const struct message_ty *message1,
+                  const char *filename1, size_t lineno1, size_t column1,
+                  int multiline_p1, const char *message_text1,
+                  const struct message_ty *message2,
+                  const char *filename2, size_t lineno2, size_t column2,
+                  int multiline_p2, const char *message_text2)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror2 (severity, message1, filename1, lineno1, column1,
+                   multiline_p1, message_text1,
+                   message2, filename2, lineno2, column2,
+                   multiline_p2, message_text2);
+  else if (severity == PO_SEVERITY_ERROR)
+    {
+      #pragma omp atomic
+      parallel_error_count++;
+    }
+}
+
+/* Read a PO file from a stream, by splitting it at entry boundaries and
+   parsing the parts in parallel.  Return NULL if this is not possible or
+   not worth it, or if the file has errors; then the caller must parse it
+   sequentially.  */
+static msgdomain_list_ty *
+read_po_parallel (FILE *fp, const char *real_filename)
+{
+  int fd;
+  struct stat statbuf;
+  size_t length;
+  void *addr;
+  const char *data;
+  size_t n;
+  size_t *offsets;
+  size_t *lines;
+  long int nparts;
+  msgdomain_list_ty *result;
+
+  if (omp_in_parallel () || omp_get_max_threads () < 2)
+    return NULL;
+
+  fd = fileno (fp);
+  if (fd < 0
+      || fstat (fd, &statbuf) < 0
+      || !S_ISREG (statbuf.st_mode)
+      || statbuf.st_size < PARALLEL_PARSE_MIN_SIZE
+      || statbuf.st_size != (size_t) statbuf.st_size
+      || ftello (fp) != 0)
+    return NULL;
+  length = statbuf.st_size;
+  addr = mmap (NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED)
+    return NULL;
+  data = (const char *) addr;
+
+  n = 4 * omp_get_max_threads ();
+  offsets = XNMALLOC (n + 2, size_t);
+  lines = XNMALLOC (n + 2, size_t);
+  nparts = po_split_entries (data, length, n, offsets, lines);
+  result = NULL;
+
+  if (nparts >= 2)
+    {
+      default_catalog_reader_ty **readers =
+        XNMALLOC (nparts, default_catalog_reader_ty *);
+      const message_ty *header;
+      message_list_ty *result_mlp;
+      bool ok;
+      long int k;
+
+      parallel_error_count = 0;
+      saved_xerror = po_xerror;
+      saved_xerror2 = po_xerror2;
+      po_xerror = parallel_xerror;
+      po_xerror2 = parallel_xerror2;
+
+      /* The first part contains the header entry, which determines the
+         encoding of the other parts.  */
+      readers[0] = read_catalog_reader_alloc (real_filename);
+      catalog_reader_parse_po_chunk ((abstract_catalog_reader_ty *) readers[0],
+                                     data, offsets[1], real_filename,
+                                     lines[0], NULL);
+      header = message_list_search (readers[0]->mlp, NULL, "");
+      if (header != NULL && header->obsolete)
+        header = NULL;
+
+      #pragma omp parallel for schedule(dynamic)
+      for (k = 1; k < nparts; k++)
+        {
+          readers[k] = read_catalog_reader_alloc (real_filename);
+          catalog_reader_parse_po_chunk ((abstract_catalog_reader_ty *)
+                                         readers[k],
+                                         data + offsets[k],
+                                         offsets[k + 1] - offsets[k],
+                                         real_filename, lines[k],
+                                         header != NULL ? header->msgstr : NULL);
+        }
+
+      po_xerror = saved_xerror;
+      po_xerror2 = saved_xerror2;
+
+      /* Concatenate the parts' messages in order.  The duplicate checks
+         across parts are done here.  */
+      ok = (parallel_error_count == 0);
+      result = readers[0]->mdlp;
+      result_mlp = readers[0]->mlp;
+      for (k = 1; k < nparts; k++)
+        {
+          message_list_ty *mlp = readers[k]->mlp;
+          size_t j = 0;
+
+          if (ok)
+            for (; j < mlp->nitems; j++)
+              {
+                message_ty *mp = mlp->item[j];
+
+                if (/* A header entry changes the encoding of what follows.  */
+                    (mp->msgctxt == NULL && mp->msgid[0] == '\0'
+                     && !mp->obsolete)
+                    || ((!allow_duplicates || mp->msgid[0] == '\0')
+                        && message_list_search (result_mlp, mp->msgctxt,
+                                                mp->msgid) != NULL))
+                  {
+                    ok = false;
+                    break;
+                  }
+                message_list_append (result_mlp, mp);
+              }
+          /* Free the messages that were not moved, and the part's list.  */
+          for (; j < mlp->nitems; j++)
+            message_free (mlp->item[j]);
+          mlp->nitems = 0;
+          msgdomain_list_free (readers[k]->mdlp);
+          catalog_reader_free ((abstract_catalog_reader_ty *) readers[k]);
+        }
+
+      if (ok && header != NULL)
+        {
+          /* Reproduce the warnings about the header entry's charset.  */
+          po_lex_charset_set (header->msgstr, real_filename);
+          po_lex_charset_close ();
+        }
+      catalog_reader_free ((abstract_catalog_reader_ty *) readers[0]);
+      free (readers);
+
+      if (!ok)
+        {
+          msgdomain_list_free (result);
+          result = NULL;
+        }
+      else
+        /* Leave the stream positioned at the end, like after reading it.  */
+        fseeko (fp, length, SEEK_SET);
+    }
+
+  free (lines);
+  free (offsets);
+  munmap (addr, length);
+  return result;
+}
+
+#endif
+
+
+msgdomain_list_ty *
+read_catalog_stream (FILE *fp, const char *real_filename,
+                     const char *logical_filename,
+                     catalog_input_format_ty input_syntax)
+{
+  default_catalog_reader_ty *pop;
+  msgdomain_list_ty *mdlp;
+
+  po_lex_pass_obsolete_entries (true);
+
+#if defined _OPENMP && HAVE_MMAP
+  /* Large PO files are parsed by several threads.  */
+  if (input_syntax == &input_format_po)
+    {
+      mdlp = read_po_parallel (fp, real_filename);
+      if (mdlp != NULL)
+        return mdlp;
+    }
+#endif
+
+  pop = read_catalog_reader_alloc (real_filename);
   if (input_syntax->produces_utf8)
     /* We know a priori that input_syntax->parse convert strings to UTF-8.  */
     pop->mdlp->encoding = po_charset_utf8;
-  po_lex_pass_obsolete_entries (true);
   catalog_reader_parse ((abstract_catalog_reader_ty *) pop, fp, real_filename,
                         logical_filename, input_syntax);
   mdlp = pop->mdlp;
@@ -511,3 +765,147 @@ read_catalog_file (const char *filename, catalog_input_format_ty input_syntax)
 
   return result;
 }
+
+
+#ifdef _OPENMP
+
+/* Number of errors and warnings seen by the current thread while reading
+   a PO file concurrently with other PO files.  */
+static int concurrent_report_count;
+# pragma omp threadprivate (concurrent_report_count)
+
+/* The error handlers in effect while reading PO files concurrently.  They
+   only count the errors and warnings: a file with errors or warnings is
+   read again afterwards, so that they are reported in order.  */
+static void
+concurrent_xerror (int severity,
+                   const struct message_ty *message,
+                   const char *filename, size_t lineno, size_t column,
+                   int multiline_p, const char *message_text)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror (severity, message, filename, lineno, column,
+                  multiline_p, message_text);
+  else
+    concurrent_report_count++;
+}
+
+static void
+concurrent_xerror2 (int severity,
+                    const struct message_ty *message1,
+                    const char *filename1, size_t lineno1, size_t column1,
+                    int multiline_p1, const char *message_text1,
+                    const struct message_ty *message2,
+                    const char *filename2, size_t lineno2, size_t column2,
+                    int multiline_p2, const char *message_text2)
+{
+  if (severity == PO_SEVERITY_FATAL_ERROR)
+    saved_xerror2 (severity, message1, filename1, lineno1, column1,
+                   multiline_p1, message_text1,
+                   message2, filename2, lineno2, column2,
+                   multiline_p2, message_text2);
+  else
+    concurrent_report_count++;
+}
+
+/* Read the PO file FILENAME, while other threads read other PO files.
+   Return NULL if this is not possible or not worth it, or if the file has
+   errors or warnings; then the caller must read it sequentially.  */
+static msgdomain_list_ty *
+read_po_file_concurrently (const char *filename)
+{
+  char *real_filename;
+  FILE *fp;
+  struct stat statbuf;
+  size_t length;
+  char *data;
+  default_catalog_reader_ty *pop;
+  msgdomain_list_ty *mdlp;
+
+  if (strcmp (filename, "-") == 0 || strcmp (filename, "/dev/stdin") == 0)
+    return NULL;
+
+  fp = open_catalog_file (filename, &real_filename, false);
+  if (fp == NULL)
+    return NULL;
+  if (fstat (fileno (fp), &statbuf) < 0
+      || !S_ISREG (statbuf.st_mode)
+# if HAVE_MMAP
+      /* Large files are better parsed by several threads each.  */
+      || statbuf.st_size >= PARALLEL_PARSE_MIN_SIZE
+# endif
+      || statbuf.st_size != (size_t) statbuf.st_size)
+    {
+      fclose (fp);
+      return NULL;
+    }
+  length = statbuf.st_size;
+  data = XNMALLOC (length, char);
+  if (fread (data, 1, length, fp) != length)
+    {
+      free (data);
+      fclose (fp);
+      return NULL;
+    }
+  fclose (fp);
+
+  concurrent_report_count = 0;
+  pop = read_catalog_reader_alloc (real_filename);
+  catalog_reader_parse_po_chunk ((abstract_catalog_reader_ty *) pop,
+                                 data, length, real_filename, 1, NULL);
+  mdlp = pop->mdlp;
+  catalog_reader_free ((abstract_catalog_reader_ty *) pop);
+  free (data);
+
+  if (concurrent_report_count > 0)
+    {
+      msgdomain_list_free (mdlp);
+      mdlp = NULL;
+    }
+  return mdlp;
+}
+
+#endif
+
+
+msgdomain_list_ty **
+read_catalog_files (const char * const *filenames, size_t nfiles,
+                    catalog_input_format_ty input_syntax)
+{
+  msgdomain_list_ty **result = XNMALLOC (nfiles, msgdomain_list_ty *);
+  size_t i;
+
+  for (i = 0; i < nfiles; i++)
+    result[i] = NULL;
+
+#ifdef _OPENMP
+  /* Only the PO lexer and parser can be used by several threads at once.  */
+  if (input_syntax == &input_format_po
+      && nfiles > 1 && !omp_in_parallel () && omp_get_max_threads () > 1)
+    {
+      long int n;
+
+      po_lex_pass_obsolete_entries (true);
+
+      saved_xerror = po_xerror;
+      saved_xerror2 = po_xerror2;
+      po_xerror = concurrent_xerror;
+      po_xerror2 = concurrent_xerror2;
+
+      #pragma omp parallel for schedule(dynamic)
+      for (n = 0; n < (long int) nfiles; n++)
+        result[n] = read_po_file_concurrently (filenames[n]);
+
+      po_xerror = saved_xerror;
+      po_xerror2 = saved_xerror2;
+    }
+#endif
+
+  /* Read the remaining files one after the other, so that their errors and
+     warnings are reported in the order of the files.  */
+  for (i = 0; i < nfiles; i++)
+    if (result[i] == NULL)
+      result[i] = read_catalog_file (filenames[i], input_syntax);
+
+  return result;
+}
@@ -148,6 +148,8 @@ extern void default_comment_filepos (abstract_catalog_reader_ty *that,
                                      const char *name, size_t line);
 extern void default_comment_special (abstract_catalog_reader_ty *that,
                                      const char *s);
+extern void default_comment_format (abstract_catalog_reader_ty *that,
+                                    const enum is_format formatp[NFORMATS]);
 extern void default_set_domain (default_catalog_reader_ty *this, char *name);
 extern void default_add_message (default_catalog_reader_ty *this,
                                  char *msgctxt,
@@ -191,6 +193,14 @@ extern msgdomain_list_ty *
        read_catalog_file (const char *input_name,
                           catalog_input_format_ty input_syntax);
 
+/* Read the input files FILENAMES[0..NFILES-1], like read_catalog_file,
+   several of them at the same time on systems with OpenMP.  Returns a
+   freshly allocated array of the lists of messages, in the same order.
+   The errors and warnings are reported in the order of the files.  */
+extern msgdomain_list_ty **
+       read_catalog_files (const char * const *filenames, size_t nfiles,
+                           catalog_input_format_ty input_syntax);
+
 
 #ifdef __cplusplus
 }
@@ -21,6 +21,9 @@
 /* Specification.  */
 #include "read-po.h"
 
+#include <stdbool.h>
+#include <string.h>
+
 #include "po-lex.h"
 #include "po-gram.h"
 
@@ -46,3 +49,172 @@ const struct catalog_input_format input_format_po =
   po_parse,                             /* parse */
   false                                 /* produces_utf8 */
 };
+
+
+/* Splitting PO files into independent parts.  */
+
+/* Classification of the lines of a PO file.  */
+enum po_line_kind
+{
+  line_blank,           /* only whitespace */
+  line_comment,         /* a comment, including #| and #~| */
+  line_intro,           /* msgctxt or msgid */
+  line_msgid_plural,    /* msgid_plural */
+  line_msgstr,          /* msgstr or msgstr[n] */
+  line_string,          /* a string that continues the previous keyword */
+  line_domain,          /* a 'domain' directive */
+  line_other
+};
+
+/* Test whether the line starting at P, ending before END, starts with the
+   keyword KEYWORD.  */
+static bool
+line_has_keyword (const char *p, const char *end, const char *keyword)
+{
+  size_t len = strlen (keyword);
+
+  if ((size_t) (end - p) < len || memcmp (p, keyword, len) != 0)
+    return false;
+  if ((size_t) (end - p) == len)
+    return true;
+  switch (p[len])
+    {
+    case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g':
+    case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n':
+    case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+    case 'v': case 'w': case 'x': case 'y': case 'z':
+    case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G':
+    case 'H': case 'I': case 'J': case 'K': case 'L': case 'M': case 'N':
+    case 'O': case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
+    case 'V': case 'W': case 'X': case 'Y': case 'Z':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+    case '_': case '$':
+      return false;
+    default:
+      return true;
+    }
+}
+
+/* Classify the line starting at P, ending before END.  */
+static enum po_line_kind
+classify_line (const char *p, const char *end)
+{
+  bool obsolete = false;
+
+  for (;;)
+    {
+      while (p < end
+             && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\f'
+                 || *p == '\v'))
+        p++;
+      if (p == end)
+        return (obsolete ? line_other : line_blank);
+      if (*p == '#')
+        {
+          if (!obsolete && p + 1 < end && p[1] == '~')
+            {
+              /* An obsolete entry's line.  Classify what follows.  */
+              obsolete = true;
+              p += 2;
+              if (p < end && *p == '|')
+                return line_comment;
+              continue;
+            }
+          return (obsolete ? line_other : line_comment);
+        }
+      break;
+    }
+
+  if (*p == '"')
+    return line_string;
+  if (line_has_keyword (p, end, "msgctxt") || line_has_keyword (p, end, "msgid"))
+    return line_intro;
+  if (line_has_keyword (p, end, "msgid_plural"))
+    return line_msgid_plural;
+  if (line_has_keyword (p, end, "msgstr"))
+    /* This includes msgstr[n].  */
+    return line_msgstr;
+  if (line_has_keyword (p, end, "domain"))
+    return line_domain;
+  return line_other;
+}
+
+size_t
+po_split_entries (const char *data, size_t length, size_t n,
+                  size_t *offsets, size_t *lines)
+{
+  const char *end = data + length;
+  const char *p;
+  size_t line_number;
+  size_t count;
+  size_t part_size;
+  size_t threshold;
+  /* True if the last keyword seen was msgstr.  */
+  bool in_msgstr;
+  /* True if the last non-blank line completes an entry, as far as the
+     lines seen so far tell.  */
+  bool entry_complete;
+  /* True if a blank line was seen after the last non-blank line.  */
+  bool blank_seen;
+
+  offsets[0] = 0;
+  lines[0] = 1;
+  count = 1;
+  part_size = 0;
+  threshold = 0;
+  in_msgstr = false;
+  entry_complete = false;
+  blank_seen = false;
+
+  for (p = data, line_number = 1; p < end; line_number++)
+    {
+      const char *eol = (const char *) memchr (p, '\n', end - p);
+      const char *line_end = (eol != NULL ? eol : end);
+      enum po_line_kind kind = classify_line (p, line_end);
+
+      if (kind == line_domain)
+        return 0;
+
+      if (kind != line_blank)
+        {
+          /* An entry boundary is an empty line that follows the msgstr of
+             an entry and precedes the comments, msgctxt or msgid of the next
+             entry.  */
+          if (blank_seen && entry_complete
+              && (kind == line_comment || kind == line_intro)
+              && p - data >= threshold
+              && count <= n)
+            {
+              if (count == 1)
+                part_size = (length - (p - data)) / n;
+              threshold = (p - data) + part_size;
+              offsets[count] = p - data;
+              lines[count] = line_number;
+              count++;
+            }
+
+          if (kind == line_msgstr)
+            in_msgstr = true;
+          else if (kind == line_intro || kind == line_msgid_plural
+                   || kind == line_other)
+            in_msgstr = false;
+
+          /* A backslash-newline continues the line.  */
+          entry_complete =
+            in_msgstr
+            && (kind == line_msgstr || kind == line_string)
+            && !(line_end > p && line_end[-1] == '\\');
+          blank_seen = false;
+        }
+      else
+        blank_seen = true;
+
+      if (eol == NULL)
+        break;
+      p = eol + 1;
+    }
+
+  offsets[count] = length;
+  return count;
+}
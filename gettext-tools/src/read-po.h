@@ -23,4 +23,15 @@
 /* Describes a .po / .pot file parser.  */
 extern DLL_VARIABLE const struct catalog_input_format input_format_po;
 
+/* Determine where the PO file contents DATA[0..LENGTH-1] can be split into
+   parts that can be parsed independently.  The first part consists of the
+   first entry, normally the header entry; the rest is split into at most N
+   parts of roughly equal size.  Store the start offset and the line number
+   of each part in OFFSETS[] and LINES[], which must have room for N + 2
+   elements; OFFSETS[result] is set to LENGTH.  Return the number of parts,
+   or 0 if the contents cannot be split, because it contains 'domain'
+   directives.  */
+extern size_t po_split_entries (const char *data, size_t length, size_t n,
+                                size_t *offsets, size_t *lines);
+
 #endif /* _READ_PO_H */
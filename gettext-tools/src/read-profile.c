@@ -0,0 +1,345 @@
+/* Reading lookup profiles of the GNU libintl library.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "read-profile.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "message.h"
+#include "po-error.h"
+#include "po-xerror.h"
+#include "hash.h"
+#include "xalloc.h"
+#include "xvasprintf.h"
+#include "gettext.h"
+
+#define _(str) gettext (str)
+
+
+/* A lookup profile, as written by libintl when the environment variable
+   GETTEXT_PROFILE is set, consists of comment lines starting with '#' and
+   of lines of the form
+     COUNT <TAB> "DOMAIN" <TAB> "MSGID" [<TAB> "MSGID_PLURAL"]
+   where the strings use C escape sequences and the MSGID includes the
+   msgctxt, separated by MSGCTXT_SEPARATOR.  Several runs of a program may
+   append their profiles to the same file; the counts are added.  */
+
+#define LOOKUP_PROFILE_MAGIC "# GNU gettext lookup profile"
+
+
+bool
+is_lookup_profile (const char *filename)
+{
+  char buf[sizeof (LOOKUP_PROFILE_MAGIC) - 1];
+  FILE *fp;
+  bool result;
+
+  if (strcmp (filename, "-") == 0 || strcmp (filename, "/dev/stdin") == 0)
+    return false;
+  fp = fopen (filename, "r");
+  if (fp == NULL)
+    return false;
+  result = (fread (buf, 1, sizeof (buf), fp) == sizeof (buf)
+            && memcmp (buf, LOOKUP_PROFILE_MAGIC, sizeof (buf)) == 0);
+  fclose (fp);
+  return result;
+}
+
+
+/* The accumulated counts of a msgid.  */
+struct profile_record
+{
+  size_t domain_index;
+  char *msgid;
+  char *msgid_plural;
+  unsigned long int count;
+  size_t index;                 /* order of first appearance */
+  size_t line_number;           /* line of first appearance */
+};
+
+
+/* Parse a quoted string at *P, and advance *P past it.  Return the
+   unescaped string, or NULL if the syntax is invalid.  */
+static char *
+parse_string (const char **p)
+{
+  const char *s = *p;
+  char *result;
+  size_t length;
+
+  if (*s != '"')
+    return NULL;
+  s++;
+  result = XNMALLOC (strlen (s) + 1, char);
+  length = 0;
+  for (;;)
+    {
+      char c = *s++;
+
+      if (c == '"')
+        break;
+      if (c == '\0' || c == '\n')
+        {
+          free (result);
+          return NULL;
+        }
+      if (c == '\\')
+        {
+          c = *s++;
+          switch (c)
+            {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'a': c = '\a'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'v': c = '\v'; break;
+            case '"': case '\\': break;
+            case '0': case '1': case '2': case '3':
+            case '4': case '5': case '6': case '7':
+              {
+                int value = c - '0';
+                int n;
+
+                for (n = 1; n < 3 && *s >= '0' && *s <= '7'; n++)
+                  value = 8 * value + (*s++ - '0');
+                c = (char) value;
+              }
+              break;
+            default:
+              free (result);
+              return NULL;
+            }
+        }
+      result[length++] = c;
+    }
+  result[length] = '\0';
+  *p = s;
+  return result;
+}
+
+
+/* Order the records by domain, then by decreasing count, then by their
+   first appearance.  */
+static int
+record_cmp (const void *p1, const void *p2)
+{
+  const struct profile_record *r1 = *(const struct profile_record * const *) p1;
+  const struct profile_record *r2 = *(const struct profile_record * const *) p2;
+
+  if (r1->domain_index != r2->domain_index)
+    return (r1->domain_index < r2->domain_index ? -1 : 1);
+  if (r1->count != r2->count)
+    return (r1->count > r2->count ? -1 : 1);
+  return (r1->index < r2->index ? -1 : r1->index > r2->index ? 1 : 0);
+}
+
+
+static void
+profile_parse (abstract_catalog_reader_ty *pop, FILE *fp,
+               const char *real_filename, const char *logical_filename)
+{
+  char **domains = NULL;
+  size_t ndomains = 0;
+  size_t domains_alloc = 0;
+  struct profile_record **records = NULL;
+  size_t nrecords = 0;
+  size_t records_alloc = 0;
+  hash_table index;
+  char *line = NULL;
+  size_t line_size = 0;
+  size_t line_number = 0;
+  size_t i;
+
+  hash_init (&index, 100);
+
+  for (;;)
+    {
+      ssize_t len = getline (&line, &line_size, fp);
+      const char *p;
+      unsigned long int count;
+      char *end;
+      char *domain;
+      char *msgid;
+      char *msgid_plural;
+      size_t domain_index;
+      char *key;
+      size_t keylen;
+      void *found;
+
+      if (len < 0)
+        break;
+      line_number++;
+
+      if (line_number == 1
+          && strncmp (line, LOOKUP_PROFILE_MAGIC,
+                      strlen (LOOKUP_PROFILE_MAGIC)) != 0)
+        po_error (EXIT_FAILURE, 0, _("file \"%s\" is not a lookup profile"),
+                  real_filename);
+      if (line[0] == '#' || line[0] == '\n')
+        continue;
+
+      /* Parse COUNT "DOMAIN" "MSGID" ["MSGID_PLURAL"].  */
+      domain = msgid = msgid_plural = NULL;
+      count = strtoul (line, &end, 10);
+      p = end;
+      if (p == line || *p++ != '\t'
+          || (domain = parse_string (&p)) == NULL
+          || *p++ != '\t'
+          || (msgid = parse_string (&p)) == NULL
+          || (*p == '\t'
+              && (p++, (msgid_plural = parse_string (&p)) == NULL))
+          || (*p != '\n' && *p != '\0'))
+        {
+          po_xerror (PO_SEVERITY_ERROR, NULL,
+                     real_filename, line_number, (size_t)(-1), false,
+                     _("invalid line in lookup profile"));
+          free (domain);
+          free (msgid);
+          continue;
+        }
+
+      /* The header entry is looked up by libintl itself and is of no
+         interest here.  */
+      if (msgid[0] == '\0')
+        {
+          free (domain);
+          free (msgid);
+          free (msgid_plural);
+          continue;
+        }
+
+      for (domain_index = 0; domain_index < ndomains; domain_index++)
+        if (strcmp (domains[domain_index], domain) == 0)
+          break;
+      if (domain_index == ndomains)
+        {
+          if (ndomains == domains_alloc)
+            {
+              domains_alloc = 2 * domains_alloc + 4;
+              domains = (char **)
+                xrealloc (domains, domains_alloc * sizeof (char *));
+            }
+          domains[ndomains++] = domain;
+        }
+      else
+        free (domain);
+
+      /* Add up the counts of the same msgid in the same domain.  */
+      keylen = strlen (msgid) + 1 + strlen (domains[domain_index]);
+      key = XNMALLOC (keylen + 1, char);
+      strcpy (stpcpy (key, msgid) + 1, domains[domain_index]);
+      if (hash_find_entry (&index, key, keylen, &found) == 0)
+        {
+          ((struct profile_record *) found)->count += count;
+          free (msgid);
+          free (msgid_plural);
+        }
+      else
+        {
+          struct profile_record *record = XMALLOC (struct profile_record);
+
+          record->domain_index = domain_index;
+          record->msgid = msgid;
+          record->msgid_plural = msgid_plural;
+          record->count = count;
+          record->index = nrecords;
+          record->line_number = line_number;
+          if (nrecords == records_alloc)
+            {
+              records_alloc = 2 * records_alloc + 64;
+              records = (struct profile_record **)
+                xrealloc (records,
+                          records_alloc * sizeof (struct profile_record *));
+            }
+          records[nrecords++] = record;
+          hash_insert_entry (&index, key, keylen, record);
+        }
+      free (key);
+    }
+
+  if (ferror (fp))
+    po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+               xasprintf ("%s: %s",
+                          xasprintf (_("error while reading \"%s\""),
+                                     real_filename),
+                          strerror (errno)));
+  free (line);
+  hash_destroy (&index);
+
+  /* Present the most frequently looked up messages first.  */
+  qsort (records, nrecords, sizeof (struct profile_record *), record_cmp);
+
+  for (i = 0; i < nrecords; i++)
+    {
+      struct profile_record *record = records[i];
+      char *msgctxt;
+      char *msgid;
+      char *separator;
+      char *comment;
+      lex_pos_ty pos;
+
+      if (i == 0
+          ? strcmp (domains[record->domain_index], MESSAGE_DOMAIN_DEFAULT) != 0
+          : record->domain_index != records[i - 1]->domain_index)
+        po_callback_domain (xstrdup (domains[record->domain_index]));
+
+      comment = xasprintf ("lookups: %lu", record->count);
+      po_callback_comment_dot (comment);
+      free (comment);
+
+      separator = strchr (record->msgid, MSGCTXT_SEPARATOR);
+      if (separator != NULL)
+        {
+          *separator = '\0';
+          msgctxt = record->msgid;
+          msgid = xstrdup (separator + 1);
+        }
+      else
+        {
+          msgctxt = NULL;
+          msgid = record->msgid;
+        }
+
+      pos.file_name = (char *) logical_filename;
+      pos.line_number = record->line_number;
+      po_callback_message (msgctxt, msgid, &pos, record->msgid_plural,
+                           xstrdup (""), 1, &pos,
+                           NULL, NULL, NULL,
+                           false, false);
+      free (record);
+    }
+
+  free (records);
+  for (i = 0; i < ndomains; i++)
+    free (domains[i]);
+  free (domains);
+}
+
+const struct catalog_input_format input_format_profile =
+{
+  profile_parse,                        /* parse */
+  false                                 /* produces_utf8 */
+};
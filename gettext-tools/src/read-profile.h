@@ -0,0 +1,32 @@
+/* Reading lookup profiles of the GNU libintl library.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _READ_PROFILE_H
+#define _READ_PROFILE_H
+
+#include <stdbool.h>
+
+#include "read-catalog-abstract.h"
+
+/* Describes a parser of the lookup profiles that libintl writes when the
+   environment variable GETTEXT_PROFILE is set.  It yields the looked up
+   messages, most frequently looked up first, with empty translations.  */
+extern DLL_VARIABLE const struct catalog_input_format input_format_profile;
+
+/* Return true if the file FILENAME is a lookup profile.  */
+extern bool is_lookup_profile (const char *filename);
+
+#endif /* _READ_PROFILE_H */
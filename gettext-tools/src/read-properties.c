@@ -36,6 +36,7 @@
 #include "xalloc.h"
 #include "xvasprintf.h"
 #include "po-xerror.h"
+#include "po-lex.h"
 #include "msgl-ascii.h"
 #include "unistr.h"
 #include "gettext.h"
@@ -62,9 +63,6 @@
 /* Real filename, used in error messages about the input file.  */
 static const char *real_file_name;
 
-/* File name and line number.  */
-extern lex_pos_ty gram_pos;
-
 /* The input file stream.  */
 static FILE *fp;
 
@@ -0,0 +1,325 @@
+/* Writing binary intermediate catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "write-binary.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* This include file describes the binary catalog format.  */
+#include "binary-catalog.h"
+
+#include "message.h"
+#include "ostream.h"
+#include "hash.h"
+#include "xalloc.h"
+
+
+/* The whole catalog is serialized into memory and then written out with a
+   single call.  This struct represents the output being built.  */
+struct binary_buffer
+{
+  char *data;
+  size_t length;
+  size_t allocated;
+};
+
+/* Make room for N more bytes.  */
+static inline void
+buffer_reserve (struct binary_buffer *bp, size_t n)
+{
+  if (bp->length + n > bp->allocated)
+    {
+      bp->allocated = 2 * bp->allocated;
+      if (bp->allocated < bp->length + n)
+        bp->allocated = bp->length + n + 4096;
+      bp->data = (char *) xrealloc (bp->data, bp->allocated);
+    }
+}
+
+static void
+write_bytes (struct binary_buffer *bp, const char *s, size_t n)
+{
+  buffer_reserve (bp, n);
+  memcpy (bp->data + bp->length, s, n);
+  bp->length += n;
+}
+
+/* Store a number, 7 bits per byte.  */
+static void
+write_number (struct binary_buffer *bp, size_t value)
+{
+  buffer_reserve (bp, (sizeof (size_t) * 8 + 6) / 7);
+  while (value >= 0x80)
+    {
+      bp->data[bp->length++] = (char) ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+  bp->data[bp->length++] = (char) value;
+}
+
+/* Store a string that may be NULL.  */
+static void
+write_string (struct binary_buffer *bp, const char *s)
+{
+  if (s == NULL)
+    write_number (bp, 0);
+  else
+    {
+      size_t n = strlen (s);
+
+      write_number (bp, n + 1);
+      write_bytes (bp, s, n);
+    }
+}
+
+static inline void
+write_line_number (struct binary_buffer *bp, size_t line_number)
+{
+  write_number (bp, line_number + 1);
+}
+
+
+/* The file names are stored once, in a table at the beginning of the file.
+   This struct maps file names to their index in that table.  */
+struct file_name_table
+{
+  hash_table map;
+  const char **names;
+  size_t nnames;
+  size_t nnames_max;
+};
+
+static void
+file_name_table_add (struct file_name_table *tp, const char *name)
+{
+  void *dummy;
+
+  if (hash_find_entry (&tp->map, name, strlen (name), &dummy) == 0)
+    return;
+  hash_insert_entry (&tp->map, name, strlen (name),
+                     (void *) (uintptr_t) tp->nnames);
+  if (tp->nnames == tp->nnames_max)
+    {
+      tp->nnames_max = 2 * tp->nnames_max + 16;
+      tp->names =
+        (const char **) xrealloc (tp->names,
+                                  tp->nnames_max * sizeof (const char *));
+    }
+  tp->names[tp->nnames++] = name;
+}
+
+static size_t
+file_name_table_index (struct file_name_table *tp, const char *name)
+{
+  void *value;
+
+  if (hash_find_entry (&tp->map, name, strlen (name), &value) != 0)
+    abort ();
+  return (uintptr_t) value;
+}
+
+
+/* Store the flags of MP other than the format flags, in the syntax of a
+   '#,' comment line, followed by the format flags.  Unlike
+   message_print_comment_flags, this keeps all flags and all values of
+   enum is_format, so that the message is restored unchanged.  */
+static void
+write_flags (struct binary_buffer *bp, struct binary_buffer *tmp,
+             const message_ty *mp)
+{
+  size_t nformats;
+  size_t i;
+
+  tmp->length = 0;
+  if (mp->is_fuzzy)
+    write_bytes (tmp, "fuzzy, ", 7);
+  if (has_range_p (mp->range))
+    {
+      char range[100];
+
+      sprintf (range, "range: %d..%d, ", mp->range.min, mp->range.max);
+      write_bytes (tmp, range, strlen (range));
+    }
+  if (mp->do_wrap == yes)
+    write_bytes (tmp, "wrap, ", 6);
+  else if (mp->do_wrap == no)
+    write_bytes (tmp, "no-wrap, ", 9);
+
+  /* Drop the trailing ", ".  */
+  if (tmp->length > 0)
+    tmp->length -= 2;
+  write_number (bp, tmp->length + 1);
+  write_bytes (bp, tmp->data, tmp->length);
+
+  nformats = 0;
+  for (i = 0; i < NFORMATS; i++)
+    if (mp->is_format[i] != undecided)
+      nformats++;
+  write_number (bp, nformats);
+  for (i = 0; i < NFORMATS; i++)
+    if (mp->is_format[i] != undecided)
+      {
+        write_string (bp, format_language[i]);
+        write_number (bp, mp->is_format[i]);
+      }
+}
+
+
+static void
+write_message (struct binary_buffer *bp, struct binary_buffer *tmp,
+               struct file_name_table *files, const message_ty *mp)
+{
+  size_t j;
+
+  write_string (bp, mp->msgctxt);
+  write_string (bp, mp->msgid);
+  write_string (bp, mp->msgid_plural);
+  write_number (bp, mp->msgstr_len);
+  write_bytes (bp, mp->msgstr, mp->msgstr_len);
+
+  write_number (bp, (mp->pos.file_name != NULL
+                     ? file_name_table_index (files, mp->pos.file_name) + 1
+                     : 0));
+  write_line_number (bp, mp->pos.line_number);
+
+  if (mp->comment != NULL)
+    {
+      write_number (bp, mp->comment->nitems);
+      for (j = 0; j < mp->comment->nitems; j++)
+        write_string (bp, mp->comment->item[j]);
+    }
+  else
+    write_number (bp, 0);
+  if (mp->comment_dot != NULL)
+    {
+      write_number (bp, mp->comment_dot->nitems);
+      for (j = 0; j < mp->comment_dot->nitems; j++)
+        write_string (bp, mp->comment_dot->item[j]);
+    }
+  else
+    write_number (bp, 0);
+  write_number (bp, mp->filepos_count);
+  for (j = 0; j < mp->filepos_count; j++)
+    {
+      write_number (bp, file_name_table_index (files,
+                                               mp->filepos[j].file_name));
+      write_line_number (bp, mp->filepos[j].line_number);
+    }
+
+  write_flags (bp, tmp, mp);
+
+  write_string (bp, mp->prev_msgctxt);
+  write_string (bp, mp->prev_msgid);
+  write_string (bp, mp->prev_msgid_plural);
+  write_number (bp, mp->obsolete ? 1 : 0);
+}
+
+
+char *
+msgdomain_list_to_binary (msgdomain_list_ty *mdlp, size_t *lengthp)
+{
+  struct binary_buffer buffer;
+  struct binary_buffer tmp;
+  struct file_name_table files;
+  size_t k, j, i;
+
+  /* Collect the file names.  */
+  hash_init (&files.map, 100);
+  files.names = NULL;
+  files.nnames = 0;
+  files.nnames_max = 0;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      message_list_ty *mlp = mdlp->item[k]->messages;
+
+      for (j = 0; j < mlp->nitems; j++)
+        {
+          const message_ty *mp = mlp->item[j];
+
+          if (mp->pos.file_name != NULL)
+            file_name_table_add (&files, mp->pos.file_name);
+          for (i = 0; i < mp->filepos_count; i++)
+            file_name_table_add (&files, mp->filepos[i].file_name);
+        }
+    }
+
+  buffer.data = NULL;
+  buffer.length = 0;
+  buffer.allocated = 0;
+  tmp.data = NULL;
+  tmp.length = 0;
+  tmp.allocated = 0;
+
+  write_bytes (&buffer, BINARY_CATALOG_MAGIC, BINARY_CATALOG_MAGIC_LENGTH);
+  write_number (&buffer, BINARY_CATALOG_VERSION);
+
+  write_number (&buffer, files.nnames);
+  for (i = 0; i < files.nnames; i++)
+    write_string (&buffer, files.names[i]);
+
+  write_number (&buffer, mdlp->nitems);
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      message_list_ty *mlp = mdlp->item[k]->messages;
+
+      write_string (&buffer, mdlp->item[k]->domain);
+      write_number (&buffer, mlp->nitems);
+      for (j = 0; j < mlp->nitems; j++)
+        write_message (&buffer, &tmp, &files, mlp->item[j]);
+    }
+
+  free (tmp.data);
+  free (files.names);
+  hash_destroy (&files.map);
+
+  *lengthp = buffer.length;
+  return buffer.data;
+}
+
+
+static void
+msgdomain_list_print_binary (msgdomain_list_ty *mdlp, ostream_t stream,
+                             size_t page_width, bool debug)
+{
+  size_t length;
+  char *data = msgdomain_list_to_binary (mdlp, &length);
+
+  ostream_write_mem (stream, data, length);
+  free (data);
+}
+
+/* Describes a catalog in binary intermediate format.  */
+const struct catalog_output_format output_format_binary =
+{
+  msgdomain_list_print_binary,          /* print */
+  false,                                /* requires_utf8 */
+  false,                                /* supports_color */
+  true,                                 /* supports_multiple_domains */
+  true,                                 /* supports_contexts */
+  true,                                 /* supports_plurals */
+  false,                                /* sorts_obsoletes_to_end */
+  false,                                /* alternative_is_po */
+  false                                 /* alternative_is_java_class */
+};
@@ -0,0 +1,30 @@
+/* Writing binary intermediate catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _WRITE_BINARY_H
+#define _WRITE_BINARY_H
+
+#include "write-catalog.h"
+
+/* Describes a catalog in binary intermediate format.  */
+extern DLL_VARIABLE const struct catalog_output_format output_format_binary;
+
+/* Serialize MDLP in binary intermediate format.  Return the result in
+   freshly allocated memory, and its length in *LENGTHP.  */
+extern char *msgdomain_list_to_binary (msgdomain_list_ty *mdlp,
+                                       size_t *lengthp);
+
+#endif /* _WRITE_BINARY_H */
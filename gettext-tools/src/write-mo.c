@@ -24,6 +24,10 @@
 #include "write-mo.h"
 
 #include <errno.h>
+#include <limits.h>
+#if HAVE_INTTYPES_H
+# include <inttypes.h>
+#endif
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,6 +47,7 @@
 #include "message.h"
 #include "format.h"
 #include "xsize.h"
+#include "xvasprintf.h"
 #include "xalloc.h"
 #include "xmalloca.h"
 #include "binary-io.h"
@@ -73,6 +78,17 @@ bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 bool no_hash_table;
 
+/* True if a string that is the tail of another string shall be stored as
+   part of that string.  */
+bool merge_suffixes;
+
+/* Order of the strings in the resulting .mo file.  */
+enum mo_string_order string_order = mo_string_order_msgid;
+
+/* If not NULL, the messages whose strings are placed first, in this
+   order.  */
+message_list_ty *string_order_profile;
+
 
 /* Destructively changes the byte order of a 32-bit value in memory.  */
 #define BSWAP32(x) (x) = bswap_32 (x)
@@ -93,7 +109,8 @@ struct pre_string
   const char *pointer;
 };
 
-/* An intermediate data structure representing a message.  */
+/* An intermediate data structure representing a message.  The id_plural,
+   if present, immediately follows str[M_ID] in memory.  */
 struct pre_message
 {
   struct pre_string str[2];
@@ -140,17 +157,437 @@ struct pre_sysdep_message
   size_t id_plural_len;
 };
 
+/* Expanding the system dependent strings at compile time requires the
+   values of the ISO C 99 <inttypes.h> format string directives.  */
+#if HAVE_INTTYPES_H && defined PRIdMAX && !PRI_MACROS_BROKEN
+# define SYSDEP_EXPANSION 1
+#else
+# define SYSDEP_EXPANSION 0
+#endif
+
+#if SYSDEP_EXPANSION
+
+# define SIZEOF(a) (sizeof(a) / sizeof(a[0]))
+
+# define SYSDEP_PRI(c) \
+  { "PRI" #c "8", PRI##c##8 }, \
+  { "PRI" #c "16", PRI##c##16 }, \
+  { "PRI" #c "32", PRI##c##32 }, \
+  { "PRI" #c "64", PRI##c##64 }, \
+  { "PRI" #c "LEAST8", PRI##c##LEAST8 }, \
+  { "PRI" #c "LEAST16", PRI##c##LEAST16 }, \
+  { "PRI" #c "LEAST32", PRI##c##LEAST32 }, \
+  { "PRI" #c "LEAST64", PRI##c##LEAST64 }, \
+  { "PRI" #c "FAST8", PRI##c##FAST8 }, \
+  { "PRI" #c "FAST16", PRI##c##FAST16 }, \
+  { "PRI" #c "FAST32", PRI##c##FAST32 }, \
+  { "PRI" #c "FAST64", PRI##c##FAST64 }, \
+  { "PRI" #c "MAX", PRI##c##MAX }, \
+  { "PRI" #c "PTR", PRI##c##PTR }
+
+static const struct { const char *name; const char *value; }
+  sysdep_segment_table[] =
+  {
+    SYSDEP_PRI (d), SYSDEP_PRI (i), SYSDEP_PRI (o),
+    SYSDEP_PRI (u), SYSDEP_PRI (x), SYSDEP_PRI (X)
+  };
+
+# undef SYSDEP_PRI
+
+/* Return the value of the system dependent segment NAME of length LENGTH
+   on this platform, like libintl's get_sysdep_segment_value() does at run
+   time, or NULL if the segment has no value.  */
+static const char *
+get_sysdep_segment_value (const char *name, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < SIZEOF (sysdep_segment_table); i++)
+    if (strlen (sysdep_segment_table[i].name) == length
+        && memcmp (sysdep_segment_table[i].name, name, length) == 0)
+      return sysdep_segment_table[i].value;
+  if (length == 1 && name[0] == 'I')
+    {
+# if (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 2)) \
+     && !defined __UCLIBC__
+      return "I";
+# else
+      return "";
+# endif
+    }
+  return NULL;
+}
+
+/* Return the concatenation of the segments of PRE, with the system dependent
+   segments replaced by VALUES, and store its length in *LENGTHP.  Allocate
+   EXTRA more bytes after it.  */
+static char *
+expand_sysdep_string (const struct pre_sysdep_string *pre,
+                      const char **values, size_t extra, size_t *lengthp)
+{
+  size_t length;
+  char *result;
+  char *p;
+  unsigned int i;
+
+  length = 0;
+  for (i = 0; i <= pre->segmentcount; i++)
+    {
+      length += pre->segments[i].segsize;
+      if (i < pre->segmentcount)
+        length += strlen (values[pre->segments[i].sysdepref]);
+    }
+  result = XNMALLOC (length + extra, char);
+  p = result;
+  for (i = 0; i <= pre->segmentcount; i++)
+    {
+      memcpy (p, pre->segments[i].segptr, pre->segments[i].segsize);
+      p += pre->segments[i].segsize;
+      if (i < pre->segmentcount)
+        p = stpcpy (p, values[pre->segments[i].sysdepref]);
+    }
+  *lengthp = length;
+  return result;
+}
+
+#endif
+
+/* Insert the NSTRINGS strings of MSG_ARR into the hash table HASH_TAB of size
+   HASH_TAB_SIZE, following the algorithm described in write_table.  */
+static void
+fill_hash_table (nls_uint32 *hash_tab, nls_uint32 hash_tab_size,
+                 const struct pre_message *msg_arr, size_t nstrings)
+{
+  size_t j;
+
+  memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
+  for (j = 0; j < nstrings; j++)
+    {
+      nls_uint32 hash_val = hash_string (msg_arr[j].str[M_ID].pointer);
+      nls_uint32 idx = hash_val % hash_tab_size;
+
+      if (hash_tab[idx] != 0)
+        {
+          /* We need the second hashing function.  */
+          nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
+
+          do
+            if (idx >= hash_tab_size - incr)
+              idx -= hash_tab_size - incr;
+            else
+              idx += incr;
+          while (hash_tab[idx] != 0);
+        }
+
+      hash_tab[idx] = j + 1;
+    }
+}
+
+/* The contents of the .mo file, built in memory and written out at once.  */
+struct mo_image
+{
+  char *data;
+  size_t length;
+  size_t allocated;
+};
+
+static void
+image_append (struct mo_image *ip, const void *p, size_t n)
+{
+  if (ip->length + n > ip->allocated)
+    {
+      ip->allocated = 2 * ip->allocated;
+      if (ip->allocated < ip->length + n)
+        ip->allocated = ip->length + n + 4096;
+      ip->data = (char *) xrealloc (ip->data, ip->allocated);
+    }
+  memcpy (ip->data + ip->length, p, n);
+  ip->length += n;
+}
+
+/* Append zero bytes up to the given offset.  */
+static void
+image_pad (struct mo_image *ip, size_t offset)
+{
+  while (ip->length < offset)
+    {
+      static const char null[16];
+      size_t n = offset - ip->length;
+
+      image_append (ip, null, n < sizeof (null) ? n : sizeof (null));
+    }
+}
+
+
+/* A string of the string section: an original string (including the
+   msgid_plural) or a translated string.  Identical strings are stored only
+   once, and with merge_suffixes, a string that is the tail of another
+   string is stored as part of it.  */
+struct pool_string
+{
+  const char *pointer;
+  size_t length;
+  /* The string whose bytes contain this string.  */
+  struct pool_string *stored_in;
+  /* The offset of the string in the file, or 0 if not yet assigned.  */
+  size_t offset;
+};
+
+/* Compute a hash code of the N bytes at P.  The bytes are combined a word
+   at a time.  */
+static size_t
+hash_pool_string (const char *p, size_t n)
+{
+  size_t hval = n;
+  size_t word;
+
+  for (; n >= sizeof (size_t); n -= sizeof (size_t), p += sizeof (size_t))
+    {
+      memcpy (&word, p, sizeof (size_t));
+      hval = (hval << 9) | (hval >> (sizeof (size_t) * CHAR_BIT - 9));
+      hval ^= word;
+    }
+  for (; n > 0; n--)
+    {
+      hval = (hval << 9) | (hval >> (sizeof (size_t) * CHAR_BIT - 9));
+      hval += (unsigned char) *p++;
+    }
+  return hval;
+}
+
+/* Compare the strings backwards, so that a string comes before the strings
+   of which it is the tail.  */
+static int
+compare_pool_string_reversed (const void *pval1, const void *pval2)
+{
+  const struct pool_string *s1 = *(const struct pool_string * const *) pval1;
+  const struct pool_string *s2 = *(const struct pool_string * const *) pval2;
+  const unsigned char *p1 = (const unsigned char *) s1->pointer + s1->length;
+  const unsigned char *p2 = (const unsigned char *) s2->pointer + s2->length;
+  size_t n = (s1->length < s2->length ? s1->length : s2->length);
+
+  for (; n > 0; n--)
+    {
+      p1--;
+      p2--;
+      if (*p1 != *p2)
+        return (*p1 < *p2 ? -1 : 1);
+    }
+  return (s1->length < s2->length ? -1 : s1->length > s2->length ? 1 : 0);
+}
+
+/* Determine, for each of the NSTRINGS strings in POOL, the string in which
+   it is stored.  */
+static void
+share_pool_strings (struct pool_string *pool, size_t nstrings)
+{
+  size_t table_size;
+  struct pool_string **table;
+  size_t j;
+
+  if (nstrings == 0)
+    return;
+
+  /* Find the identical strings, through a hash table with open addressing.  */
+  table_size = next_prime (2 * nstrings);
+  table =
+    (struct pool_string **) xcalloc (table_size, sizeof (struct pool_string *));
+  for (j = 0; j < nstrings; j++)
+    {
+      struct pool_string *s = &pool[j];
+      size_t idx = hash_pool_string (s->pointer, s->length) % table_size;
+
+      s->offset = 0;
+      for (;;)
+        {
+          struct pool_string *t = table[idx];
+
+          if (t == NULL)
+            {
+              table[idx] = s;
+              s->stored_in = s;
+              break;
+            }
+          if (t->length == s->length
+              && memcmp (t->pointer, s->pointer, s->length) == 0)
+            {
+              s->stored_in = t;
+              break;
+            }
+          idx = (idx + 1 < table_size ? idx + 1 : 0);
+        }
+    }
+
+  if (merge_suffixes)
+    {
+      struct pool_string **sorted = table;
+      size_t nunique;
+
+      nunique = 0;
+      for (j = 0; j < table_size; j++)
+        if (table[j] != NULL)
+          sorted[nunique++] = table[j];
+
+      /* After sorting, the strings of which sorted[j] is the tail follow it
+         immediately, and the longest of them can hold all others.  A tail
+         can only be stored inside another string if this keeps it aligned.  */
+      qsort (sorted, nunique, sizeof (struct pool_string *),
+             compare_pool_string_reversed);
+      for (j = nunique - 1; j > 0; j--)
+        {
+          struct pool_string *s = sorted[j - 1];
+          struct pool_string *next = sorted[j];
+          struct pool_string *container = next->stored_in;
+
+          if (s->length < next->length
+              && memcmp (s->pointer, next->pointer + next->length - s->length,
+                         s->length) == 0
+              && (container->length - s->length) % alignment == 0)
+            s->stored_in = container;
+        }
+
+      /* The copies of a tail are stored where the tail is stored.  */
+      for (j = 0; j < nstrings; j++)
+        pool[j].stored_in = pool[j].stored_in->stored_in;
+    }
+
+  free (table);
+}
+
+/* Assign the offsets of the NSTRINGS strings in POOL, in the order given
+   by ORDER, or in the order of POOL if ORDER is NULL, starting at OFFSET.
+   Store the strings that are stored with their own bytes in STORED, in the
+   order of their offsets, and their number in *NSTOREDP.  Return the offset
+   after the last stored string.  */
+static size_t
+layout_pool_strings (struct pool_string *pool, size_t nstrings,
+                     const size_t *order, size_t offset,
+                     struct pool_string **stored, size_t *nstoredp)
+{
+  size_t nstored = 0;
+  size_t j;
+
+  for (j = 0; j < nstrings; j++)
+    {
+      struct pool_string *s = &pool[order != NULL ? order[j] : j];
+      struct pool_string *container = s->stored_in;
+
+      if (container->offset == 0)
+        {
+          offset = roundup (offset, alignment);
+          container->offset = offset;
+          offset += container->length;
+          stored[nstored++] = container;
+        }
+      s->offset = container->offset + container->length - s->length;
+    }
+
+  *nstoredp = nstored;
+  return offset;
+}
+
+
+/* Append the strings of the message INDEX to ORDER, unless already done.  */
+static inline void
+place_message (size_t index, size_t ntotal, size_t *order, size_t *np,
+               bool *placed)
+{
+  if (!placed[index])
+    {
+      order[(*np)++] = index;
+      order[(*np)++] = ntotal + index;
+      placed[index] = true;
+    }
+}
+
+/* Compute the order of the strings of the NSTRINGS + N_EXPANDED messages in
+   MSG_ARR, according to string_order and string_order_profile.  The result
+   lists the indices of the original strings, 0..NSTRINGS + N_EXPANDED - 1,
+   and of the translated strings, NSTRINGS + N_EXPANDED.., such that the
+   translation directly follows the original string.  HASH_TAB_SIZE is the
+   size of the hash table, or 0 if the file has none.  */
+static size_t *
+compute_string_order (const struct pre_message *msg_arr, size_t nstrings,
+                      size_t n_expanded, nls_uint32 hash_tab_size)
+{
+  size_t ntotal = nstrings + n_expanded;
+  size_t *order = XNMALLOC (2 * ntotal, size_t);
+  bool *placed = XCALLOC (ntotal, bool);
+  size_t n = 0;
+  size_t j;
+
+  /* First the messages named in the profile, which the program is known to
+     look up frequently.  */
+  if (string_order_profile != NULL)
+    for (j = 0; j < string_order_profile->nitems; j++)
+      {
+        const message_ty *mp = string_order_profile->item[j];
+        struct pre_message key;
+        const struct pre_message *found;
+        char *msgctid;
+
+        if (mp->msgctxt != NULL)
+          msgctid = xasprintf ("%s%c%s", mp->msgctxt, MSGCTXT_SEPARATOR,
+                               mp->msgid);
+        else
+          msgctid = (char *) mp->msgid;
+        key.str[M_ID].pointer = msgctid;
+        found =
+          (const struct pre_message *)
+          bsearch (&key, msg_arr, nstrings, sizeof (struct pre_message),
+                   compare_id);
+        if (found != NULL)
+          place_message (found - msg_arr, ntotal, order, &n, placed);
+        if (msgctid != mp->msgid)
+          free (msgctid);
+      }
+
+  /* Then, in hash table order, the messages in the order in which the
+     lookups probe them.  */
+  if (string_order == mo_string_order_hash)
+    {
+      nls_uint32 size = hash_tab_size;
+      nls_uint32 *hash_tab;
+      nls_uint32 i;
+
+      if (size == 0)
+        {
+          size = next_prime ((ntotal * 4) / 3);
+          if (size <= 2)
+            size = 3;
+        }
+      hash_tab = XNMALLOC (size, nls_uint32);
+      fill_hash_table (hash_tab, size, msg_arr, ntotal);
+      for (i = 0; i < size; i++)
+        if (hash_tab[i] != 0)
+          place_message (hash_tab[i] - 1, ntotal, order, &n, placed);
+      free (hash_tab);
+    }
+
+  /* Finally the remaining messages, in msgid order.  */
+  for (j = 0; j < ntotal; j++)
+    place_message (j, ntotal, order, &n, placed);
+
+  free (placed);
+  return order;
+}
+
+
 /* Write the message list to the given open file.  */
 static void
 write_table (FILE *output_file, message_list_ty *mlp)
 {
-  char **msgctid_arr;
+  char *msgctids;
+  size_t msgctids_size;
+  char *msgctid;
   size_t nstrings;
   struct pre_message *msg_arr;
   size_t n_sysdep_strings;
   struct pre_sysdep_message *sysdep_msg_arr;
   size_t n_sysdep_segments;
   struct pre_sysdep_segment *sysdep_segments;
+  const char **sysdep_values;
+  size_t n_expanded;
   bool have_outdigits;
   int major_revision;
   int minor_revision;
@@ -163,13 +600,32 @@ write_table (FILE *output_file, message_list_ty *mlp)
   struct string_desc *trans_tab;
   size_t sysdep_tab_offset = 0;
   size_t end_offset;
-  char *null;
+  struct pool_string *pool;
+  size_t *order;
+  struct pool_string **stored;
+  size_t nstored;
+  struct mo_image image;
   size_t j, m;
 
+  /* The concatenations of msgctxt and msgid, each followed by the
+     msgid_plural, are stored in a single block of memory.  */
+  msgctids_size = 0;
+  for (j = 0; j < mlp->nitems; j++)
+    {
+      message_ty *mp = mlp->item[j];
+
+      msgctids_size += (mp->msgctxt != NULL ? strlen (mp->msgctxt) + 1 : 0)
+                       + strlen (mp->msgid) + 1
+                       + (mp->msgid_plural != NULL
+                          ? strlen (mp->msgid_plural) + 1
+                          : 0);
+    }
+  msgctids = XNMALLOC (msgctids_size, char);
+
   /* First pass: Move the static string pairs into an array, for sorting,
      and at the same time, compute the segments of the system dependent
      strings.  */
-  msgctid_arr = XNMALLOC (mlp->nitems, char *);
+  msgctid = msgctids;
   nstrings = 0;
   msg_arr = XNMALLOC (mlp->nitems, struct pre_message);
   n_sysdep_strings = 0;
@@ -181,20 +637,33 @@ write_table (FILE *output_file, message_list_ty *mlp)
     {
       message_ty *mp = mlp->item[j];
       size_t msgctlen;
-      char *msgctid;
+      size_t msgctid_len;
+      const char *id_plural;
+      size_t id_plural_len;
       struct interval *intervals[2];
       size_t nintervals[2];
 
-      /* Concatenate mp->msgctxt and mp->msgid into msgctid.  */
+      /* Concatenate mp->msgctxt and mp->msgid into msgctid, and append a
+         copy of mp->msgid_plural.  */
       msgctlen = (mp->msgctxt != NULL ? strlen (mp->msgctxt) + 1 : 0);
-      msgctid = XNMALLOC (msgctlen + strlen (mp->msgid) + 1, char);
       if (mp->msgctxt != NULL)
         {
           memcpy (msgctid, mp->msgctxt, msgctlen - 1);
           msgctid[msgctlen - 1] = MSGCTXT_SEPARATOR;
         }
       strcpy (msgctid + msgctlen, mp->msgid);
-      msgctid_arr[j] = msgctid;
+      msgctid_len = msgctlen + strlen (mp->msgid) + 1;
+      if (mp->msgid_plural != NULL)
+        {
+          id_plural = msgctid + msgctid_len;
+          id_plural_len = strlen (mp->msgid_plural) + 1;
+          memcpy (msgctid + msgctid_len, mp->msgid_plural, id_plural_len);
+        }
+      else
+        {
+          id_plural = NULL;
+          id_plural_len = 0;
+        }
 
       intervals[M_ID] = NULL;
       nintervals[M_ID] = 0;
@@ -280,7 +749,7 @@ write_table (FILE *output_file, message_list_ty *mlp)
               if (m == M_ID)
                 {
                   str = msgctid; /* concatenation of mp->msgctxt + mp->msgid  */
-                  str_len = strlen (msgctid) + 1;
+                  str_len = msgctid_len;
                 }
               else
                 {
@@ -340,33 +809,88 @@ write_table (FILE *output_file, message_list_ty *mlp)
               sysdep_msg_arr[n_sysdep_strings].str[m] = pre;
             }
 
-          sysdep_msg_arr[n_sysdep_strings].id_plural = mp->msgid_plural;
-          sysdep_msg_arr[n_sysdep_strings].id_plural_len =
-            (mp->msgid_plural != NULL ? strlen (mp->msgid_plural) + 1 : 0);
+          sysdep_msg_arr[n_sysdep_strings].id_plural = id_plural;
+          sysdep_msg_arr[n_sysdep_strings].id_plural_len = id_plural_len;
           n_sysdep_strings++;
         }
       else
         {
           /* Static string pair.  */
           msg_arr[nstrings].str[M_ID].pointer = msgctid;
-          msg_arr[nstrings].str[M_ID].length = strlen (msgctid) + 1;
+          msg_arr[nstrings].str[M_ID].length = msgctid_len;
           msg_arr[nstrings].str[M_STR].pointer = mp->msgstr;
           msg_arr[nstrings].str[M_STR].length = mp->msgstr_len;
-          msg_arr[nstrings].id_plural = mp->msgid_plural;
-          msg_arr[nstrings].id_plural_len =
-            (mp->msgid_plural != NULL ? strlen (mp->msgid_plural) + 1 : 0);
+          msg_arr[nstrings].id_plural = id_plural;
+          msg_arr[nstrings].id_plural_len = id_plural_len;
           nstrings++;
         }
 
       for (m = 0; m < 2; m++)
         if (intervals[m] != NULL)
           free (intervals[m]);
+
+      msgctid += msgctid_len + id_plural_len;
     }
 
   /* Sort the table according to original string.  */
   if (nstrings > 0)
     qsort (msg_arr, nstrings, sizeof (struct pre_message), compare_id);
 
+  /* Expand the system dependent strings for the segment values of this
+     platform, and append them to the static strings.  libintl uses these
+     expansions instead of computing its own when it finds the same segment
+     values at run time.  */
+  sysdep_values = NULL;
+  n_expanded = 0;
+#if SYSDEP_EXPANSION
+  if (n_sysdep_strings > 0)
+    {
+      sysdep_values = XNMALLOC (n_sysdep_segments, const char *);
+      for (j = 0; j < n_sysdep_segments; j++)
+        sysdep_values[j] =
+          get_sysdep_segment_value (sysdep_segments[j].pointer,
+                                    sysdep_segments[j].length);
+
+      for (j = 0; j < n_sysdep_strings; j++)
+        {
+          struct pre_sysdep_message *msg = &sysdep_msg_arr[j];
+          bool valid = true;
+          unsigned int i;
+
+          /* Like libintl, drop the string pairs that refer to a segment
+             without value.  */
+          for (m = 0; m < 2; m++)
+            for (i = 0; i < msg->str[m]->segmentcount; i++)
+              if (sysdep_values[msg->str[m]->segments[i].sysdepref] == NULL)
+                valid = false;
+
+          if (valid)
+            {
+              struct pre_message *expanded = &msg_arr[nstrings + n_expanded];
+
+              for (m = 0; m < 2; m++)
+                expanded->str[m].pointer =
+                  expand_sysdep_string (msg->str[m], sysdep_values,
+                                        (m == M_ID ? msg->id_plural_len : 0),
+                                        &expanded->str[m].length);
+              expanded->id_plural_len = msg->id_plural_len;
+              if (msg->id_plural_len > 0)
+                {
+                  char *id_plural =
+                    (char *) expanded->str[M_ID].pointer
+                    + expanded->str[M_ID].length;
+
+                  memcpy (id_plural, msg->id_plural, msg->id_plural_len);
+                  expanded->id_plural = id_plural;
+                }
+              else
+                expanded->id_plural = NULL;
+              n_expanded++;
+            }
+        }
+    }
+#endif
+
   /* We need major revision 1 if there are system dependent strings that use
      "I" because older versions of gettext() crash when this occurs in a .mo
      file.  Otherwise use major revision 0.  */
@@ -375,8 +899,10 @@ write_table (FILE *output_file, message_list_ty *mlp)
 
   /* We need minor revision 1 if there are system dependent strings.
      Otherwise we choose minor revision 0 because it's supported by older
-     versions of libintl and revision 1 isn't.  */
-  minor_revision = (n_sysdep_strings > 0 ? 1 : 0);
+     versions of libintl and revision 1 isn't.  Minor revision 2 adds the
+     expanded system dependent strings; older versions of libintl treat it
+     like minor revision 1.  */
+  minor_revision = (n_expanded > 0 ? 2 : n_sysdep_strings > 0 ? 1 : 0);
 
   /* In minor revision >= 1, the hash table is obligatory.  */
   omit_hash_table = (no_hash_table && minor_revision == 0);
@@ -423,21 +949,24 @@ write_table (FILE *output_file, message_list_ty *mlp)
   header_size =
     (minor_revision == 0
      ? offsetof (struct mo_file_header, n_sysdep_segments)
+     : minor_revision == 1
+     ? offsetof (struct mo_file_header, n_expanded_sysdep_strings)
      : sizeof (struct mo_file_header));
   offset = header_size;
 
   /* Number of static string pairs.  */
   header.nstrings = nstrings;
 
-  /* Offset of table for original string offsets.  */
+  /* Offset of table for original string offsets.  The expanded system
+     dependent strings follow the static strings.  */
   header.orig_tab_offset = offset;
-  offset += nstrings * sizeof (struct string_desc);
-  orig_tab = XNMALLOC (nstrings, struct string_desc);
+  offset += (nstrings + n_expanded) * sizeof (struct string_desc);
+  orig_tab = XNMALLOC (nstrings + n_expanded, struct string_desc);
 
   /* Offset of table for translated string offsets.  */
   header.trans_tab_offset = offset;
-  offset += nstrings * sizeof (struct string_desc);
-  trans_tab = XNMALLOC (nstrings, struct string_desc);
+  offset += (nstrings + n_expanded) * sizeof (struct string_desc);
+  trans_tab = XNMALLOC (nstrings + n_expanded, struct string_desc);
 
   /* Size of hash table.  */
   header.hash_tab_size = hash_tab_size;
@@ -473,11 +1002,52 @@ write_table (FILE *output_file, message_list_ty *mlp)
                       * sizeof (struct segment_pair);
     }
 
+  if (minor_revision >= 2)
+    {
+      /* Number of expanded system dependent string pairs.  */
+      header.n_expanded_sysdep_strings = n_expanded;
+
+      /* Offset of table with the segment values of the expansion.  */
+      header.sysdep_values_offset = offset;
+      offset += n_sysdep_segments * sizeof (struct sysdep_segment);
+
+      /* Offset of hash table including the expanded strings.  */
+      header.expanded_hash_tab_offset = offset;
+      offset += hash_tab_size * sizeof (nls_uint32);
+    }
+
   end_offset = offset;
 
+  /* Lay out the string section.  By default, the original strings come
+     first, then the translated strings.  */
+  pool = XNMALLOC (2 * (nstrings + n_expanded), struct pool_string);
+  for (j = 0; j < nstrings + n_expanded; j++)
+    {
+      pool[j].pointer = msg_arr[j].str[M_ID].pointer;
+      pool[j].length = msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+      pool[nstrings + n_expanded + j].pointer = msg_arr[j].str[M_STR].pointer;
+      pool[nstrings + n_expanded + j].length = msg_arr[j].str[M_STR].length;
+    }
+  share_pool_strings (pool, 2 * (nstrings + n_expanded));
+  order =
+    (string_order != mo_string_order_msgid || string_order_profile != NULL
+     ? compute_string_order (msg_arr, nstrings, n_expanded, hash_tab_size)
+     : NULL);
+  stored = XNMALLOC (2 * (nstrings + n_expanded), struct pool_string *);
+  offset = layout_pool_strings (pool, 2 * (nstrings + n_expanded), order,
+                                end_offset, stored, &nstored);
+  free (order);
+
 
   /* Third pass: Write the non-string parts of the file.  At the same time,
-     compute the offsets of each string, including the proper alignment.  */
+     compute the offsets of the remaining strings, including the proper
+     alignment.  The whole file is built in memory.  */
+
+  /* The system dependent strings, if any, make the file a bit larger than
+     OFFSET.  */
+  image.allocated = offset + 4096;
+  image.data = XNMALLOC (image.allocated, char);
+  image.length = 0;
 
   /* Write the header out.  */
   if (byteswap)
@@ -497,49 +1067,52 @@ write_table (FILE *output_file, message_list_ty *mlp)
           BSWAP32 (header.orig_sysdep_tab_offset);
           BSWAP32 (header.trans_sysdep_tab_offset);
         }
+      if (minor_revision >= 2)
+        {
+          BSWAP32 (header.n_expanded_sysdep_strings);
+          BSWAP32 (header.sysdep_values_offset);
+          BSWAP32 (header.expanded_hash_tab_offset);
+        }
     }
-  fwrite (&header, header_size, 1, output_file);
+  image_append (&image, &header, header_size);
 
   /* Table for original string offsets.  */
-  /* Here output_file is at position header.orig_tab_offset.  */
+  /* Here the image is at position header.orig_tab_offset.  */
 
-  for (j = 0; j < nstrings; j++)
+  for (j = 0; j < nstrings + n_expanded; j++)
     {
-      offset = roundup (offset, alignment);
-      orig_tab[j].length =
-        msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
-      orig_tab[j].offset = offset;
-      offset += orig_tab[j].length;
+      orig_tab[j].length = pool[j].length;
+      orig_tab[j].offset = pool[j].offset;
       /* Subtract 1 because of the terminating NUL.  */
       orig_tab[j].length--;
     }
   if (byteswap)
-    for (j = 0; j < nstrings; j++)
+    for (j = 0; j < nstrings + n_expanded; j++)
       {
         BSWAP32 (orig_tab[j].length);
         BSWAP32 (orig_tab[j].offset);
       }
-  fwrite (orig_tab, nstrings * sizeof (struct string_desc), 1, output_file);
+  image_append (&image, orig_tab,
+                (nstrings + n_expanded) * sizeof (struct string_desc));
 
   /* Table for translated string offsets.  */
-  /* Here output_file is at position header.trans_tab_offset.  */
+  /* Here the image is at position header.trans_tab_offset.  */
 
-  for (j = 0; j < nstrings; j++)
+  for (j = 0; j < nstrings + n_expanded; j++)
     {
-      offset = roundup (offset, alignment);
-      trans_tab[j].length = msg_arr[j].str[M_STR].length;
-      trans_tab[j].offset = offset;
-      offset += trans_tab[j].length;
+      trans_tab[j].length = pool[nstrings + n_expanded + j].length;
+      trans_tab[j].offset = pool[nstrings + n_expanded + j].offset;
       /* Subtract 1 because of the terminating NUL.  */
       trans_tab[j].length--;
     }
   if (byteswap)
-    for (j = 0; j < nstrings; j++)
+    for (j = 0; j < nstrings + n_expanded; j++)
       {
         BSWAP32 (trans_tab[j].length);
         BSWAP32 (trans_tab[j].offset);
       }
-  fwrite (trans_tab, nstrings * sizeof (struct string_desc), 1, output_file);
+  image_append (&image, trans_tab,
+                (nstrings + n_expanded) * sizeof (struct string_desc));
 
   /* Skip this part when no hash table is needed.  */
   if (!omit_hash_table)
@@ -547,40 +1120,20 @@ write_table (FILE *output_file, message_list_ty *mlp)
       nls_uint32 *hash_tab;
       unsigned int j;
 
-      /* Here output_file is at position header.hash_tab_offset.  */
+      /* Here the image is at position header.hash_tab_offset.  */
 
       /* Allocate room for the hashing table to be written out.  */
       hash_tab = XNMALLOC (hash_tab_size, nls_uint32);
-      memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
 
       /* Insert all value in the hash table, following the algorithm described
          above.  */
-      for (j = 0; j < nstrings; j++)
-        {
-          nls_uint32 hash_val = hash_string (msg_arr[j].str[M_ID].pointer);
-          nls_uint32 idx = hash_val % hash_tab_size;
-
-          if (hash_tab[idx] != 0)
-            {
-              /* We need the second hashing function.  */
-              nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
-
-              do
-                if (idx >= hash_tab_size - incr)
-                  idx -= hash_tab_size - incr;
-                else
-                  idx += incr;
-              while (hash_tab[idx] != 0);
-            }
-
-          hash_tab[idx] = j + 1;
-        }
+      fill_hash_table (hash_tab, hash_tab_size, msg_arr, nstrings);
 
       /* Write the hash table out.  */
       if (byteswap)
         for (j = 0; j < hash_tab_size; j++)
           BSWAP32 (hash_tab[j]);
-      fwrite (hash_tab, hash_tab_size * sizeof (nls_uint32), 1, output_file);
+      image_append (&image, hash_tab, hash_tab_size * sizeof (nls_uint32));
 
       free (hash_tab);
     }
@@ -592,7 +1145,7 @@ write_table (FILE *output_file, message_list_ty *mlp)
       size_t stoffset;
       unsigned int i;
 
-      /* Here output_file is at position header.sysdep_segments_offset.  */
+      /* Here the image is at position header.sysdep_segments_offset.  */
 
       sysdep_segments_tab =
         XNMALLOC (n_sysdep_segments, struct sysdep_segment);
@@ -611,9 +1164,8 @@ write_table (FILE *output_file, message_list_ty *mlp)
             BSWAP32 (sysdep_segments_tab[i].length);
             BSWAP32 (sysdep_segments_tab[i].offset);
           }
-      fwrite (sysdep_segments_tab,
-              n_sysdep_segments * sizeof (struct sysdep_segment), 1,
-              output_file);
+      image_append (&image, sysdep_segments_tab,
+                    n_sysdep_segments * sizeof (struct sysdep_segment));
 
       free (sysdep_segments_tab);
 
@@ -622,7 +1174,7 @@ write_table (FILE *output_file, message_list_ty *mlp)
 
       for (m = 0; m < 2; m++)
         {
-          /* Here output_file is at position
+          /* Here the image is at position
              m == M_ID  -> header.orig_sysdep_tab_offset,
              m == M_STR -> header.trans_sysdep_tab_offset.  */
 
@@ -637,13 +1189,13 @@ write_table (FILE *output_file, message_list_ty *mlp)
           if (byteswap)
             for (j = 0; j < n_sysdep_strings; j++)
               BSWAP32 (sysdep_tab[j]);
-          fwrite (sysdep_tab, n_sysdep_strings * sizeof (nls_uint32), 1,
-                  output_file);
+          image_append (&image, sysdep_tab,
+                        n_sysdep_strings * sizeof (nls_uint32));
         }
 
       free (sysdep_tab);
 
-      /* Here output_file is at position sysdep_tab_offset.  */
+      /* Here the image is at position sysdep_tab_offset.  */
 
       for (m = 0; m < 2; m++)
         for (j = 0; j < n_sysdep_strings; j++)
@@ -678,52 +1230,76 @@ write_table (FILE *output_file, message_list_ty *mlp)
                     BSWAP32 (str->segments[i].sysdepref);
                   }
               }
-            fwrite (str,
-                    sizeof (struct sysdep_string)
-                    + pre->segmentcount * sizeof (struct segment_pair),
-                    1, output_file);
+            image_append (&image, str,
+                          sizeof (struct sysdep_string)
+                          + pre->segmentcount * sizeof (struct segment_pair));
 
             freea (str);
           }
     }
 
-  /* Here output_file is at position end_offset.  */
+  if (minor_revision >= 2)
+    {
+      struct sysdep_segment *sysdep_values_tab;
+      nls_uint32 *hash_tab;
+      unsigned int i;
 
-  free (trans_tab);
-  free (orig_tab);
+      /* Here the image is at position header.sysdep_values_offset.  */
 
+      sysdep_values_tab =
+        XNMALLOC (n_sysdep_segments, struct sysdep_segment);
+      for (i = 0; i < n_sysdep_segments; i++)
+        if (sysdep_values[i] != NULL)
+          {
+            offset = roundup (offset, alignment);
+            /* The "+ 1" accounts for the trailing NUL byte.  */
+            sysdep_values_tab[i].length = strlen (sysdep_values[i]) + 1;
+            sysdep_values_tab[i].offset = offset;
+            offset += sysdep_values_tab[i].length;
+          }
+        else
+          {
+            sysdep_values_tab[i].length = 0;
+            sysdep_values_tab[i].offset = 0;
+          }
 
-  /* Fourth pass: Write the strings.  */
+      if (byteswap)
+        for (i = 0; i < n_sysdep_segments; i++)
+          {
+            BSWAP32 (sysdep_values_tab[i].length);
+            BSWAP32 (sysdep_values_tab[i].offset);
+          }
+      image_append (&image, sysdep_values_tab,
+                    n_sysdep_segments * sizeof (struct sysdep_segment));
 
-  offset = end_offset;
+      free (sysdep_values_tab);
 
-  /* A few zero bytes for padding.  */
-  null = (char *) alloca (alignment);
-  memset (null, '\0', alignment);
+      /* Here the image is at position header.expanded_hash_tab_offset.  */
 
-  /* Now write the original strings.  */
-  for (j = 0; j < nstrings; j++)
-    {
-      fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
-      offset = roundup (offset, alignment);
+      hash_tab = XNMALLOC (hash_tab_size, nls_uint32);
+      fill_hash_table (hash_tab, hash_tab_size,
+                       msg_arr, nstrings + n_expanded);
+      if (byteswap)
+        for (i = 0; i < hash_tab_size; i++)
+          BSWAP32 (hash_tab[i]);
+      image_append (&image, hash_tab, hash_tab_size * sizeof (nls_uint32));
 
-      fwrite (msg_arr[j].str[M_ID].pointer, msg_arr[j].str[M_ID].length, 1,
-              output_file);
-      if (msg_arr[j].id_plural_len > 0)
-        fwrite (msg_arr[j].id_plural, msg_arr[j].id_plural_len, 1,
-                output_file);
-      offset += msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+      free (hash_tab);
     }
 
-  /* Now write the translated strings.  */
-  for (j = 0; j < nstrings; j++)
-    {
-      fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
-      offset = roundup (offset, alignment);
+  /* Here the image is at position end_offset.  */
 
-      fwrite (msg_arr[j].str[M_STR].pointer, msg_arr[j].str[M_STR].length, 1,
-              output_file);
-      offset += msg_arr[j].str[M_STR].length;
+  free (trans_tab);
+  free (orig_tab);
+
+
+  /* Fourth pass: Write the strings.  */
+
+  /* Now write the original and translated strings.  */
+  for (j = 0; j < nstored; j++)
+    {
+      image_pad (&image, stored[j]->offset);
+      image_append (&image, stored[j]->pointer, stored[j]->length);
     }
 
   if (minor_revision >= 1)
@@ -732,13 +1308,10 @@ write_table (FILE *output_file, message_list_ty *mlp)
 
       for (i = 0; i < n_sysdep_segments; i++)
         {
-          fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
-          offset = roundup (offset, alignment);
-
-          fwrite (sysdep_segments[i].pointer, sysdep_segments[i].length, 1,
-                  output_file);
-          fwrite (null, 1, 1, output_file);
-          offset += sysdep_segments[i].length + 1;
+          image_pad (&image, roundup (image.length, alignment));
+          image_append (&image, sysdep_segments[i].pointer,
+                        sysdep_segments[i].length);
+          image_pad (&image, image.length + 1);
         }
 
       for (m = 0; m < 2; m++)
@@ -747,32 +1320,46 @@ write_table (FILE *output_file, message_list_ty *mlp)
             struct pre_sysdep_message *msg = &sysdep_msg_arr[j];
             struct pre_sysdep_string *pre = msg->str[m];
 
-            fwrite (null, roundup (offset, alignment) - offset, 1,
-                    output_file);
-            offset = roundup (offset, alignment);
+            image_pad (&image, roundup (image.length, alignment));
 
             for (i = 0; i <= pre->segmentcount; i++)
-              {
-                fwrite (pre->segments[i].segptr, pre->segments[i].segsize, 1,
-                        output_file);
-                offset += pre->segments[i].segsize;
-              }
+              image_append (&image, pre->segments[i].segptr,
+                            pre->segments[i].segsize);
             if (m == M_ID && msg->id_plural_len > 0)
-              {
-                fwrite (msg->id_plural, msg->id_plural_len, 1, output_file);
-                offset += msg->id_plural_len;
-              }
+              image_append (&image, msg->id_plural, msg->id_plural_len);
 
             free (pre);
           }
     }
 
-  freea (null);
-  for (j = 0; j < mlp->nitems; j++)
-    free (msgctid_arr[j]);
+  if (minor_revision >= 2)
+    {
+      unsigned int i;
+
+      for (i = 0; i < n_sysdep_segments; i++)
+        if (sysdep_values[i] != NULL)
+          {
+            image_pad (&image, roundup (image.length, alignment));
+            image_append (&image, sysdep_values[i],
+                          strlen (sysdep_values[i]) + 1);
+          }
+    }
+
+  /* Write the file with a single call.  */
+  fwrite (image.data, image.length, 1, output_file);
+
+  free (image.data);
+  free (stored);
+  free (pool);
+  for (j = nstrings; j < nstrings + n_expanded; j++)
+    {
+      free ((char *) msg_arr[j].str[M_ID].pointer);
+      free ((char *) msg_arr[j].str[M_STR].pointer);
+    }
+  free (sysdep_values);
   free (sysdep_msg_arr);
   free (msg_arr);
-  free (msgctid_arr);
+  free (msgctids);
 }
 
 
@@ -815,3 +1402,114 @@ msgdomain_write_mo (message_list_ty *mlp,
 
   return 0;
 }
+
+
+/* Domain names of the bundle being written, for compare_bundle_domain.  */
+static const char **bundle_domain_names;
+
+/* Compare two domains of a bundle by name.  */
+static int
+compare_bundle_domain (const void *pval1, const void *pval2)
+{
+  return strcmp (bundle_domain_names[*(const size_t *) pval1],
+                 bundle_domain_names[*(const size_t *) pval2]);
+}
+
+int
+msgdomain_write_mo_bundle (size_t ndomains,
+                           message_list_ty **mlps,
+                           const char **domain_names,
+                           const char *file_name)
+{
+  FILE *output_file;
+  size_t *order;
+  size_t nentries;
+  struct mo_bundle_header header;
+  struct mo_bundle_entry *entries;
+  size_t offset;
+  size_t i;
+  static const char null[8];
+
+  /* Select the non-empty domains and sort them by name, so that the
+     runtime can use a binary search.  */
+  order = XNMALLOC (ndomains, size_t);
+  nentries = 0;
+  for (i = 0; i < ndomains; i++)
+    if (mlps[i]->nitems != 0)
+      order[nentries++] = i;
+  bundle_domain_names = domain_names;
+  qsort (order, nentries, sizeof (size_t), compare_bundle_domain);
+
+  output_file = fopen (file_name, "wb");
+  if (output_file == NULL)
+    {
+      error (0, errno, _("error while opening \"%s\" for writing"),
+             file_name);
+      free (order);
+      return 1;
+    }
+
+  /* Write the header, the table of entries and the domain names.  The
+     lengths and offsets of the catalogs are filled in later.  */
+  header.magic = _MAGIC_BUNDLE;
+  header.revision = MO_BUNDLE_REVISION_NUMBER;
+  header.nentries = nentries;
+  header.entries_offset = sizeof (struct mo_bundle_header);
+  entries = XNMALLOC (nentries, struct mo_bundle_entry);
+  offset = header.entries_offset + nentries * sizeof (struct mo_bundle_entry);
+  for (i = 0; i < nentries; i++)
+    {
+      entries[i].name_length = strlen (domain_names[order[i]]);
+      entries[i].name_offset = offset;
+      offset += entries[i].name_length + 1;
+    }
+  if (byteswap)
+    {
+      BSWAP32 (header.magic);
+      BSWAP32 (header.revision);
+      BSWAP32 (header.nentries);
+      BSWAP32 (header.entries_offset);
+    }
+  fwrite (&header, sizeof (header), 1, output_file);
+  fwrite (entries, sizeof (struct mo_bundle_entry), nentries, output_file);
+  for (i = 0; i < nentries; i++)
+    fwrite (domain_names[order[i]], strlen (domain_names[order[i]]) + 1, 1,
+            output_file);
+
+  /* Write the catalogs, each starting at a multiple of 8.  */
+  for (i = 0; i < nentries; i++)
+    {
+      long start;
+
+      fwrite (null, roundup (offset, 8) - offset, 1, output_file);
+      start = ftell (output_file);
+      write_table (output_file, mlps[order[i]]);
+      offset = ftell (output_file);
+      entries[i].offset = start;
+      entries[i].length = offset - start;
+    }
+
+  /* Fill in the table of entries.  */
+  if (byteswap)
+    for (i = 0; i < nentries; i++)
+      {
+        BSWAP32 (entries[i].name_length);
+        BSWAP32 (entries[i].name_offset);
+        BSWAP32 (entries[i].length);
+        BSWAP32 (entries[i].offset);
+      }
+  if (fseek (output_file, sizeof (struct mo_bundle_header), SEEK_SET) == 0)
+    fwrite (entries, sizeof (struct mo_bundle_entry), nentries, output_file);
+  else
+    error (EXIT_FAILURE, errno, _("error while writing \"%s\" file"),
+           file_name);
+
+  /* Make sure nothing went wrong.  */
+  if (fwriteerror (output_file))
+    error (EXIT_FAILURE, errno, _("error while writing \"%s\" file"),
+           file_name);
+
+  free (entries);
+  free (order);
+  return 0;
+}
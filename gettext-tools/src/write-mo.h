@@ -32,6 +32,24 @@ extern bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 extern bool no_hash_table;
 
+/* True if a string that is the tail of another string shall be stored as
+   part of that string.  */
+extern bool merge_suffixes;
+
+/* Order of the strings in the resulting .mo file.  */
+enum mo_string_order
+{
+  mo_string_order_msgid,        /* All original strings in msgid order, then
+                                   all translated strings.  */
+  mo_string_order_hash          /* Each original string followed by its
+                                   translation, in hash table order.  */
+};
+extern enum mo_string_order string_order;
+
+/* If not NULL, the messages whose strings are placed first, each original
+   string followed by its translation, in this order.  */
+extern message_list_ty *string_order_profile;
+
 /* Write a GNU mo file.  mlp is a list containing the messages to be output.
    domain_name is the domain name, file_name is the desired file name.
    Return 0 if ok, nonzero on error.  */
@@ -40,4 +58,14 @@ extern int
                            const char *domain_name,
                            const char *file_name);
 
+/* Write a bundle of GNU mo files.  mlps[0..ndomains-1] are the lists of
+   messages of the domains domain_names[0..ndomains-1].  Domains without
+   messages are omitted.  file_name is the desired file name.
+   Return 0 if ok, nonzero on error.  */
+extern int
+       msgdomain_write_mo_bundle (size_t ndomains,
+                                  message_list_ty **mlps,
+                                  const char **domain_names,
+                                  const char *file_name);
+
 #endif /* _WRITE_MO_H */
@@ -34,6 +34,10 @@
 # include <iconv.h>
 #endif
 
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
 #include "c-ctype.h"
 #include "po-charset.h"
 #include "format.h"
@@ -44,6 +48,7 @@
 #include "xmalloca.h"
 #include "c-strstr.h"
 #include "ostream.h"
+#include "memory-ostream.h"
 #ifdef GETTEXTDATADIR
 # include "styled-ostream.h"
 #endif
@@ -71,6 +76,9 @@ make_format_description_string (enum is_format is_format, const char *lang,
                                 bool debug)
 {
   static char result[100];
+#ifdef _OPENMP
+# pragma omp threadprivate (result)
+#endif
 
   switch (is_format)
     {
@@ -234,6 +242,82 @@ enum
 };
 
 
+/* ============================ Error reports. ============================= */
+
+
+/* When the messages are formatted on several threads, the problems found
+   are reported later, in the order of the messages.  */
+struct print_report
+{
+  int severity;
+  const message_ty *message;
+  int multiline_p;
+  char *message_text;
+};
+
+struct print_report_list
+{
+  struct print_report *item;
+  size_t nitems;
+  size_t nitems_max;
+};
+
+/* Where the reports of the current thread go, or NULL if they are output
+   immediately.  */
+static struct print_report_list *deferred_reports;
+#ifdef _OPENMP
+# pragma omp threadprivate (deferred_reports)
+#endif
+
+/* Signal a problem with MESSAGE, like po_xerror.  */
+static void
+print_xerror (int severity, const message_ty *message,
+              int multiline_p, const char *message_text)
+{
+  if (deferred_reports != NULL)
+    {
+      struct print_report_list *list = deferred_reports;
+      struct print_report *report;
+
+      if (list->nitems == list->nitems_max)
+        {
+          list->nitems_max = 2 * list->nitems_max + 1;
+          list->item =
+            (struct print_report *)
+            xrealloc (list->item,
+                      list->nitems_max * sizeof (struct print_report));
+        }
+      report = &list->item[list->nitems++];
+      report->severity = severity;
+      report->message = message;
+      report->multiline_p = multiline_p;
+      report->message_text = xstrdup (message_text);
+    }
+  else
+    po_xerror (severity, message, NULL, 0, 0, multiline_p, message_text);
+}
+
+/* Output the reports collected in LIST, and free them.  */
+static void
+print_report_flush (struct print_report_list *list)
+{
+  size_t i;
+
+  for (i = 0; i < list->nitems; i++)
+    {
+      struct print_report *report = &list->item[i];
+
+      po_xerror (report->severity, report->message, NULL, 0, 0,
+                 report->multiline_p, report->message_text);
+      free (report->message_text);
+    }
+  free (list->item);
+  list->item = NULL;
+  list->nitems = 0;
+  list->nitems_max = 0;
+}
+
+
 /* ================ Output parts of a message, as comments. ================ */
 
 
@@ -540,6 +624,53 @@ memset_small (void *dst, char c, size_t n)
 }
 
 
+/* Test whether C is a printable ASCII character that is output unchanged
+   in a string, i.e. without an escape sequence.  */
+#define is_plain_ascii(c) \
+  ((unsigned char) (c) >= 0x20 && (unsigned char) (c) < 0x7f \
+   && (c) != '"' && (c) != '\\')
+
+/* Return the number of bytes at the beginning of [S, S_END) that satisfy
+   is_plain_ascii.  In an ASCII compatible encoding each of these bytes is a
+   complete character that occupies one column.  The bytes are examined a
+   word at a time, like in gnulib's memchr.  */
+static size_t
+plain_ascii_span (const char *s, const char *s_end)
+{
+  typedef unsigned long int longword;
+  const longword ones = (longword) -1 / 0xff;   /* 0x0101...01 */
+  const longword highs = ones << 7;             /* 0x8080...80 */
+  const char *p = s;
+
+  while ((size_t) (s_end - p) >= sizeof (longword))
+    {
+      longword w;
+      longword x;
+      longword y;
+
+      memcpy (&w, p, sizeof (longword));
+      /* A byte of w is not plain if it is >= 0x80, < 0x20, == 0x7f,
+         == '"' or == '\\'.  Each test sets the high bit of the byte in
+         question; bytes above a match may be flagged as well, but never a
+         word without a match.  */
+      x = (w - ones * 0x20) & ~w;
+      y = w ^ (ones * 0x7f);
+      x |= (y - ones) & ~y;
+      y = w ^ (ones * '"');
+      x |= (y - ones) & ~y;
+      y = w ^ (ones * '\\');
+      x |= (y - ones) & ~y;
+      if (((x | w) & highs) != 0)
+        break;
+      p += sizeof (longword);
+    }
+  while (p < s_end && is_plain_ascii (*p))
+    p++;
+
+  return p - s;
+}
+
+
 static void
 wrap (const message_ty *mp, ostream_t stream,
       const char *line_prefix, int extra_indent, const char *css_class,
@@ -557,6 +688,7 @@ wrap (const message_ty *mp, ostream_t stream,
   iconv_t conv;
 #endif
   bool weird_cjk;
+  bool plain_ascii_widths;
 
   canon_charset = po_charset_canonicalize (charset);
 
@@ -610,6 +742,12 @@ wrap (const message_ty *mp, ostream_t stream,
   if (canon_charset == NULL)
     canon_charset = po_charset_ascii;
 
+  /* In the encodings with CJK structure, like SHIFT_JIS, the conversion
+     done by ulc_width_linebreaks may turn '~' into a double-width character.
+     In all other encodings, a printable ASCII character occupies one
+     column.  */
+  plain_ascii_widths = !po_is_charset_weird_cjk (canon_charset);
+
   /* Determine the extent of format string directives.  */
   fmtdir = NULL;
   fmtdirattr = NULL;
@@ -686,6 +824,7 @@ wrap (const message_ty *mp, ostream_t stream,
       char *pp;
       char *op;
       char *ap;
+      bool plain;
       int startcol, startcol_after_break, width;
       size_t i;
 
@@ -697,7 +836,13 @@ wrap (const message_ty *mp, ostream_t stream,
       for (ep = s, portion_len = 0; ep < es; ep++)
         {
           char c = *ep;
-          if (is_escape (c))
+          if (is_plain_ascii (c))
+            {
+              size_t n = plain_ascii_span (ep, es);
+              portion_len += n;
+              ep += n - 1;
+            }
+          else if (is_escape (c))
             portion_len += 2;
           else if (escape && !c_isprint ((unsigned char) c))
             portion_len += 4;
@@ -736,8 +881,8 @@ wrap (const message_ty *mp, ostream_t stream,
                     {
                       if (errno == EILSEQ)
                         {
-                          po_xerror (PO_SEVERITY_ERROR, mp, NULL, 0, 0, false,
-                                     _("invalid multibyte sequence"));
+                          print_xerror (PO_SEVERITY_ERROR, mp, false,
+                                        _("invalid multibyte sequence"));
                           continue;
                         }
                       else
@@ -767,6 +912,9 @@ wrap (const message_ty *mp, ostream_t stream,
       portion = XNMALLOC (portion_len, char);
       overrides = XNMALLOC (portion_len, char);
       attributes = XNMALLOC (portion_len, char);
+      /* PLAIN tells whether the portion consists only of printable ASCII
+         characters.  */
+      plain = true;
       for (ep = s, pp = portion, op = overrides, ap = attributes; ep < es; ep++)
         {
           char c = *ep;
@@ -776,7 +924,39 @@ wrap (const message_ty *mp, ostream_t stream,
           if (attr == ATTR_FORMAT_DIRECTIVE
               && (fmtdir[ep - value] & FMTDIR_START) == 0)
             brk = UC_BREAK_PROHIBITED;
-          if (is_escape (c))
+          if (is_plain_ascii (c))
+            {
+              /* Copy a run of characters that need no escaping.  */
+              size_t n = plain_ascii_span (ep, es);
+
+              memcpy (pp, ep, n);
+              pp += n;
+              if (fmtdirattr != NULL)
+                {
+                  size_t j;
+
+                  *op++ = brk;
+                  *ap++ = attr;
+                  for (j = ep - value + 1; j < ep - value + n; j++)
+                    {
+                      attr = fmtdirattr[j];
+                      *op++ = (attr == ATTR_FORMAT_DIRECTIVE
+                               && (fmtdir[j] & FMTDIR_START) == 0
+                               ? UC_BREAK_PROHIBITED
+                               : UC_BREAK_UNDEFINED);
+                      *ap++ = attr;
+                    }
+                }
+              else
+                {
+                  memset (op, UC_BREAK_UNDEFINED, n);
+                  op += n;
+                  memset (ap, 0, n);
+                  ap += n;
+                }
+              ep += n - 1;
+            }
+          else if (is_escape (c))
             {
               switch (c)
                 {
@@ -803,8 +983,7 @@ wrap (const message_ty *mp, ostream_t stream,
                     xasprintf (_("\
 internationalized messages should not contain the '\\%c' escape sequence"),
                                c);
-                  po_xerror (PO_SEVERITY_WARNING, mp, NULL, 0, 0, false,
-                             error_message);
+                  print_xerror (PO_SEVERITY_WARNING, mp, false, error_message);
                   free (error_message);
                 }
             }
@@ -834,6 +1013,7 @@ internationalized messages should not contain the '\\%c' escape sequence"),
             }
           else
             {
+              plain = false;
 #if HAVE_ICONV
               if (conv != (iconv_t)(-1))
                 {
@@ -865,8 +1045,8 @@ internationalized messages should not contain the '\\%c' escape sequence"),
                     {
                       if (errno == EILSEQ)
                         {
-                          po_xerror (PO_SEVERITY_ERROR, mp, NULL, 0, 0,
-                                     false, _("invalid multibyte sequence"));
+                          print_xerror (PO_SEVERITY_ERROR, mp, false,
+                                        _("invalid multibyte sequence"));
                           continue;
                         }
                       else
@@ -951,8 +1131,14 @@ internationalized messages should not contain the '\\%c' escape sequence"),
       startcol -= startcol_after_break;
 
       /* Do line breaking on the portion.  */
-      ulc_width_linebreaks (portion, portion_len, width, startcol, 0,
-                            overrides, canon_charset, linebreaks);
+      if (plain && plain_ascii_widths
+          && startcol <= width && portion_len <= (size_t) (width - startcol))
+        /* Every character occupies one column, and the portion fits in the
+           line.  ulc_width_linebreaks would not find a break here.  */
+        memset (linebreaks, UC_BREAK_PROHIBITED, portion_len);
+      else
+        ulc_width_linebreaks (portion, portion_len, width, startcol, 0,
+                              overrides, canon_charset, linebreaks);
 
       /* If this is the first line, and we are not using the indented
          style, and the line would wrap, then use an empty first line
@@ -1027,43 +1213,21 @@ internationalized messages should not contain the '\\%c' escape sequence"),
       }
 
       /* Print the portion itself, with linebreaks where necessary.  */
-      {
-        char currattr = 0;
-
-        begin_css_class (stream, class_string);
-        ostream_write_str (stream, "\"");
-        begin_css_class (stream, class_text);
+      if (!is_stylable (stream))
+        {
+          /* Without styling, the attributes don't matter, and the portion
+             is written in runs from one line break to the next.  */
+          size_t run_start = 0;
 
-        for (i = 0; i < portion_len; i++)
-          {
+          ostream_write_str (stream, "\"");
+          for (i = 0; i < portion_len; i++)
             if (linebreaks[i] == UC_BREAK_POSSIBLE)
               {
                 int currcol;
 
-                /* Change currattr so that it becomes 0.  */
-                if (currattr & ATTR_ESCAPE_SEQUENCE)
-                  {
-                    end_css_class (stream, class_escape_sequence);
-                    currattr &= ~ATTR_ESCAPE_SEQUENCE;
-                  }
-                if (currattr & ATTR_FORMAT_DIRECTIVE)
-                  {
-                    end_css_class (stream, class_format_directive);
-                    currattr &= ~ATTR_FORMAT_DIRECTIVE;
-                  }
-                else if (currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
-                  {
-                    end_css_class (stream, class_invalid_format_directive);
-                    currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
-                  }
-                if (!(currattr == 0))
-                  abort ();
-
-                end_css_class (stream, class_text);
-                ostream_write_str (stream, "\"");
-                end_css_class (stream, class_string);
-                end_css_class (stream, css_class);
-                ostream_write_str (stream, "\n");
+                ostream_write_mem (stream, portion + run_start, i - run_start);
+                run_start = i;
+                ostream_write_str (stream, "\"\n");
                 currcol = 0;
                 /* INDENT-S.  */
                 if (line_prefix != NULL)
@@ -1071,82 +1235,138 @@ internationalized messages should not contain the '\\%c' escape sequence"),
                     ostream_write_str (stream, line_prefix);
                     currcol = strlen (line_prefix);
                   }
-                begin_css_class (stream, css_class);
                 if (indent)
                   {
                     ostream_write_mem (stream, "        ", 8 - (currcol & 7));
                     currcol = (currcol + 8) & ~7;
                   }
-                begin_css_class (stream, class_string);
                 ostream_write_str (stream, "\"");
-                begin_css_class (stream, class_text);
               }
-            /* Change currattr so that it matches attributes[i].  */
-            if (attributes[i] != currattr)
-              {
-                /* class_escape_sequence occurs inside class_format_directive
-                   and class_invalid_format_directive, so clear it first.  */
-                if (currattr & ATTR_ESCAPE_SEQUENCE)
-                  {
-                    end_css_class (stream, class_escape_sequence);
-                    currattr &= ~ATTR_ESCAPE_SEQUENCE;
-                  }
-                if (~attributes[i] & currattr & ATTR_FORMAT_DIRECTIVE)
-                  {
-                    end_css_class (stream, class_format_directive);
-                    currattr &= ~ATTR_FORMAT_DIRECTIVE;
-                  }
-                else if (~attributes[i] & currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
-                  {
-                    end_css_class (stream, class_invalid_format_directive);
-                    currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
-                  }
-                if (attributes[i] & ~currattr & ATTR_FORMAT_DIRECTIVE)
-                  {
-                    begin_css_class (stream, class_format_directive);
-                    currattr |= ATTR_FORMAT_DIRECTIVE;
-                  }
-                else if (attributes[i] & ~currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
-                  {
-                    begin_css_class (stream, class_invalid_format_directive);
-                    currattr |= ATTR_INVALID_FORMAT_DIRECTIVE;
-                  }
-                /* class_escape_sequence occurs inside class_format_directive
-                   and class_invalid_format_directive, so set it last.  */
-                if (attributes[i] & ~currattr & ATTR_ESCAPE_SEQUENCE)
-                  {
-                    begin_css_class (stream, class_escape_sequence);
-                    currattr |= ATTR_ESCAPE_SEQUENCE;
-                  }
-              }
-            ostream_write_mem (stream, &portion[i], 1);
-          }
+          ostream_write_mem (stream, portion + run_start,
+                             portion_len - run_start);
+          ostream_write_str (stream, "\"\n");
+        }
+      else
+        {
+          char currattr = 0;
 
-        /* Change currattr so that it becomes 0.  */
-        if (currattr & ATTR_ESCAPE_SEQUENCE)
-          {
-            end_css_class (stream, class_escape_sequence);
-            currattr &= ~ATTR_ESCAPE_SEQUENCE;
-          }
-        if (currattr & ATTR_FORMAT_DIRECTIVE)
-          {
-            end_css_class (stream, class_format_directive);
-            currattr &= ~ATTR_FORMAT_DIRECTIVE;
-          }
-        else if (currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
-          {
-            end_css_class (stream, class_invalid_format_directive);
-            currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
-          }
-        if (!(currattr == 0))
-          abort ();
-
-        end_css_class (stream, class_text);
-        ostream_write_str (stream, "\"");
-        end_css_class (stream, class_string);
-        end_css_class (stream, css_class);
-        ostream_write_str (stream, "\n");
-      }
+          begin_css_class (stream, class_string);
+          ostream_write_str (stream, "\"");
+          begin_css_class (stream, class_text);
+
+          for (i = 0; i < portion_len; i++)
+            {
+              if (linebreaks[i] == UC_BREAK_POSSIBLE)
+                {
+                  int currcol;
+
+                  /* Change currattr so that it becomes 0.  */
+                  if (currattr & ATTR_ESCAPE_SEQUENCE)
+                    {
+                      end_css_class (stream, class_escape_sequence);
+                      currattr &= ~ATTR_ESCAPE_SEQUENCE;
+                    }
+                  if (currattr & ATTR_FORMAT_DIRECTIVE)
+                    {
+                      end_css_class (stream, class_format_directive);
+                      currattr &= ~ATTR_FORMAT_DIRECTIVE;
+                    }
+                  else if (currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
+                    {
+                      end_css_class (stream, class_invalid_format_directive);
+                      currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
+                    }
+                  if (!(currattr == 0))
+                    abort ();
+
+                  end_css_class (stream, class_text);
+                  ostream_write_str (stream, "\"");
+                  end_css_class (stream, class_string);
+                  end_css_class (stream, css_class);
+                  ostream_write_str (stream, "\n");
+                  currcol = 0;
+                  /* INDENT-S.  */
+                  if (line_prefix != NULL)
+                    {
+                      ostream_write_str (stream, line_prefix);
+                      currcol = strlen (line_prefix);
+                    }
+                  begin_css_class (stream, css_class);
+                  if (indent)
+                    {
+                      ostream_write_mem (stream, "        ", 8 - (currcol & 7));
+                      currcol = (currcol + 8) & ~7;
+                    }
+                  begin_css_class (stream, class_string);
+                  ostream_write_str (stream, "\"");
+                  begin_css_class (stream, class_text);
+                }
+              /* Change currattr so that it matches attributes[i].  */
+              if (attributes[i] != currattr)
+                {
+                  /* class_escape_sequence occurs inside class_format_directive
+                     and class_invalid_format_directive, so clear it first.  */
+                  if (currattr & ATTR_ESCAPE_SEQUENCE)
+                    {
+                      end_css_class (stream, class_escape_sequence);
+                      currattr &= ~ATTR_ESCAPE_SEQUENCE;
+                    }
+                  if (~attributes[i] & currattr & ATTR_FORMAT_DIRECTIVE)
+                    {
+                      end_css_class (stream, class_format_directive);
+                      currattr &= ~ATTR_FORMAT_DIRECTIVE;
+                    }
+                  else if (~attributes[i] & currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
+                    {
+                      end_css_class (stream, class_invalid_format_directive);
+                      currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
+                    }
+                  if (attributes[i] & ~currattr & ATTR_FORMAT_DIRECTIVE)
+                    {
+                      begin_css_class (stream, class_format_directive);
+                      currattr |= ATTR_FORMAT_DIRECTIVE;
+                    }
+                  else if (attributes[i] & ~currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
+                    {
+                      begin_css_class (stream, class_invalid_format_directive);
+                      currattr |= ATTR_INVALID_FORMAT_DIRECTIVE;
+                    }
+                  /* class_escape_sequence occurs inside class_format_directive
+                     and class_invalid_format_directive, so set it last.  */
+                  if (attributes[i] & ~currattr & ATTR_ESCAPE_SEQUENCE)
+                    {
+                      begin_css_class (stream, class_escape_sequence);
+                      currattr |= ATTR_ESCAPE_SEQUENCE;
+                    }
+                }
+              ostream_write_mem (stream, &portion[i], 1);
+            }
+
+          /* Change currattr so that it becomes 0.  */
+          if (currattr & ATTR_ESCAPE_SEQUENCE)
+            {
+              end_css_class (stream, class_escape_sequence);
+              currattr &= ~ATTR_ESCAPE_SEQUENCE;
+            }
+          if (currattr & ATTR_FORMAT_DIRECTIVE)
+            {
+              end_css_class (stream, class_format_directive);
+              currattr &= ~ATTR_FORMAT_DIRECTIVE;
+            }
+          else if (currattr & ATTR_INVALID_FORMAT_DIRECTIVE)
+            {
+              end_css_class (stream, class_invalid_format_directive);
+              currattr &= ~ATTR_INVALID_FORMAT_DIRECTIVE;
+            }
+          if (!(currattr == 0))
+            abort ();
+
+          end_css_class (stream, class_text);
+          ostream_write_str (stream, "\"");
+          end_css_class (stream, class_string);
+          end_css_class (stream, css_class);
+          ostream_write_str (stream, "\n");
+        }
 
       free (linebreaks);
       free (attributes);
@@ -1256,7 +1476,7 @@ The following msgctxt contains non-ASCII characters.\n\
 This will cause problems to translators who use a character encoding\n\
 different from yours. Consider using a pure ASCII msgctxt instead.\n\
 %s\n"), mp->msgctxt);
-      po_xerror (PO_SEVERITY_WARNING, mp, NULL, 0, 0, true, warning_message);
+      print_xerror (PO_SEVERITY_WARNING, mp, true, warning_message);
       free (warning_message);
     }
   if (!is_ascii_string (mp->msgid)
@@ -1268,7 +1488,7 @@ The following msgid contains non-ASCII characters.\n\
 This will cause problems to translators who use a character encoding\n\
 different from yours. Consider using a pure ASCII msgid instead.\n\
 %s\n"), mp->msgid);
-      po_xerror (PO_SEVERITY_WARNING, mp, NULL, 0, 0, true, warning_message);
+      print_xerror (PO_SEVERITY_WARNING, mp, true, warning_message);
       free (warning_message);
     }
   if (mp->msgctxt != NULL)
@@ -1385,7 +1605,7 @@ The following msgctxt contains non-ASCII characters.\n\
 This will cause problems to translators who use a character encoding\n\
 different from yours. Consider using a pure ASCII msgctxt instead.\n\
 %s\n"), mp->msgctxt);
-      po_xerror (PO_SEVERITY_WARNING, mp, NULL, 0, 0, true, warning_message);
+      print_xerror (PO_SEVERITY_WARNING, mp, true, warning_message);
       free (warning_message);
     }
   if (!is_ascii_string (mp->msgid)
@@ -1397,7 +1617,7 @@ The following msgid contains non-ASCII characters.\n\
 This will cause problems to translators who use a character encoding\n\
 different from yours. Consider using a pure ASCII msgid instead.\n\
 %s\n"), mp->msgid);
-      po_xerror (PO_SEVERITY_WARNING, mp, NULL, 0, 0, true, warning_message);
+      print_xerror (PO_SEVERITY_WARNING, mp, true, warning_message);
       free (warning_message);
     }
   if (mp->msgctxt != NULL)
@@ -1432,6 +1652,83 @@ different from yours. Consider using a pure ASCII msgid instead.\n\
 }
 
 
+/* Number of messages that a thread formats at once, when the messages are
+   formatted on several threads.  */
+#define PRINT_BLOCK_SIZE 64
+
+#ifdef _OPENMP
+
+/* Output the messages of MLP, first the non-obsolete ones, then the obsolete
+   ones, like the loops in msgdomain_list_print_po do.  The messages are
+   formatted on several threads, in blocks, into memory buffers; the buffers
+   are copied to STREAM in the order of the messages.  */
+static void
+message_list_print_parallel (message_list_ty *mlp, ostream_t stream,
+                             const char *charset, size_t page_width,
+                             bool blank_line, bool debug)
+{
+  size_t n = mlp->nitems;
+  message_ty **order;
+  size_t i;
+  size_t j;
+  long int nblocks;
+  long int b;
+
+  order = XNMALLOC (n, message_ty *);
+  i = 0;
+  for (j = 0; j < n; j++)
+    if (!mlp->item[j]->obsolete)
+      order[i++] = mlp->item[j];
+  for (j = 0; j < n; j++)
+    if (mlp->item[j]->obsolete)
+      order[i++] = mlp->item[j];
+
+  nblocks = (n + PRINT_BLOCK_SIZE - 1) / PRINT_BLOCK_SIZE;
+
+  #pragma omp parallel for ordered schedule(dynamic)
+  for (b = 0; b < nblocks; b++)
+    {
+      size_t start = b * PRINT_BLOCK_SIZE;
+      size_t end =
+        (n - start > PRINT_BLOCK_SIZE ? start + PRINT_BLOCK_SIZE : n);
+      memory_ostream_t block_stream = memory_ostream_create ();
+      struct print_report_list reports = { NULL, 0, 0 };
+      size_t k;
+
+      deferred_reports = &reports;
+      for (k = start; k < end; k++)
+        {
+          /* Only the very first message has no blank line before it.  */
+          bool message_blank_line = (k > 0 || blank_line);
+
+          if (!order[k]->obsolete)
+            message_print (order[k], block_stream, charset, page_width,
+                           message_blank_line, debug);
+          else
+            message_print_obsolete (order[k], block_stream, charset,
+                                    page_width, message_blank_line);
+        }
+      deferred_reports = NULL;
+
+      #pragma omp ordered
+      {
+        const void *buf;
+        size_t buflen;
+
+        print_report_flush (&reports);
+        memory_ostream_contents (block_stream, &buf, &buflen);
+        ostream_write_mem (stream, buf, buflen);
+      }
+
+      ostream_free (block_stream);
+    }
+
+  free (order);
+}
+
+#endif
+
+
 static void
 msgdomain_list_print_po (msgdomain_list_ty *mdlp, ostream_t stream,
                          size_t page_width, bool debug)
@@ -1505,23 +1802,37 @@ msgdomain_list_print_po (msgdomain_list_ty *mdlp, ostream_t stream,
             }
         }
 
-      /* Write out each of the messages for this domain.  */
-      for (j = 0; j < mlp->nitems; ++j)
-        if (!mlp->item[j]->obsolete)
-          {
-            message_print (mlp->item[j], stream, charset, page_width,
-                           blank_line, debug);
-            blank_line = true;
-          }
+#ifdef _OPENMP
+      /* Styled output cannot be collected in memory buffers.  */
+      if (!is_stylable (stream)
+          && mlp->nitems > PRINT_BLOCK_SIZE
+          && omp_get_max_threads () > 1)
+        {
+          message_list_print_parallel (mlp, stream, charset, page_width,
+                                       blank_line, debug);
+          blank_line = true;
+        }
+      else
+#endif
+        {
+          /* Write out each of the messages for this domain.  */
+          for (j = 0; j < mlp->nitems; ++j)
+            if (!mlp->item[j]->obsolete)
+              {
+                message_print (mlp->item[j], stream, charset, page_width,
+                               blank_line, debug);
+                blank_line = true;
+              }
 
-      /* Write out each of the obsolete messages for this domain.  */
-      for (j = 0; j < mlp->nitems; ++j)
-        if (mlp->item[j]->obsolete)
-          {
-            message_print_obsolete (mlp->item[j], stream, charset, page_width,
-                                    blank_line);
-            blank_line = true;
-          }
+          /* Write out each of the obsolete messages for this domain.  */
+          for (j = 0; j < mlp->nitems; ++j)
+            if (mlp->item[j]->obsolete)
+              {
+                message_print_obsolete (mlp->item[j], stream, charset,
+                                        page_width, blank_line);
+                blank_line = true;
+              }
+        }
 
       if (allocated_charset != NULL)
         freea (allocated_charset);
@@ -135,7 +135,8 @@ static default_catalog_reader_class_ty extract_methods =
     default_comment,
     default_comment_dot,
     default_comment_filepos,
-    default_comment_special
+    default_comment_special,
+    default_comment_format
   },
   default_set_domain, /* set_domain */
   extract_add_message, /* add_message */
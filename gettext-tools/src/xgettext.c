@@ -63,6 +63,7 @@
 #include "write-po.h"
 #include "write-properties.h"
 #include "write-stringtable.h"
+#include "catalog-format.h"
 #include "color.h"
 #include "format.h"
 #include "propername.h"
@@ -227,6 +228,7 @@ static const struct option long_options[] =
   { "omit-header", no_argument, &xgettext_omit_header, 1 },
   { "output", required_argument, NULL, 'o' },
   { "output-dir", required_argument, NULL, 'p' },
+  { "output-format", required_argument, NULL, CHAR_MAX + 16 },
   { "package-name", required_argument, NULL, CHAR_MAX + 12 },
   { "package-version", required_argument, NULL, CHAR_MAX + 13 },
   { "properties-output", no_argument, NULL, CHAR_MAX + 6 },
@@ -581,6 +583,10 @@ main (int argc, char *argv[])
         handle_style_option (optarg);
         break;
 
+      case CHAR_MAX + 16:        /* --output-format */
+        output_syntax = catalog_output_format_by_name (optarg);
+        break;
+
       default:
         usage (EXIT_FAILURE);
         /* NOTREACHED */
@@ -965,6 +971,9 @@ Output details:\n"));
       printf (_("\
       --stringtable-output    write out a NeXTstep/GNUstep .strings file\n"));
       printf (_("\
+      --output-format=FORMAT  write out a file in the given syntax: 'po',\n\
+                              'properties', 'stringtable' or 'binary'\n"));
+      printf (_("\
   -w, --width=NUMBER          set output page width\n"));
       printf (_("\
       --no-wrap               do not break long message lines, longer than\n\
@@ -1014,7 +1023,7 @@ Informative output:\n"));
 static void
 exclude_directive_domain (abstract_catalog_reader_ty *pop, char *name)
 {
-  po_gram_error_at_line (&gram_pos,
+  po_gram_error_at_line (po_lex_current_pos (),
                          _("this file may not contain domain directives"));
 }
 
@@ -1072,6 +1081,7 @@ static abstract_catalog_reader_class_ty exclude_methods =
   NULL, /* comment_dot */
   NULL, /* comment_filepos */
   NULL, /* comment_special */
+  NULL /* comment_format */
 };
 
 
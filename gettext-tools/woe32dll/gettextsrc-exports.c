@@ -18,6 +18,7 @@
 #include "woe32dll/export.h"
 
 VARIABLE(allow_duplicates)
+VARIABLE(binary_catalog_selection)
 VARIABLE(color_mode)
 VARIABLE(color_test_mode)
 VARIABLE(format_language)
@@ -51,8 +52,9 @@ VARIABLE(formatstring_smalltalk)
 VARIABLE(formatstring_tcl)
 VARIABLE(formatstring_ycp)
 VARIABLE(gram_max_allowed_errors)
-VARIABLE(gram_pos)
+VARIABLE(input_format_binary)
 VARIABLE(input_format_po)
+VARIABLE(input_format_profile)
 VARIABLE(input_format_properties)
 VARIABLE(input_format_stringtable)
 VARIABLE(less_than)
@@ -60,6 +62,7 @@ VARIABLE(line_comment)
 VARIABLE(more_than)
 VARIABLE(msgcomm_mode)
 VARIABLE(omit_header)
+VARIABLE(output_format_binary)
 VARIABLE(output_format_po)
 VARIABLE(output_format_properties)
 VARIABLE(output_format_stringtable)
@@ -70,10 +73,6 @@ VARIABLE(po_charset_ascii)
 VARIABLE(po_charset_utf8)
 VARIABLE(po_error)
 VARIABLE(po_error_at_line)
-VARIABLE(po_gram_lval)
-VARIABLE(po_lex_charset)
-VARIABLE(po_lex_iconv)
-VARIABLE(po_lex_weird_cjk)
 VARIABLE(po_multiline_error)
 VARIABLE(po_multiline_warning)
 VARIABLE(po_xerror)
@@ -21,6 +21,7 @@
 #include "file-ostream.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "xalloc.h"
 
@@ -28,27 +29,63 @@ struct file_ostream : struct ostream
 {
 fields:
   FILE *fp;
+  /* The output is collected in a buffer, so that the many small writes of
+     the PO writer result in few calls to fwrite.  */
+  char *buffer;
+  size_t buflen;                /* Number of bytes stored in the buffer.  */
 };
 
+#define BUFSIZE 65536
+
 /* Implementation of ostream_t methods.  */
 
 static void
 file_ostream::write_mem (file_ostream_t stream, const void *data, size_t len)
 {
   if (len > 0)
-    fwrite (data, 1, len, stream->fp);
+    {
+      if (len <= BUFSIZE - stream->buflen)
+        {
+          /* Move the data into the buffer.  */
+          memcpy (stream->buffer + stream->buflen, data, len);
+          stream->buflen += len;
+        }
+      else
+        {
+          if (stream->buflen > 0)
+            {
+              fwrite (stream->buffer, 1, stream->buflen, stream->fp);
+              stream->buflen = 0;
+            }
+          if (len < BUFSIZE)
+            {
+              memcpy (stream->buffer, data, len);
+              stream->buflen = len;
+            }
+          else
+            /* Large chunks are output directly.  */
+            fwrite (data, 1, len, stream->fp);
+        }
+    }
 }
 
 static void
 file_ostream::flush (file_ostream_t stream)
 {
-  /* This ostream has no internal buffer.  No need to fflush (stream->fp),
-     since it's external to this ostream.  */
+  /* Empty the internal buffer.  No need to fflush (stream->fp), since it's
+     external to this ostream.  */
+  if (stream->buflen > 0)
+    {
+      fwrite (stream->buffer, 1, stream->buflen, stream->fp);
+      stream->buflen = 0;
+    }
 }
 
 static void
 file_ostream::free (file_ostream_t stream)
 {
+  file_ostream_flush (stream);
+  free (stream->buffer);
   free (stream);
 }
 
@@ -61,6 +98,8 @@ file_ostream_create (FILE *fp)
 
   stream->base.vtable = &file_ostream_vtable;
   stream->fp = fp;
+  stream->buffer = XNMALLOC (BUFSIZE, char);
+  stream->buflen = 0;
 
   return stream;
 }
@@ -35,6 +35,7 @@ extern "C" {
 
 
 /* Create an output stream referring to FP.
+   The output is buffered; it reaches FP when the stream is flushed or closed.
    Note that the resulting stream must be closed before FP can be closed.  */
 extern file_ostream_t file_ostream_create (FILE *fp);
 